@@ -4,10 +4,14 @@ set(BASE_HEADERS
         src/base/utils.hpp
         src/base/properties.hpp
         src/base/sdl_surface.hpp
+        src/base/tickarena.hpp
+        src/base/allocationcount.hpp
+        src/base/profiler.hpp
         )
 
 set(BASE_GEOMETRY_HEADERS
         src/base/geometry/aabb.hpp
+        src/base/geometry/aabbtree.hpp
         src/base/geometry/trianglemeshutils.hpp
         src/base/geometry/plane.hpp
         src/base/geometry/triangle.hpp
@@ -28,10 +32,14 @@ set(BASE_SOURCES
         src/base/utils.cpp
         src/base/properties.cpp
         src/base/log.cpp
+        src/base/tickarena.cpp
+        src/base/allocationcount.cpp
+        src/base/profiler.cpp
         src/base/geometry/triangle.cpp
         src/base/geometry/line.cpp
         src/base/geometry/trianglemeshutils.cpp
         src/base/geometry/aabb.cpp
+        src/base/geometry/aabbtree.cpp
         src/base/geometry/plane.cpp
         src/base/math/vector3.cpp
         src/base/math/matrix3.cpp
@@ -73,7 +81,9 @@ set(SYSTEMS_GRAPHICS_RESOURCES_HEADERS
 set(SYSTEMS_GRAPHICS_RENDERING_HEADERS
         src/systems/graphics/rendering/interface_renderer3d.hpp
         src/systems/graphics/rendering/opengl_renderer3d.hpp
+        src/systems/graphics/rendering/null_renderer3d.hpp
         src/systems/graphics/rendering/r3d_messages.hpp
+        src/systems/graphics/rendering/r3d_renderqueue.hpp
         )
 
 set(SYSTEMS_GRAPHICS_SOURCES
@@ -87,7 +97,9 @@ set(SYSTEMS_GRAPHICS_SOURCES
         src/systems/graphics/resources/vertexbuffer.cpp
         src/systems/graphics/resources/texture.cpp
         src/systems/graphics/rendering/r3d_messages.cpp
+        src/systems/graphics/rendering/r3d_renderqueue.cpp
         src/systems/graphics/rendering/opengl_renderer3d.cpp
+        src/systems/graphics/rendering/null_renderer3d.cpp
         src/systems/graphics/graphics_system.cpp
         )
 
@@ -174,6 +186,7 @@ set(TYPES_HEADERS
         src/types/loader.hpp
         src/types/thread.hpp
         src/types/messagequeue.hpp
+        src/types/workstealingdeque.hpp
         )
 
 set(TYPES_SOURCES
@@ -271,6 +284,7 @@ set(MANAGERS_SOURCES
 
 set(UTILS_HEADERS
         src/utils/animation.hpp
+        src/utils/animationcache.hpp
         src/utils/objectloader.hpp
         src/utils/database.hpp
         src/utils/xmlloader.hpp
@@ -376,6 +390,8 @@ set(CORE_HEADERS
    src/utils.hpp
    src/main.hpp
    src/gametask.hpp
+   src/headlessrunner.hpp
+   src/matchbatchrunner.hpp
    src/dbquery.hpp
    src/misc/hungarian.h
 )
@@ -384,6 +400,8 @@ set(CORE_SOURCES
    src/misc/perlin.cpp
    src/misc/hungarian.c
    src/gametask.cpp
+   src/headlessrunner.cpp
+   src/matchbatchrunner.cpp
    src/utils.cpp
    src/main.cpp
    src/dbquery.cpp
@@ -415,10 +433,13 @@ set(GAME_HEADERS
    src/onthepitch/ball.hpp
    src/onthepitch/team.hpp
    src/onthepitch/match.hpp
+   src/onthepitch/matchinputlog.hpp
+   src/onthepitch/replaybuffer.hpp
    src/onthepitch/AIsupport/AIfunctions.hpp
    src/onthepitch/AIsupport/mentalimage.hpp
    src/onthepitch/teamAIcontroller.hpp
    src/onthepitch/proceduralpitch.hpp
+   src/onthepitch/playergrid.hpp
 )
 
 set(GAME_SOURCES
@@ -444,22 +465,27 @@ set(GAME_SOURCES
    src/onthepitch/humangamer.cpp
    src/onthepitch/ball.cpp
    src/onthepitch/match.cpp
+   src/onthepitch/matchinputlog.cpp
+   src/onthepitch/replaybuffer.cpp
    src/onthepitch/referee.cpp
    src/onthepitch/AIsupport/mentalimage.cpp
    src/onthepitch/AIsupport/AIfunctions.cpp
    src/onthepitch/proceduralpitch.cpp
+   src/onthepitch/playergrid.cpp
    src/onthepitch/team.cpp
    src/onthepitch/teamAIcontroller.cpp
 )
 
 set(HID_HEADERS
    src/hid/gamepad.hpp
+   src/hid/hidreplay.hpp
    src/hid/ihidevice.hpp
    src/hid/keyboard.hpp
 )
 
 set(HID_SOURCES
    src/hid/gamepad.cpp
+   src/hid/hidreplay.cpp
    src/hid/keyboard.cpp
 )
 
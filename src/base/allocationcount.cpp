@@ -0,0 +1,57 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#include "allocationcount.hpp"
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+  std::atomic<unsigned long> heapAllocationCount(0);
+
+  inline void *CountedAllocate(std::size_t size) {
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    void *p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+  }
+}
+
+void *operator new(std::size_t size) { return CountedAllocate(size); }
+void *operator new[](std::size_t size) { return CountedAllocate(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+namespace blunted {
+
+  unsigned long GetHeapAllocationCount() {
+    return heapAllocationCount.load(std::memory_order_relaxed);
+  }
+
+  bool IsCountingAllocations() {
+    return true;
+  }
+
+}
+
+#else
+
+namespace blunted {
+
+  unsigned long GetHeapAllocationCount() {
+    return 0;
+  }
+
+  bool IsCountingAllocations() {
+    return false;
+  }
+
+}
+
+#endif
@@ -0,0 +1,16 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_BASE_ALLOCATIONCOUNT
+#define _HPP_BASE_ALLOCATIONCOUNT
+
+namespace blunted {
+
+  /// number of heap allocations (operator new, all threads) so far. only counted when built with COUNT_ALLOCATIONS (cmake -DCOUNT_ALLOCATIONS=ON)
+  unsigned long GetHeapAllocationCount();
+  bool IsCountingAllocations();
+
+}
+
+#endif
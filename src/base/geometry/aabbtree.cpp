@@ -0,0 +1,256 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#include "aabbtree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+namespace blunted {
+
+  // group layout: normal x[4], y[4], z[4], determinant[4], then the absolute normal x[4], y[4], z[4]
+
+  PackedPlanes::PackedPlanes(const vector_Planes &planes) {
+    int groupCount = (planes.size() + 3) / 4;
+    groups.assign(groupCount * groupSize, 0.0f);
+    for (int g = 0; g < groupCount; g++) {
+      float *group = &groups[g * groupSize];
+      for (int i = 0; i < 4; i++) {
+        unsigned int p = g * 4 + i;
+        if (p < planes.size()) {
+          const Vector3 &normal = planes[p].GetVertex(1);
+          for (int c = 0; c < 3; c++) {
+            group[c * 4 + i] = normal.coords[c];
+            group[16 + c * 4 + i] = std::fabs(normal.coords[c]);
+          }
+          group[12 + i] = planes[p].GetDeterminant();
+        } else {
+          group[12 + i] = 1.0f; // everything's in front of this one
+        }
+      }
+    }
+  }
+
+  PackedPlanes::e_Classification PackedPlanes::Classify(const float *minxyz, const float *maxxyz) const {
+    // distance of the center to the plane, and how far the box reaches along its normal. the box is behind the plane when
+    // even its furthest corner is (distance + reach <= 0), and in front of it when its nearest one is (distance - reach > 0)
+    bool inside = true;
+    int groupCount = groups.size() / groupSize;
+
+#ifdef __SSE__
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 center = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(maxxyz), _mm_loadu_ps(minxyz)), half);
+    __m128 extent = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxxyz), _mm_loadu_ps(minxyz)), half);
+    __m128 centerX = _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 centerY = _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 centerZ = _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 extentX = _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 extentY = _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 extentZ = _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 zero = _mm_setzero_ps();
+
+    for (int g = 0; g < groupCount; g++) {
+      const float *group = &groups[g * groupSize];
+      __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(group), centerX), _mm_mul_ps(_mm_loadu_ps(group + 4), centerY)),
+                                   _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(group + 8), centerZ), _mm_loadu_ps(group + 12)));
+      __m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(group + 16), extentX), _mm_mul_ps(_mm_loadu_ps(group + 20), extentY)),
+                                _mm_mul_ps(_mm_loadu_ps(group + 24), extentZ));
+      if (_mm_movemask_ps(_mm_cmple_ps(_mm_add_ps(distance, reach), zero))) return e_Classification_Outside;
+      if (_mm_movemask_ps(_mm_cmple_ps(_mm_sub_ps(distance, reach), zero))) inside = false;
+    }
+#else
+    float center[3], extent[3];
+    for (int c = 0; c < 3; c++) {
+      center[c] = (maxxyz[c] + minxyz[c]) * 0.5f;
+      extent[c] = (maxxyz[c] - minxyz[c]) * 0.5f;
+    }
+    for (int g = 0; g < groupCount; g++) {
+      const float *group = &groups[g * groupSize];
+      for (int i = 0; i < 4; i++) {
+        float distance = group[i] * center[0] + group[4 + i] * center[1] + group[8 + i] * center[2] + group[12 + i];
+        float reach = group[16 + i] * extent[0] + group[20 + i] * extent[1] + group[24 + i] * extent[2];
+        if (distance + reach <= 0.0f) return e_Classification_Outside;
+        if (distance - reach <= 0.0f) inside = false;
+      }
+    }
+#endif
+
+    return inside ? e_Classification_Inside : e_Classification_Intersects;
+  }
+
+
+  AABBTree::AABBTree() : refitNeeded(false), cost(0.0f), buildCost(0.0f) {
+  }
+
+  void AABBTree::Build(const std::vector<AABB> &boxes) {
+    nodes.clear();
+    itemNodes.assign(boxes.size(), -1);
+    orderedItems.resize(boxes.size());
+    refitNeeded = false;
+    cost = 0.0f;
+    buildCost = 0.0f;
+    if (boxes.empty()) return;
+
+    for (unsigned int i = 0; i < orderedItems.size(); i++) orderedItems[i] = i;
+
+    nodes.reserve(boxes.size() * 2 - 1);
+    nodes.resize(1);
+    BuildNode(0, 0, orderedItems.size(), boxes);
+
+    for (unsigned int i = 0; i < nodes.size(); i++) {
+      if (nodes[i].firstChild != -1) cost += GetSurfaceArea(nodes[i]);
+    }
+    buildCost = cost;
+  }
+
+  void AABBTree::Rebuild() {
+    std::vector<AABB> boxes(itemNodes.size());
+    for (unsigned int i = 0; i < itemNodes.size(); i++) {
+      const TreeNode &node = nodes[itemNodes[i]];
+      boxes[i].minxyz.Set(node.minxyz[0], node.minxyz[1], node.minxyz[2]);
+      boxes[i].maxxyz.Set(node.maxxyz[0], node.maxxyz[1], node.maxxyz[2]);
+    }
+    Build(boxes);
+  }
+
+  void AABBTree::Clear() {
+    nodes.clear();
+    itemNodes.clear();
+    orderedItems.clear();
+    refitNeeded = false;
+    cost = 0.0f;
+    buildCost = 0.0f;
+  }
+
+  void AABBTree::SetItem(int item, const AABB &box) {
+    TreeNode &node = nodes[itemNodes[item]];
+    for (int c = 0; c < 3; c++) {
+      node.minxyz[c] = box.minxyz.coords[c];
+      node.maxxyz[c] = box.maxxyz.coords[c];
+    }
+    refitNeeded = true;
+  }
+
+  void AABBTree::Refit() {
+    if (!refitNeeded) return;
+
+    // all of the inner nodes, children first. cheaper than walking up from every moved item once a few dozen have moved,
+    // which in a match they all do, every frame
+    cost = 0.0f;
+    for (int i = nodes.size() - 1; i >= 0; i--) {
+      if (nodes[i].firstChild != -1) {
+        MergeChildren(nodes[i]);
+        cost += GetSurfaceArea(nodes[i]);
+      }
+    }
+    refitNeeded = false;
+  }
+
+  void AABBTree::Query(const PackedPlanes &planes, std::vector<int> &items) const {
+    if (nodes.empty()) return;
+
+    // median splits keep the depth at log2(items), so this won't run out
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+      const TreeNode &node = nodes[stack[--stackSize]];
+
+      PackedPlanes::e_Classification classification = planes.Classify(node.minxyz, node.maxxyz);
+      if (classification == PackedPlanes::e_Classification_Outside) continue;
+
+      // everything below a box that's entirely inside is too, so that part of the tree needs no more testing
+      if (classification == PackedPlanes::e_Classification_Inside || node.firstChild == -1) {
+        items.insert(items.end(), orderedItems.begin() + node.firstItem, orderedItems.begin() + node.firstItem + node.itemCount);
+      } else {
+        stack[stackSize++] = node.firstChild + 1;
+        stack[stackSize++] = node.firstChild;
+      }
+    }
+  }
+
+  void AABBTree::BuildNode(int nodeIndex, int first, int last, const std::vector<AABB> &boxes) {
+    nodes[nodeIndex].firstItem = first;
+    nodes[nodeIndex].itemCount = last - first;
+
+    if (last - first == 1) {
+      TreeNode &node = nodes[nodeIndex];
+      const AABB &box = boxes[orderedItems[first]];
+      for (int c = 0; c < 3; c++) {
+        node.minxyz[c] = box.minxyz.coords[c];
+        node.maxxyz[c] = box.maxxyz.coords[c];
+      }
+      node.minxyz[3] = 0.0f;
+      node.maxxyz[3] = 0.0f;
+      node.firstChild = -1;
+      itemNodes[orderedItems[first]] = nodeIndex;
+      return;
+    }
+
+    // split at the median center along the axis the centers spread out over most
+    float centerMin[3], centerMax[3];
+    for (int c = 0; c < 3; c++) {
+      centerMin[c] = std::numeric_limits<float>::max();
+      centerMax[c] = -std::numeric_limits<float>::max();
+    }
+    for (int i = first; i < last; i++) {
+      const AABB &box = boxes[orderedItems[i]];
+      for (int c = 0; c < 3; c++) {
+        float center = box.minxyz.coords[c] + box.maxxyz.coords[c];
+        centerMin[c] = std::min(centerMin[c], center);
+        centerMax[c] = std::max(centerMax[c], center);
+      }
+    }
+    int axis = 0;
+    for (int c = 1; c < 3; c++) {
+      if (centerMax[c] - centerMin[c] > centerMax[axis] - centerMin[axis]) axis = c;
+    }
+
+    struct CenterLess {
+      CenterLess(const std::vector<AABB> &boxes, int axis) : boxes(boxes), axis(axis) {}
+      bool operator()(int a, int b) const {
+        return boxes[a].minxyz.coords[axis] + boxes[a].maxxyz.coords[axis] < boxes[b].minxyz.coords[axis] + boxes[b].maxxyz.coords[axis];
+      }
+      const std::vector<AABB> &boxes;
+      int axis;
+    };
+    int middle = (first + last) / 2;
+    std::nth_element(orderedItems.begin() + first, orderedItems.begin() + middle, orderedItems.begin() + last, CenterLess(boxes, axis));
+
+    int firstChild = nodes.size();
+    nodes.resize(firstChild + 2);
+    nodes[nodeIndex].firstChild = firstChild;
+    BuildNode(firstChild, first, middle, boxes);
+    BuildNode(firstChild + 1, middle, last, boxes);
+    MergeChildren(nodes[nodeIndex]);
+  }
+
+  void AABBTree::MergeChildren(TreeNode &node) const {
+    const TreeNode &child1 = nodes[node.firstChild];
+    const TreeNode &child2 = nodes[node.firstChild + 1];
+#ifdef __SSE__
+    _mm_storeu_ps(node.minxyz, _mm_min_ps(_mm_loadu_ps(child1.minxyz), _mm_loadu_ps(child2.minxyz)));
+    _mm_storeu_ps(node.maxxyz, _mm_max_ps(_mm_loadu_ps(child1.maxxyz), _mm_loadu_ps(child2.maxxyz)));
+#else
+    for (int c = 0; c < 4; c++) {
+      node.minxyz[c] = std::min(child1.minxyz[c], child2.minxyz[c]);
+      node.maxxyz[c] = std::max(child1.maxxyz[c], child2.maxxyz[c]);
+    }
+#endif
+  }
+
+  float AABBTree::GetSurfaceArea(const TreeNode &node) const {
+    float x = node.maxxyz[0] - node.minxyz[0];
+    float y = node.maxxyz[1] - node.minxyz[1];
+    float z = node.maxxyz[2] - node.minxyz[2];
+    return 2.0f * (x * y + y * z + z * x);
+  }
+
+}
@@ -0,0 +1,88 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_AABBTREE
+#define _HPP_AABBTREE
+
+#include "defines.hpp"
+
+#include "aabb.hpp"
+#include "plane.hpp"
+
+namespace blunted {
+
+  // planes packed four at a time (normal x, y, z, determinant, and the absolute normal), so a box can be tested against four
+  // of them in one go. padded with planes everything is in front of
+  class PackedPlanes {
+
+    public:
+      PackedPlanes(const vector_Planes &planes);
+
+      enum e_Classification {
+        e_Classification_Outside,
+        e_Classification_Intersects,
+        e_Classification_Inside
+      };
+
+      /// minxyz and maxxyz take 4 floats each (the last is ignored). outside when the box is behind any of the planes, which
+      /// is what AABB::Intersects(planes) tests for, up to rounding
+      e_Classification Classify(const float *minxyz, const float *maxxyz) const;
+
+    protected:
+      static const int groupSize = 28;
+      std::vector<float> groups;
+
+  };
+
+  // a flat binary bounding volume hierarchy over a fixed set of items. built top down with median splits, after which moving
+  // items only refits the boxes above them; rebuild when the set of items changes, or once refitting made it sloppy
+  class AABBTree {
+
+    public:
+      AABBTree();
+
+      /// item i gets boxes[i]; boxes need to be bounded (min <= max)
+      void Build(const std::vector<AABB> &boxes);
+      /// builds again over the current item boxes
+      void Rebuild();
+      void Clear();
+
+      void SetItem(int item, const AABB &box);
+      /// updates the boxes above the items that changed since the last refit
+      void Refit();
+
+      /// adds the items whose boxes aren't behind any of the planes, in no particular order
+      void Query(const PackedPlanes &planes, std::vector<int> &items) const;
+
+      int GetItemCount() const { return itemNodes.size(); }
+
+      /// summed surface area of the inner boxes, against what it was right after building. refitting tends to make it go up
+      float GetCost() const { return cost; }
+      float GetBuildCost() const { return buildCost; }
+
+    protected:
+      struct TreeNode {
+        float minxyz[4];
+        float maxxyz[4]; // the 4th component of both is padding, for sse loads
+        int firstChild; // the second child follows it. -1 for leaves
+        int firstItem; // into orderedItems; a node's items are all next to each other in there
+        int itemCount;
+      };
+
+      void BuildNode(int nodeIndex, int first, int last, const std::vector<AABB> &boxes);
+      void MergeChildren(TreeNode &node) const;
+      float GetSurfaceArea(const TreeNode &node) const;
+
+      std::vector<TreeNode> nodes; // children always come after their parent
+      std::vector<int> itemNodes;
+      std::vector<int> orderedItems;
+      bool refitNeeded;
+      float cost;
+      float buildCost;
+
+  };
+
+}
+
+#endif
@@ -24,6 +24,8 @@ namespace blunted {
   Distribution dist;
   Generator rng(base, dist);
 
+  thread_local RandomStream *boundRandomStream = 0;
+
   real clamp(const real value, const real min, const real max) {
     assert(max >= min);
     if (min > value) return min;
@@ -70,11 +72,20 @@ namespace blunted {
     rng.engine().seed(static_cast<unsigned int>(std::time(0)));
   }
 
+  void randomseed(unsigned int seed) {
+    randMutex.lock();
+    rng.engine().seed(seed);
+    rng.distribution().reset();
+    randMutex.unlock();
+  }
+
   inline real boostrandom() {
     return rng();
   }
 
   real random(real min, real max) {
+    if (boundRandomStream) return boundRandomStream->Get(min, max);
+
     float stretch = max - min;
 
     randMutex.lock();
@@ -83,6 +94,15 @@ namespace blunted {
     return value;
   }
 
+  real RandomStream::Get(real min, real max) {
+    std::uniform_real_distribution<float> streamDist(min, max);
+    return streamDist(engine);
+  }
+
+  void BindRandomStream(RandomStream *stream) {
+    boundRandomStream = stream;
+  }
+
   int pot(int x) {
     int val = 1;
     while (val < x) {
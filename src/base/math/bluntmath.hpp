@@ -9,6 +9,8 @@
 
 #include <limits>
 
+#include <random>
+
 // todo: function names should probably start with caps
 
 namespace blunted {
@@ -29,13 +31,34 @@ namespace blunted {
   signed int signSide(real n); // returns -1 or 1
   bool is_odd(int n);
   void randomseed();
+  void randomseed(unsigned int seed);
   real random(real min, real max);
 
+  // a private random() sequence, for code that runs on worker threads but should still be reproducible:
+  // while a stream is bound to a thread, random() calls from that thread draw from the stream instead of the shared generator
+  class RandomStream {
+
+    public:
+      void Seed(unsigned int seed) { engine.seed(seed); }
+      real Get(real min, real max);
+
+    protected:
+      std::mt19937 engine;
+
+  };
+
+  void BindRandomStream(RandomStream *stream); // 0 == back to the shared generator
+
   inline void fastrandomseed() {
     fastrandseed = static_cast<unsigned int>(std::time(0));
     max_uint = std::numeric_limits<unsigned int>::max();
   }
 
+  inline void fastrandomseed(unsigned int seed) {
+    fastrandseed = seed;
+    max_uint = std::numeric_limits<unsigned int>::max();
+  }
+
   inline real fastrandom(real min, real max) {
     real range = max - min;
     real tmp = (fastrandseed / (max_uint * 1.0f)) * range + min;
@@ -5,6 +5,11 @@
 #include "quaternion.hpp"
 
 #include <cmath>
+#include <type_traits>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
 
 #include "bluntmath.hpp"
 #include "vector3.hpp"
@@ -18,6 +23,28 @@
 
 namespace blunted {
 
+  static_assert(std::is_trivially_copyable<Quaternion>::value, "Quaternion should stay plain old data");
+  static_assert(sizeof(Quaternion) == 4 * sizeof(float), "Quaternion should fit one sse register");
+
+#ifdef __SSE__
+  // unaligned loads/stores: nobody guarantees 16 byte alignment of the containers quaternions live in (and on current cpus, it doesn't matter much)
+  inline __m128 LoadQuaternion(const Quaternion &quat) {
+    return _mm_loadu_ps(quat.elements);
+  }
+
+  inline Quaternion StoreQuaternion(__m128 value) {
+    Quaternion quat;
+    _mm_storeu_ps(quat.elements, value);
+    return quat;
+  }
+
+  inline float SumQuaternionElements(__m128 value) {
+    __m128 swapped = _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 pairSums = _mm_add_ps(value, swapped); // x + y, x + y, z + w, z + w
+    return _mm_cvtss_f32(_mm_add_ss(pairSums, _mm_movehl_ps(swapped, pairSums)));
+  }
+#endif
+
   Quaternion::Quaternion() {
     elements[0] = 0;
     elements[1] = 0;
@@ -39,9 +66,6 @@ namespace blunted {
     elements[3] = values[3];
   }
 
-  Quaternion::~Quaternion() {
-  }
-
   void Quaternion::Set(real x, real y, real z, real w) {
     elements[0] = x;
     elements[1] = y;
@@ -97,7 +121,11 @@ namespace blunted {
   }
 
   const Quaternion Quaternion::operator * (float scale) const {
+#ifdef __SSE__
+    return StoreQuaternion(_mm_mul_ps(LoadQuaternion(*this), _mm_set1_ps(scale)));
+#else
     return Quaternion(elements[0] * scale, elements[1] * scale, elements[2] * scale, elements[3] * scale);
+#endif
   }
 
   Vector3 Quaternion::operator * (const Vector3 &fac) const {
@@ -142,11 +170,19 @@ namespace blunted {
   }
 
   Quaternion Quaternion::operator + (const Quaternion &q2) const {
+#ifdef __SSE__
+    return StoreQuaternion(_mm_add_ps(LoadQuaternion(*this), LoadQuaternion(q2)));
+#else
     return Quaternion(elements[0] + q2.elements[0], elements[1] + q2.elements[1], elements[2] + q2.elements[2], elements[3] + q2.elements[3]);
+#endif
   }
 
   Quaternion Quaternion::operator - (const Quaternion &q2) const {
+#ifdef __SSE__
+    return StoreQuaternion(_mm_sub_ps(LoadQuaternion(*this), LoadQuaternion(q2)));
+#else
     return Quaternion(elements[0] - q2.elements[0], elements[1] - q2.elements[1], elements[2] - q2.elements[2], elements[3] - q2.elements[3]);
+#endif
   }
 
   Quaternion Quaternion::operator - () const {
@@ -306,9 +342,13 @@ namespace blunted {
   }
 
   void Quaternion::scale(const real fac) {
+#ifdef __SSE__
+    _mm_storeu_ps(elements, _mm_mul_ps(LoadQuaternion(*this), _mm_set1_ps(fac)));
+#else
     for (int i = 0; i < 4; i++) {
       elements[i] *= fac;
     }
+#endif
   }
 
   real Quaternion::GetMagnitude() const {
@@ -322,7 +362,7 @@ namespace blunted {
 
   void Quaternion::Normalize() {
     // http://stackoverflow.com/questions/11667783/quaternion-and-normalization
-    double qmagsq = elements[0] * elements[0] + elements[1] * elements[1] + elements[2] * elements[2] + elements[3] * elements[3]; // squared magnitude
+    double qmagsq = GetDotProduct(*this); // squared magnitude
     if (qmagsq < 0.000001f) {
       Set(QUATERNION_IDENTITY[0], QUATERNION_IDENTITY[1], QUATERNION_IDENTITY[2], QUATERNION_IDENTITY[3]);
     } else {
@@ -342,11 +382,21 @@ namespace blunted {
   }
 
   float Quaternion::GetDotProduct(const Quaternion &subject) const {
+#ifdef __SSE__
+    return SumQuaternionElements(_mm_mul_ps(LoadQuaternion(*this), LoadQuaternion(subject)));
+#else
     return (elements[0] * subject.elements[0] + elements[1] * subject.elements[1] + elements[2] * subject.elements[2] + elements[3] * subject.elements[3]);
+#endif
   }
 
   Quaternion Quaternion::GetLerped(float bias, const Quaternion &to) const {
+#ifdef __SSE__
+    // the hot one: every joint of every animated player, every frame
+    __m128 lerped = _mm_add_ps(_mm_mul_ps(LoadQuaternion(*this), _mm_set1_ps(1 - bias)), _mm_mul_ps(LoadQuaternion(to), _mm_set1_ps(bias)));
+    return StoreQuaternion(lerped).GetNormalized();
+#else
     return (*this * (1 - bias) + to * bias).GetNormalized();
+#endif
   }
 
   Quaternion Quaternion::GetSlerped(float bias, const Quaternion &to) const {
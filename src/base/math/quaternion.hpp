@@ -31,13 +31,13 @@ namespace blunted {
 
   static real QUATERNION_IDENTITY[4] = { 0, 0, 0, 1 };
 
+  // plain old data, like Vector3: 4 reals, no vtable. the component-wise math is done in one sse register where available
   class Quaternion {
 
     public:
       Quaternion();
       Quaternion(real x, real y, real z, real w);
       Quaternion(real values[4]);
-      virtual ~Quaternion();
 
       void Set(real x, real y, real z, real w);
       void Set(const Quaternion &quat);
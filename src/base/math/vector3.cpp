@@ -20,28 +20,14 @@
 #include "quaternion.hpp"
 
 #include <cmath>
+#include <type_traits>
 
 #include "base/log.hpp"
 
 namespace blunted {
 
-  Vector3::Vector3() {
-    coords[0] = 0;
-    coords[1] = 0;
-    coords[2] = 0;
-  }
-
-  Vector3::Vector3(real xyz) {
-    coords[0] = xyz;
-    coords[1] = xyz;
-    coords[2] = xyz;
-  }
-
-  Vector3::Vector3(real x, real y, real z) {
-    coords[0] = x;
-    coords[1] = y;
-    coords[2] = z;
-  }
+  static_assert(std::is_trivially_copyable<Vector3>::value, "Vector3 should stay plain old data");
+  static_assert(sizeof(Vector3) == 3 * sizeof(real), "Vector3 should be packed");
 
   void Vector3::Set(real xyz) {
     coords[0] = xyz;
@@ -31,14 +31,13 @@ namespace blunted {
 
   typedef Vector3 Vector;
 
+  // plain old data: no vtable, trivially copyable and exactly 3 reals, so arrays of these can be memcpy'd and handed out as float arrays
   class Vector3 {
 
     public:
-      Vector3();
-      Vector3(const Vector3 &src) { coords[0] = src.coords[0]; coords[1] = src.coords[1]; coords[2] = src.coords[2]; } // gcc bug? this sometimes only sets the last element: memcpy(coords, src.coords, 3 * sizeof(real)); }
-      Vector3(real xyz);
-      Vector3(real x, real y, real z);
-      inline virtual ~Vector3() {};
+      Vector3() { coords[0] = 0; coords[1] = 0; coords[2] = 0; }
+      Vector3(real xyz) { coords[0] = xyz; coords[1] = xyz; coords[2] = xyz; }
+      Vector3(real x, real y, real z) { coords[0] = x; coords[1] = y; coords[2] = z; }
 
       void Set(real xyz);
       void Set(real x, real y, real z);
@@ -51,7 +50,6 @@ namespace blunted {
       bool operator != (const Vector3 &vector) const;
       void operator = (const Quaternion &quat);
       void operator = (const real src);
-      void operator = (const Vector3 &src);
       Vector3 operator * (const real scalar) const;
       Vector3 operator * (const Vector3 &scalar) const;
       Vector3 &operator *= (const real scalar);
@@ -144,13 +142,6 @@ namespace blunted {
     Set(src);
   }
 
-  inline
-  void Vector3::operator = (const Vector3 &src) {
-    coords[0] = src.coords[0];
-    coords[1] = src.coords[1];
-    coords[2] = src.coords[2];
-  }
-
   inline
   Vector3 Vector3::operator * (const real scalar) const {
     return Vector3(coords[0] * scalar, coords[1] * scalar, coords[2] * scalar);
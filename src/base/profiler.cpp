@@ -0,0 +1,172 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#include "profiler.hpp"
+
+#include <set>
+#include <unordered_map>
+
+#include "base/log.hpp"
+#include "base/utils.hpp"
+
+namespace blunted {
+
+  thread_local ProfileThreadBuffer *profileThreadBuffer = 0;
+
+  namespace {
+
+    // buffers live until the end of the program, so zones of threads that have finished can still be dumped
+    boost::mutex registryMutex;
+    std::vector<ProfileThreadBuffer*> threadBuffers;
+    std::set<std::string> internedNames;
+
+    std::string EscapeJSON(const std::string &source) {
+      std::string result;
+      for (unsigned int i = 0; i < source.size(); i++) {
+        char c = source[i];
+        if (c == '"' || c == '\\') {
+          result += '\\';
+          result += c;
+        } else if ((unsigned char)c < 0x20) {
+          result += ' ';
+        } else {
+          result += c;
+        }
+      }
+      return result;
+    }
+
+  }
+
+
+  // ProfileThreadBuffer
+
+  ProfileThreadBuffer::ProfileThreadBuffer(int threadID) : written(0), threadID(threadID) {
+    events = new ProfileEvent[capacity];
+  }
+
+  ProfileThreadBuffer::~ProfileThreadBuffer() {
+    delete [] events;
+  }
+
+  void ProfileThreadBuffer::GetEvents(std::vector<ProfileEvent> &result) const {
+    unsigned long end = written.load(std::memory_order_acquire);
+    unsigned long begin = end > capacity ? end - capacity : 0;
+    size_t resultStart = result.size();
+    for (unsigned long i = begin; i < end; i++) result.push_back(events[i & (capacity - 1)]);
+
+    // the writer may have gone round and overwritten the first ones in the meantime (+ 1: the one it may be writing right now)
+    std::atomic_thread_fence(std::memory_order_acquire);
+    unsigned long newEnd = written.load(std::memory_order_relaxed) + 1;
+    unsigned long overwritten = newEnd > begin + capacity ? newEnd - (begin + capacity) : 0;
+    overwritten = std::min(overwritten, end - begin);
+    result.erase(result.begin() + resultStart, result.begin() + resultStart + overwritten);
+  }
+
+  std::string ProfileThreadBuffer::GetThreadName() const {
+    boost::mutex::scoped_lock lock(nameMutex);
+    return threadName;
+  }
+
+  void ProfileThreadBuffer::SetThreadName(const std::string &name) {
+    boost::mutex::scoped_lock lock(nameMutex);
+    threadName = name;
+  }
+
+
+  // Profiler
+
+  ProfileThreadBuffer *Profiler::CreateThreadBuffer() {
+    boost::mutex::scoped_lock lock(registryMutex);
+    profileThreadBuffer = new ProfileThreadBuffer(threadBuffers.size());
+    threadBuffers.push_back(profileThreadBuffer);
+    return profileThreadBuffer;
+  }
+
+  void Profiler::SetThreadName(const std::string &name) {
+    GetThreadBuffer()->SetThreadName(name);
+  }
+
+  const char *Profiler::Intern(const std::string &name) {
+    thread_local std::unordered_map<std::string, const char*> internedHere;
+    auto iter = internedHere.find(name);
+    if (iter != internedHere.end()) return iter->second;
+
+    boost::mutex::scoped_lock lock(registryMutex);
+    const char *interned = internedNames.insert(name).first->c_str();
+    lock.unlock();
+    internedHere[name] = interned;
+    return interned;
+  }
+
+  bool Profiler::WriteChromeTrace(const std::string &filename) {
+
+    std::vector<ProfileThreadBuffer*> buffers;
+    registryMutex.lock();
+    buffers = threadBuffers;
+    registryMutex.unlock();
+
+    FILE *file = fopen(filename.c_str(), "w");
+    if (!file) {
+      Log(e_Error, "Profiler", "WriteChromeTrace", "Could not open " + filename);
+      return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    unsigned long eventCount = 0;
+    bool first = true;
+    std::vector<ProfileEvent> events;
+    for (unsigned int b = 0; b < buffers.size(); b++) {
+      ProfileThreadBuffer *buffer = buffers.at(b);
+
+      std::string threadName = buffer->GetThreadName();
+      if (threadName.empty()) threadName = "thread " + int_to_str(buffer->GetThreadID());
+      fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%i,\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", buffer->GetThreadID(), EscapeJSON(threadName).c_str());
+      first = false;
+
+      events.clear();
+      buffer->GetEvents(events);
+      for (unsigned int i = 0; i < events.size(); i++) {
+        const ProfileEvent &event = events.at(i);
+        fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%i,\"ts\":%llu,\"dur\":%llu}", EscapeJSON(event.name).c_str(), buffer->GetThreadID(), event.start_us, event.duration_us);
+      }
+      eventCount += events.size();
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    Log(e_Notice, "Profiler", "WriteChromeTrace", "Wrote " + int_to_str(eventCount) + " zones of " + int_to_str(buffers.size()) + " threads to " + filename);
+    return true;
+  }
+
+  StageTimer::StageTimer(const std::string &className, const std::string &methodName) : className(className), methodName(methodName), stageStart_us(0) {
+    start_us = Profiler::GetTime_us();
+  }
+
+  void StageTimer::Stage(const std::string &stageName) {
+    EndStage();
+    currentStage = stageName;
+    stageStart_us = Profiler::GetTime_us();
+  }
+
+  void StageTimer::EndStage() {
+    if (currentStage.empty()) return;
+    stages.push_back(std::pair<std::string, unsigned long long>(currentStage, Profiler::GetTime_us() - stageStart_us));
+    currentStage.clear();
+  }
+
+  void StageTimer::Report() {
+    EndStage();
+    char buf[256];
+    for (unsigned int i = 0; i < stages.size(); i++) {
+      snprintf(buf, 256, "%-40s %9.1f ms", stages.at(i).first.c_str(), stages.at(i).second / 1000.0);
+      Log(e_Notice, className, methodName, buf);
+    }
+    snprintf(buf, 256, "%-40s %9.1f ms", "total", (Profiler::GetTime_us() - start_us) / 1000.0);
+    Log(e_Notice, className, methodName, buf);
+  }
+
+}
@@ -0,0 +1,144 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_BASE_PROFILER
+#define _HPP_BASE_PROFILER
+
+#include "defines.hpp"
+
+#include <atomic>
+#include <chrono>
+
+// scoped timing zones, only compiled in with ENABLE_PROFILER (cmake -DENABLE_PROFILER=ON).
+// every thread records its zones into its own ring buffer (no locks); PROFILE_DUMP writes all of them as a chrome
+// trace_event json file (open in chrome://tracing or ui.perfetto.dev). nested zones show up as a hierarchy there.
+// zone names must outlive the profiler: string literals, or PROFILE_ZONE_DYNAMIC, which interns them. names that belong to
+// something that lives a while (a command's) are better interned once, with PROFILE_NAME, and then passed to PROFILE_ZONE.
+
+#ifdef ENABLE_PROFILER
+  #define PROFILE_CONCAT_(a, b) a##b
+  #define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+  #define PROFILE_ZONE(name) blunted::ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+  #define PROFILE_ZONE_DYNAMIC(name) blunted::ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(blunted::Profiler::Intern(name))
+  #define PROFILE_NAME(name) blunted::Profiler::Intern(name)
+  #define PROFILE_THREAD_NAME(name) blunted::Profiler::SetThreadName(name)
+  #define PROFILE_DUMP(filename) blunted::Profiler::WriteChromeTrace(filename)
+#else
+  #define PROFILE_ZONE(name)
+  #define PROFILE_ZONE_DYNAMIC(name)
+  #define PROFILE_NAME(name) ((const char*)0)
+  #define PROFILE_THREAD_NAME(name)
+  #define PROFILE_DUMP(filename)
+#endif
+
+namespace blunted {
+
+  struct ProfileEvent {
+    const char *name;
+    unsigned long long start_us;
+    unsigned long long duration_us;
+  };
+
+  // single writer (its thread), any number of readers
+  class ProfileThreadBuffer {
+
+    public:
+      ProfileThreadBuffer(int threadID);
+      virtual ~ProfileThreadBuffer();
+
+      inline void Record(const char *name, unsigned long long start_us, unsigned long long end_us) {
+        unsigned long index = written.load(std::memory_order_relaxed);
+        ProfileEvent &event = events[index & (capacity - 1)];
+        event.name = name;
+        event.start_us = start_us;
+        event.duration_us = end_us - start_us;
+        written.store(index + 1, std::memory_order_release);
+      }
+
+      /// copies the events still in the ring (oldest first); skips the ones the writer overwrote while copying
+      void GetEvents(std::vector<ProfileEvent> &result) const;
+
+      int GetThreadID() const { return threadID; }
+      std::string GetThreadName() const;
+      void SetThreadName(const std::string &name);
+
+      static const unsigned long capacity = 1 << 16; // power of two
+
+    protected:
+      ProfileEvent *events;
+      std::atomic<unsigned long> written;
+
+      int threadID;
+      mutable boost::mutex nameMutex;
+      std::string threadName;
+
+  };
+
+  extern thread_local ProfileThreadBuffer *profileThreadBuffer;
+
+  class Profiler {
+
+    public:
+      static inline unsigned long long GetTime_us() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+      }
+
+      /// this thread's buffer, created on first use
+      static inline ProfileThreadBuffer *GetThreadBuffer() {
+        return profileThreadBuffer ? profileThreadBuffer : CreateThreadBuffer();
+      }
+
+      static void SetThreadName(const std::string &name);
+
+      /// stable copy of a name that's not a literal (like a command's name). only locks the first time a thread sees a name
+      static const char *Intern(const std::string &name);
+
+      /// all threads' zones, as chrome trace_event json
+      static bool WriteChromeTrace(const std::string &filename);
+
+    protected:
+      static ProfileThreadBuffer *CreateThreadBuffer();
+
+  };
+
+  class ProfileZone {
+
+    public:
+      ProfileZone(const char *name) : name(name), start_us(Profiler::GetTime_us()) {}
+      ~ProfileZone() { Profiler::GetThreadBuffer()->Record(name, start_us, Profiler::GetTime_us()); }
+
+    protected:
+      const char *name;
+      unsigned long long start_us;
+
+  };
+
+  // wall time of the consecutive stages of something that happens once, like loading a match; logged all together by Report.
+  // unlike the zones, always compiled in
+  class StageTimer {
+
+    public:
+      /// logs as className::methodName, like the code it times would
+      StageTimer(const std::string &className, const std::string &methodName);
+
+      /// ends the current stage (if any) and starts this one
+      void Stage(const std::string &stageName);
+      /// ends the current stage and logs every stage's time and the total
+      void Report();
+
+    protected:
+      void EndStage();
+
+      std::string className;
+      std::string methodName;
+      std::vector< std::pair<std::string, unsigned long long> > stages; // name, duration
+      std::string currentStage;
+      unsigned long long stageStart_us;
+      unsigned long long start_us;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,80 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#include "tickarena.hpp"
+
+#include <atomic>
+#include <memory>
+
+namespace blunted {
+
+  namespace {
+    std::atomic<bool> arenasEnabled(true);
+    thread_local TickArena *currentArena = 0;
+    thread_local std::unique_ptr<TickArena> threadArena;
+  }
+
+  TickArena::TickArena(size_t chunkSize) : chunkSize(chunkSize), used(0), overflowSize(0), allocationCount(0) {
+    chunk = new char[chunkSize];
+  }
+
+  TickArena::~TickArena() {
+    Reset();
+    delete [] chunk;
+  }
+
+  void *TickArena::AllocateOverflow(size_t size, size_t alignment) {
+    // new[] is aligned for anything fundamental; that's all we hand out
+    assert(alignment <= alignof(std::max_align_t));
+    char *overflowChunk = new char[size];
+    overflowChunks.push_back(overflowChunk);
+    overflowSize += size + alignment;
+    allocationCount++;
+    return overflowChunk;
+  }
+
+  void TickArena::Reset() {
+    for (unsigned int i = 0; i < overflowChunks.size(); i++) delete [] overflowChunks.at(i);
+    overflowChunks.clear();
+    if (overflowSize > 0) {
+      chunkSize = chunkSize + overflowSize;
+      delete [] chunk;
+      chunk = new char[chunkSize];
+      overflowSize = 0;
+    }
+    used = 0;
+  }
+
+  TickArena *TickArena::GetCurrent() {
+    return currentArena;
+  }
+
+  TickArena *TickArena::GetThreadArena() {
+    if (!threadArena) threadArena.reset(new TickArena());
+    return threadArena.get();
+  }
+
+  void TickArena::SetEnabled(bool value) {
+    arenasEnabled.store(value, std::memory_order_relaxed);
+  }
+
+  bool TickArena::IsEnabled() {
+    return arenasEnabled.load(std::memory_order_relaxed);
+  }
+
+
+  // TickArenaScope
+
+  TickArenaScope::TickArenaScope() : previous(currentArena) {
+    if (!TickArena::IsEnabled()) return;
+    TickArena *arena = TickArena::GetThreadArena();
+    if (!previous) arena->Reset();
+    currentArena = arena;
+  }
+
+  TickArenaScope::~TickArenaScope() {
+    currentArena = previous;
+  }
+
+}
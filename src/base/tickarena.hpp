@@ -0,0 +1,99 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_BASE_TICKARENA
+#define _HPP_BASE_TICKARENA
+
+#include "defines.hpp"
+
+namespace blunted {
+
+  // bump allocator for the short-lived stuff of one match tick: allocating is moving a pointer, freeing is a no-op,
+  // and it's all released at once when the next tick starts. there's one per thread (so no locking), which a
+  // TickArenaScope makes the current one for that thread.
+  class TickArena {
+
+    public:
+      TickArena(size_t chunkSize = 256 * 1024);
+      virtual ~TickArena();
+
+      inline void *Allocate(size_t size, size_t alignment) {
+        size_t offset = (used + alignment - 1) & ~(alignment - 1);
+        if (offset + size > chunkSize) return AllocateOverflow(size, alignment);
+        used = offset + size;
+        allocationCount++;
+        return chunk + offset;
+      }
+
+      /// releases everything allocated since the previous reset. if the chunk overflowed, it grows so that next time it doesn't
+      void Reset();
+
+      unsigned long GetAllocationCount() const { return allocationCount; }
+
+      /// arena of the innermost TickArenaScope on this thread, or 0 if there is none (or the arenas are disabled)
+      static TickArena *GetCurrent();
+      static TickArena *GetThreadArena();
+
+      /// when disabled, scopes don't set a current arena, so everything goes to the heap (to compare)
+      static void SetEnabled(bool value);
+      static bool IsEnabled();
+
+    protected:
+      void *AllocateOverflow(size_t size, size_t alignment);
+
+      char *chunk;
+      size_t chunkSize;
+      size_t used;
+
+      std::vector<char*> overflowChunks;
+      size_t overflowSize;
+
+      unsigned long allocationCount;
+
+  };
+
+  // while one of these exists, GetCurrent() returns this thread's arena. the outermost one resets it
+  class TickArenaScope {
+
+    public:
+      TickArenaScope();
+      ~TickArenaScope();
+
+    protected:
+      TickArena *previous;
+
+  };
+
+  // stl allocator: uses the arena it was constructed with, or the heap when that's 0. so containers only use the arena when
+  // explicitly constructed with one, like 'std::vector<int, TickAllocator<int> > ints(TickArena::GetCurrent());', and
+  // must then be gone before the tick ends. default constructed (members, for example), they're just like any other
+  template <typename T> class TickAllocator {
+
+    public:
+      typedef T value_type;
+
+      TickAllocator(TickArena *arena = 0) : arena(arena) {}
+      template <typename U> TickAllocator(const TickAllocator<U> &other) : arena(other.arena) {}
+
+      T *allocate(size_t n) {
+        if (arena) return static_cast<T*>(arena->Allocate(n * sizeof(T), alignof(T)));
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+      }
+
+      void deallocate(T *p, size_t n) {
+        if (!arena) ::operator delete(p);
+      }
+
+      TickArena *arena;
+
+  };
+
+  template <typename T, typename U> inline bool operator == (const TickAllocator<T> &a, const TickAllocator<U> &b) { return a.arena == b.arena; }
+  template <typename T, typename U> inline bool operator != (const TickAllocator<T> &a, const TickAllocator<U> &b) { return a.arena != b.arena; }
+
+  template <typename T> using TickVector = std::vector<T, TickAllocator<T> >;
+
+}
+
+#endif
@@ -35,6 +35,7 @@
 #include "base/log.hpp"
 #include "base/utils.hpp"
 #include "base/properties.hpp"
+#include "base/profiler.hpp"
 
 #include "loaders/aseloader.hpp"
 #include "loaders/imageloader.hpp"
@@ -180,6 +181,9 @@ namespace blunted {
     Log(e_Notice, "blunted", "Exit", "destroying taskmanager");
     TaskManager::GetInstance().Destroy();
 
+    // all worker threads are done now
+    PROFILE_DUMP("profile.json");
+
     Log(e_Notice, "blunted", "Exit", "destroying scenemanager");
     SceneManager::GetInstance().Destroy();
 
@@ -8,14 +8,14 @@
 #include "managers/environmentmanager.hpp"
 #include "managers/taskmanager.hpp"
 #include "base/log.hpp"
+#include "base/profiler.hpp"
 #include "managers/usereventmanager.hpp"
 #include "SDL2/SDL.h"
 
 namespace blunted {
 
   Scheduler::Scheduler(TaskManager *taskManager) : taskManager(taskManager) {
-    cleanUpTimeOffset = 0;
-    previousTime_ms = 0;
+    cleanUpTime_us = 0;
   }
 
   Scheduler::~Scheduler() {
@@ -44,20 +44,26 @@ namespace blunted {
     if (sequence->GetEntryCount() == 0) Log(e_FatalError, "Scheduler", "RegisterTaskSequence", "Trying to add a sequence without entries");
     sequence->AddTerminator();
     boost::shared_ptr<TaskSequenceProgram> program(new TaskSequenceProgram());
-    unsigned long time_ms = EnvironmentManager::GetInstance().GetTime_ms();
+    unsigned long long time_us = EnvironmentManager::GetInstance().GetTime_us();
     program->taskSequence = sequence;
     program->programCounter = 0;
     program->previousProgramCounter = -1;
-    program->sequenceStartTime = time_ms;
-    program->lastSequenceTime = 0;
-    program->startTime = time_ms;
+    program->sequenceStartTime_us = time_us;
+    program->lastSequenceTime_us = 0;
+    program->startTime_us = time_us;
+    program->readyTime_us = time_us;
+    program->pauseTime_us = 0;
     program->timesRan = 0;
     program->paused = false;
     program->dueQuit = false;
-    program->readyToQuit = false;
+    program->running = false;
+    program->queueGeneration = 0;
+    program->measureJitter = false;
     sequences.Lock();
     sequences.data.push_back(program);
+    Enqueue(program, time_us);
     sequences.Unlock();
+    Wake();
   }
 
   void Scheduler::UnregisterTaskSequence(boost::shared_ptr<TaskSequence> sequence) {
@@ -66,301 +72,318 @@ namespace blunted {
 
   void Scheduler::UnregisterTaskSequence(const std::string &name) {
     sequences.Lock();
-    for (unsigned int i = 0; i < sequences.data.size(); i++) {
-      boost::shared_ptr<TaskSequenceProgram> program = sequences.data.at(i);
-      if (program->taskSequence->GetName() == name) {
-        program->dueQuit = true;
-        break;
-      }
+    boost::shared_ptr<TaskSequenceProgram> program = FindProgram(name);
+    if (program) {
+      program->dueQuit = true;
+      // a running one quits when it's done, others as soon as possible
+      if (!program->running) Enqueue(program, 0);
     }
     sequences.Unlock();
+    Wake();
   }
 
   void Scheduler::PauseTaskSequence(const std::string &name) {
     sequences.Lock();
-    for (unsigned int i = 0; i < sequences.data.size(); i++) {
-      boost::shared_ptr<TaskSequenceProgram> program = sequences.data.at(i);
-      if (program->taskSequence->GetName() == name) {
-        program->paused = true;
-        break;
-      }
+    boost::shared_ptr<TaskSequenceProgram> program = FindProgram(name);
+    if (program && !program->paused) {
+      // it will finish its current run; Run() leaves it out of the timer queue after that
+      program->paused = true;
+      program->pauseTime_us = EnvironmentManager::GetInstance().GetTime_us();
+      program->measureJitter = false;
     }
     sequences.Unlock();
   }
 
   void Scheduler::UnpauseTaskSequence(const std::string &name) {
     sequences.Lock();
-    for (unsigned int i = 0; i < sequences.data.size(); i++) {
-      boost::shared_ptr<TaskSequenceProgram> program = sequences.data.at(i);
-      if (program->taskSequence->GetName() == name) {
-        program->paused = false;
-        break;
-      }
+    boost::shared_ptr<TaskSequenceProgram> program = FindProgram(name);
+    if (program && program->paused) {
+      program->paused = false;
+      // paused time doesn't count for sequences that try to keep up
+      if (!program->taskSequence->GetSkippable()) program->startTime_us += EnvironmentManager::GetInstance().GetTime_us() - program->pauseTime_us;
+      if (!program->running) Enqueue(program, GetDueTime_us(program));
     }
     sequences.Unlock();
+    Wake();
   }
 
   void Scheduler::ResetTaskSequenceTime(const std::string &name) {
     sequences.Lock();
-    for (unsigned int i = 0; i < sequences.data.size(); i++) {
-      boost::shared_ptr<TaskSequenceProgram> program = sequences.data.at(i);
-      if (program->taskSequence->GetName() == name) {
-        program->startTime = EnvironmentManager::GetInstance().GetTime_ms();// - startTime_ms;
-        program->timesRan = 0;
-        break;
-      }
+    boost::shared_ptr<TaskSequenceProgram> program = FindProgram(name);
+    if (program) {
+      program->startTime_us = EnvironmentManager::GetInstance().GetTime_us();
+      program->timesRan = 0;
+      program->measureJitter = false;
+      if (!program->running && !program->paused) Enqueue(program, GetDueTime_us(program));
     }
     sequences.Unlock();
+    Wake();
   }
 
   unsigned long Scheduler::GetTaskSequenceTime_ms(const std::string &name) {
-    unsigned int resultTime_ms = 0;
+    unsigned long long resultTime_us = 0;
     sequences.Lock();
-    for (unsigned int i = 0; i < sequences.data.size(); i++) {
-      boost::shared_ptr<TaskSequenceProgram> program = sequences.data.at(i);
-      if (program->taskSequence->GetName() == name) {
-
-        if (program->taskSequence->GetSkippable()) {
-          resultTime_ms = program->sequenceStartTime + program->taskSequence->GetSequenceTime();
-        } else {
-          resultTime_ms = program->startTime + program->taskSequence->GetSequenceTime() * program->timesRan;
-        }
+    boost::shared_ptr<TaskSequenceProgram> program = FindProgram(name);
+    if (program) {
 
-        break;
+      if (program->taskSequence->GetSkippable()) {
+        resultTime_us = program->sequenceStartTime_us + program->taskSequence->GetSequenceTime_us();
+      } else {
+        resultTime_us = program->startTime_us + program->taskSequence->GetSequenceTime_us() * program->timesRan;
       }
+
     }
     sequences.Unlock();
-    return resultTime_ms;
+    return resultTime_us / 1000;
   }
 
   TaskSequenceInfo Scheduler::GetTaskSequenceInfo(const std::string &name) {
     TaskSequenceInfo info;
     sequences.Lock(); // todo: cache this to overcome threading traffic slowdowns?
-    for (unsigned int i = 0; i < sequences.data.size(); i++) {
-      boost::shared_ptr<TaskSequenceProgram> program = sequences.data.at(i);
-      if (program->taskSequence->GetName() == name) {
+    boost::shared_ptr<TaskSequenceProgram> program = FindProgram(name);
+    if (program) {
 
-        info.sequenceStartTime_ms = program->sequenceStartTime;
-        info.lastSequenceTime_ms = program->lastSequenceTime;
-        info.startTime_ms = program->startTime;
-        info.sequenceTime_ms = program->taskSequence->GetSequenceTime();
-        info.timesRan = program->timesRan;
+      info.sequenceStartTime_ms = program->sequenceStartTime_us / 1000;
+      info.lastSequenceTime_ms = program->lastSequenceTime_us / 1000;
+      info.startTime_ms = program->startTime_us / 1000;
+      info.sequenceTime_ms = program->taskSequence->GetSequenceTime();
+      info.timesRan = program->timesRan;
 
-        break;
-      }
     }
     sequences.Unlock();
     return info;
   }
 
-  bool Scheduler::Run() {
+  TaskSequenceStats Scheduler::GetTaskSequenceStats(const std::string &name) {
+    TaskSequenceStats stats;
+    sequences.Lock();
+    boost::shared_ptr<TaskSequenceProgram> program = FindProgram(name);
+    if (program) stats = program->stats;
+    sequences.Unlock();
+    return stats;
+  }
 
-    bool verbose = false;
+  boost::shared_ptr<TaskSequenceProgram> Scheduler::FindProgram(const std::string &name) {
+    for (unsigned int i = 0; i < sequences.data.size(); i++) {
+      if (sequences.data.at(i)->taskSequence->GetName() == name) return sequences.data.at(i);
+    }
+    return boost::shared_ptr<TaskSequenceProgram>();
+  }
 
-    // sequenced version, the best yet!
-    // thought up by Jurian Broertjes & Bastiaan Konings Schuiling
+  unsigned long long Scheduler::GetDueTime_us(boost::shared_ptr<TaskSequenceProgram> program) const {
+    if (program->taskSequence->GetSkippable()) {
+      // use relative time: don't mind if last frame lasted too long
+      return program->sequenceStartTime_us + program->taskSequence->GetSequenceTime_us();
+    } else {
+      // use absolute time: if not enough iterations have been done to get to frametime * timesran, start immediately
+      return program->startTime_us + program->taskSequence->GetSequenceTime_us() * program->timesRan;
+    }
+  }
 
-    boost::mutex::scoped_lock lock(somethingIsDoneMutex);
+  void Scheduler::Enqueue(boost::shared_ptr<TaskSequenceProgram> program, unsigned long long dueTime_us) {
+    // entries queued earlier for this program become stale, so there's no need to dig them out of the heap
+    program->queueGeneration++;
+    TaskSequenceQueueEntry entry;
+    entry.program = program;
+    entry.dueTime_us = dueTime_us;
+    entry.queueGeneration = program->queueGeneration;
+    timerQueue.push(entry);
+  }
 
-    unsigned int firstSequence = 0;
-    int quiterations = 0;
-    bool sequencesQuitMessageDone = false;
+  void Scheduler::StartProgram(boost::shared_ptr<TaskSequenceProgram> program, unsigned long long dueTime_us, unsigned long long time_us) {
+
+    TaskSequenceStats &stats = program->stats;
+    unsigned long latency_us = time_us - std::min(std::max(dueTime_us, program->readyTime_us), time_us);
+    stats.runs++;
+    stats.latencySum_us += latency_us;
+    stats.latencyMax_us = std::max(stats.latencyMax_us, latency_us);
+    if (program->measureJitter) {
+      long long deviation_us = (long long)(time_us - program->sequenceStartTime_us) - (long long)program->taskSequence->GetSequenceTime_us();
+      unsigned long jitter_us = deviation_us < 0 ? -deviation_us : deviation_us;
+      stats.jitterRuns++;
+      stats.jitterSum_us += jitter_us;
+      stats.jitterMax_us = std::max(stats.jitterMax_us, jitter_us);
+    }
+    program->measureJitter = true;
 
-    while (EnvironmentManager::GetInstance().GetQuit() == false || GetSequenceCount() > 0) {
+    program->sequenceStartTime_us = time_us;
+    program->running = true;
+    runningPrograms.push_back(program);
+  }
 
-      // Pump SDL events on the main thread (required on macOS)
-      SDL_Event event;
-      while (SDL_PollEvent(&event)) {
-        if (event.type == SDL_QUIT) {
-          EnvironmentManager::GetInstance().SignalQuit();
-        } else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F12) {
-          EnvironmentManager::GetInstance().SignalQuit();
-        }
-        UserEventManager::GetInstance().InputSDLEvent(event);
-      }
+  bool Scheduler::AdvanceProgram(boost::shared_ptr<TaskSequenceProgram> program, unsigned long long time_us) {
 
-      if (EnvironmentManager::GetInstance().GetQuit()) {
+    // execute entries for as long as the previous one is ready. the terminator (last entry) is always ready, so we end up here once more after it
+    while (program->previousProgramCounter == -1 || program->taskSequence->GetEntry(program->previousProgramCounter)->IsReady()) {
 
-        // let sequences finish
-        if (!sequencesQuitMessageDone) {
-          sequences.Lock();
-          for (unsigned int i = 0; i < sequences.data.size(); i++) {
-            sequences.data.at(i)->dueQuit = true;
-          }
-          sequences.Unlock();
-          sequencesQuitMessageDone = true;
-        }
+      if (program->programCounter == program->taskSequence->GetEntryCount()) {
+        program->programCounter = 0;
+        program->previousProgramCounter = -1;
+        program->timesRan++;
+        program->lastSequenceTime_us = time_us - program->sequenceStartTime_us;
+        program->readyTime_us = time_us;
+        program->running = false;
 
-        // check if we're stuck
-        if (sequencesQuitMessageDone && GetSequenceCount() > 0) {
-          quiterations++;
-          if (quiterations > 1000) {
-            // something won't shut up!
-            sequences.Lock();
-            for (unsigned int i = 0; i < sequences.data.size(); i++) {
-              printf("sequence '%s' is stuck on entry #%i!\n", sequences.data.at(i)->taskSequence->GetName().c_str(), sequences.data.at(i)->programCounter);
-            }
-            sequences.Unlock();
-            quiterations = 0;
-          }
-        }
+        TaskSequenceStats &stats = program->stats;
+        stats.runTimeSum_us += program->lastSequenceTime_us;
+        stats.runTimeMax_us = std::max(stats.runTimeMax_us, (unsigned long)program->lastSequenceTime_us);
+        return true;
       }
 
-      unsigned long time_ms = EnvironmentManager::GetInstance().GetTime_ms();
-      unsigned long timeDiff_ms = time_ms - previousTime_ms;
-      previousTime_ms = time_ms;
-
-      cleanUpTimeOffset += timeDiff_ms;
-
-
-      // find first sequence entry that needs to be started
-
-      TaskSequenceQueueEntry dueEntry;
-
-      sequences.Lock();
-
-      bool someSequenceNeedsDeleting = false;
-
-      for (unsigned int i = 0; i < sequences.data.size(); i++) {
-        int programIndex = (i + firstSequence) % sequences.data.size();
-        boost::shared_ptr<TaskSequenceProgram> program = sequences.data.at(programIndex);
+      program->taskSequence->GetEntry(program->programCounter)->Reset();
+      program->taskSequence->GetEntry(program->programCounter)->Execute();
 
-        if (verbose) printf("sequence %i, previous program counter %i, program counter %i\n", i, program->previousProgramCounter, program->programCounter);
-
-        // check if previous entry is ready
-        bool previousEntryIsReady = true;
-        if (program->previousProgramCounter != -1) {
-
-          previousEntryIsReady = program->taskSequence->GetEntry(program->previousProgramCounter)->IsReady();
+      program->previousProgramCounter = program->programCounter;
+      program->programCounter++;
+    }
 
-          if (previousEntryIsReady && program->programCounter == program->taskSequence->GetEntryCount()) {
-            program->programCounter = 0;
-            program->timesRan++;
-            program->lastSequenceTime = time_ms - program->sequenceStartTime;
-          }
+    return false;
+  }
 
-        }
+  void Scheduler::RemoveProgram(boost::shared_ptr<TaskSequenceProgram> program) {
+    std::vector < boost::shared_ptr<TaskSequenceProgram> >::iterator iter = std::find(sequences.data.begin(), sequences.data.end(), program);
+    if (iter != sequences.data.end()) sequences.data.erase(iter);
+  }
 
-        if (verbose) {
-          if (previousEntryIsReady) {
-            printf("sequence %i counter %i is ready\n", programIndex, program->previousProgramCounter);
-          } else {
-            printf("sequence %i counter %i is not ready\n", programIndex, program->previousProgramCounter);
-          }
-        }
+  void Scheduler::Wake() {
+    boost::mutex::scoped_lock lock(somethingIsDoneMutex);
+    somethingIsDone.notify_one();
+  }
 
-        if (previousEntryIsReady) {
+  void Scheduler::PumpEvents() {
+    // Pump SDL events on the main thread (required on macOS)
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+      if (event.type == SDL_QUIT) {
+        EnvironmentManager::GetInstance().SignalQuit();
+      } else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F12) {
+        EnvironmentManager::GetInstance().SignalQuit();
+      }
+#ifdef ENABLE_PROFILER
+      if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F10) PROFILE_DUMP("profile.json");
+#endif
+      UserEventManager::GetInstance().InputSDLEvent(event);
+    }
+  }
 
-          long timeUntilDueEntry_ms = 0; // if programCounter != 0, we just want to start the next entry ASAP
+  void Scheduler::LogStats(boost::shared_ptr<TaskSequenceProgram> program) {
+    const TaskSequenceStats &stats = program->stats;
+    if (stats.runs == 0) return;
+    char buf[256];
+    snprintf(buf, 256, "sequence '%s': %lu runs, latency avg %.0f us max %lu us, jitter avg %.0f us max %lu us, run time avg %.0f us max %lu us",
+             program->taskSequence->GetName().c_str(), stats.runs,
+             stats.latencySum_us / (double)stats.runs, stats.latencyMax_us,
+             stats.jitterSum_us / (double)std::max(stats.jitterRuns, 1ul), stats.jitterMax_us,
+             stats.runTimeSum_us / (double)stats.runs, stats.runTimeMax_us);
+    Log(e_Notice, "Scheduler", "LogStats", buf);
+  }
 
-          if (program->programCounter == 0) { // else, (re)starting sequence; find out when it's due
+  bool Scheduler::Run() {
 
-            if (program->dueQuit == true) {
+    // sequenced version, the best yet!
+    // thought up by Jurian Broertjes & Bastiaan Konings Schuiling
+    // (now event driven: sleeps until a sequence is due or an entry signals it's ready, instead of polling all sequences every ms)
 
-              program->readyToQuit = true;
-              someSequenceNeedsDeleting = true;
+    boost::mutex::scoped_lock lock(somethingIsDoneMutex);
 
-            } else if (program->paused == true) {
+    bool sequencesQuitMessageDone = false;
+    unsigned long long quitTime_us = 0;
+    unsigned long long previousTime_us = EnvironmentManager::GetInstance().GetTime_us();
 
-              if (!program->taskSequence->GetSkippable()) program->startTime += timeDiff_ms;
+    while (EnvironmentManager::GetInstance().GetQuit() == false || GetSequenceCount() > 0) {
 
-            } else { // not quitting or paused
+      PumpEvents();
 
-              if (program->taskSequence->GetSkippable()) {
-                // use relative time: don't mind if last frame lasted too long
-                timeUntilDueEntry_ms = (program->sequenceStartTime + program->taskSequence->GetSequenceTime()) - time_ms;
-                //printf("wiieee: %i .. %li .. %li\n", program->taskSequence->GetFrameTime(), time_ms, startTimeRel_ms);
-              } else {
-                // use absolute time: if not enough iterations have been done to get to frametime * timesran, start immediately
-                timeUntilDueEntry_ms = (program->startTime + program->taskSequence->GetSequenceTime() * program->timesRan) - time_ms;
-                //printf("wiieee: %i .. %li .. %li\n", program->taskSequence->GetSequenceTime(), time_ms, timeUntilDueEntry_ms);
-              }
+      unsigned long long time_us = EnvironmentManager::GetInstance().GetTime_us();
 
-            }
+      sequences.Lock();
 
-          }
+      if (EnvironmentManager::GetInstance().GetQuit()) {
 
-          if (!program->readyToQuit && !program->paused && (timeUntilDueEntry_ms < dueEntry.timeUntilDueEntry_ms || dueEntry.program == boost::shared_ptr<TaskSequenceProgram>())) {
-            dueEntry.program = program;
-            dueEntry.timeUntilDueEntry_ms = timeUntilDueEntry_ms;
+        // let sequences finish
+        if (!sequencesQuitMessageDone) {
+          for (unsigned int i = 0; i < sequences.data.size(); i++) {
+            sequences.data.at(i)->dueQuit = true;
+            if (!sequences.data.at(i)->running) Enqueue(sequences.data.at(i), 0);
           }
-
+          sequencesQuitMessageDone = true;
+          quitTime_us = time_us;
         }
 
-      } // checked all sequences and (hopefully) found an entry that is due next
-
-
-      // delete sequences that are ready to pussy out
-
-      if (someSequenceNeedsDeleting) {
-
-        std::vector < boost::shared_ptr<TaskSequenceProgram> >::iterator quiterator = sequences.data.begin();
-        while (quiterator != sequences.data.end()) {
-          boost::shared_ptr<TaskSequenceProgram> program = *quiterator;
-          if (program->readyToQuit == true) {
-            quiterator = sequences.data.erase(quiterator);
-          } else {
-            quiterator++;
+        // check if we're stuck
+        if (sequences.data.size() > 0 && time_us - quitTime_us > 5000000) {
+          // something won't shut up!
+          for (unsigned int i = 0; i < sequences.data.size(); i++) {
+            printf("sequence '%s' is stuck on entry #%i!\n", sequences.data.at(i)->taskSequence->GetName().c_str(), sequences.data.at(i)->programCounter);
           }
+          quitTime_us = time_us;
         }
+      }
 
-        // sequences.Unlock();
-        // continue;
-
-      } else { // (no deletes)
 
-        // switch first sequence to handle next time (so they all get a turn)
-        // todo: this way, longer sequences get relatively less time in total. is this desirable?
-        firstSequence++;
-        if (firstSequence >= sequences.data.size()) firstSequence = 0;
+      // running sequences: start the next entry of those whose current entry is ready
 
-        long timeout_ms = 0;
-        if (dueEntry.program != boost::shared_ptr<TaskSequenceProgram>()) {
-          // wait until time for due sequence entry (even if that is <= 0, because we need to unlock the condition and sequences locks anyway)
-          timeout_ms = dueEntry.timeUntilDueEntry_ms;
-          timeout_ms = std::max(timeout_ms, (long)0);
+      std::vector < boost::shared_ptr<TaskSequenceProgram> >::iterator runIter = runningPrograms.begin();
+      while (runIter != runningPrograms.end()) {
+        boost::shared_ptr<TaskSequenceProgram> program = *runIter;
+        if (AdvanceProgram(program, time_us)) {
+          runIter = runningPrograms.erase(runIter);
+          Enqueue(program, GetDueTime_us(program));
         } else {
-          timeout_ms = 100; // wait for wakeup signal
+          runIter++;
         }
+      }
 
-        sequences.Unlock();
-        boost::system_time tAbsoluteTime = boost::get_system_time() + boost::posix_time::milliseconds(timeout_ms);
-        bool isMessage = somethingIsDone.timed_wait(lock, tAbsoluteTime);
-        sequences.Lock();
 
-        if (dueEntry.program != boost::shared_ptr<TaskSequenceProgram>()) {
+      // (re)start sequences that are due
 
-          if (verbose) printf("time until due entry: %li\n", dueEntry.timeUntilDueEntry_ms);
+      while (!timerQueue.empty() && timerQueue.top().dueTime_us <= time_us) {
+        TaskSequenceQueueEntry dueEntry = timerQueue.top();
+        timerQueue.pop();
+        boost::shared_ptr<TaskSequenceProgram> program = dueEntry.program;
 
-          if (dueEntry.timeUntilDueEntry_ms <= 0) { // the first and/or other entries are due
+        if (dueEntry.queueGeneration != program->queueGeneration) continue; // rescheduled since
 
-            // run!
-            if (dueEntry.program->programCounter == 0) {
-              dueEntry.program->sequenceStartTime = time_ms;
-            }
+        if (program->dueQuit) {
+          LogStats(program);
+          RemoveProgram(program);
+          continue;
+        }
 
-            if (verbose) printf("executing program counter %i\n", dueEntry.program->programCounter);
-            dueEntry.program->taskSequence->GetEntry(dueEntry.program->programCounter)->Reset();
-            dueEntry.program->taskSequence->GetEntry(dueEntry.program->programCounter)->Execute();
+        if (program->paused) continue; // UnpauseTaskSequence will put it back in the queue
 
-            dueEntry.program->previousProgramCounter = dueEntry.program->programCounter;
-            dueEntry.program->programCounter++;
+        StartProgram(program, dueEntry.dueTime_us, time_us);
+        if (AdvanceProgram(program, time_us)) {
+          // all entries were ready right away
+          runningPrograms.pop_back();
+          Enqueue(program, GetDueTime_us(program));
+        }
+      }
 
-          }
 
-        }
+      // sleep until the first one is due. entries that become ready wake us through somethingIsDone
 
+      long long timeout_us = 100000;
+      if (!timerQueue.empty()) {
+        timeout_us = std::min(timeout_us, (long long)timerQueue.top().dueTime_us - (long long)EnvironmentManager::GetInstance().GetTime_us());
       }
 
       sequences.Unlock();
 
+      if (timeout_us > 0) {
+        boost::system_time tAbsoluteTime = boost::get_system_time() + boost::posix_time::microseconds(timeout_us);
+        somethingIsDone.timed_wait(lock, tAbsoluteTime);
+      }
+
 
       // cleanup unused resources
 
-      if (cleanUpTimeOffset > 5000) { // every 5 seconds
+      cleanUpTime_us += time_us - previousTime_us;
+      previousTime_us = time_us;
+      if (cleanUpTime_us > 5000000) { // every 5 seconds
         //printf("cleanup..\n");
         ResourceManagerPool::GetInstance().CleanUp();
-        cleanUpTimeOffset = 0;
+        cleanUpTime_us = 0;
       }
 
     }
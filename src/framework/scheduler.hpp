@@ -11,23 +11,57 @@
 #include "types/iusertask.hpp"
 #include "tasksequence.hpp"
 
+#include <queue>
+
 namespace blunted {
 
   class TaskManager;
 
+  // per sequence timing, in microseconds
+  struct TaskSequenceStats {
+    TaskSequenceStats() {
+      runs = 0;
+      latencySum_us = 0;
+      latencyMax_us = 0;
+      jitterRuns = 0;
+      jitterSum_us = 0;
+      jitterMax_us = 0;
+      runTimeSum_us = 0;
+      runTimeMax_us = 0;
+    }
+    unsigned long runs;
+    // latency: how long after a run could start (its due time, or the end of the previous run if that was later) it actually started
+    unsigned long long latencySum_us;
+    unsigned long latencyMax_us;
+    // jitter: how far the time between two consecutive starts was off from the sequence time
+    unsigned long jitterRuns;
+    unsigned long long jitterSum_us;
+    unsigned long jitterMax_us;
+    // run time: start of the first entry until the last one is ready
+    unsigned long long runTimeSum_us;
+    unsigned long runTimeMax_us;
+  };
+
   struct TaskSequenceProgram {
     boost::shared_ptr<TaskSequence> taskSequence;
     int programCounter;
     int previousProgramCounter;
-    unsigned long sequenceStartTime; // todo: add _ms to varnames like this one
-    unsigned long lastSequenceTime;
-    unsigned long startTime;
+    unsigned long long sequenceStartTime_us;
+    unsigned long long lastSequenceTime_us;
+    unsigned long long startTime_us;
+    unsigned long long readyTime_us; // end of the previous run
+    unsigned long long pauseTime_us;
     int timesRan;
     // set to true to let sequence finish, but not restart
     bool dueQuit;
     bool paused;
-    // set to true if sequence is finished
-    bool readyToQuit;
+    // true while its entries are being executed; otherwise, it's either waiting in the timer queue or (when paused) nowhere
+    bool running;
+    // timer queue entries with another generation are stale (the program was rescheduled after they were queued)
+    unsigned int queueGeneration;
+    // false after (re)starting or pausing: no previous start to measure jitter against
+    bool measureJitter;
+    TaskSequenceStats stats;
   };
 
   // sort of 'light version' of the above, meant as informative to return to nosey enquirers
@@ -48,13 +82,16 @@ namespace blunted {
 
   struct TaskSequenceQueueEntry {
     TaskSequenceQueueEntry() {
-      timeUntilDueEntry_ms = 0;
+      dueTime_us = 0;
+      queueGeneration = 0;
     }
     boost::shared_ptr<TaskSequenceProgram> program;
-    long timeUntilDueEntry_ms;
+    unsigned long long dueTime_us;
+    unsigned int queueGeneration;
 
+    // reversed, so that std::priority_queue has the first due entry on top
     bool operator < (const TaskSequenceQueueEntry &other) const {
-      return timeUntilDueEntry_ms < other.timeUntilDueEntry_ms;
+      return dueTime_us > other.dueTime_us;
     }
   };
 
@@ -75,22 +112,38 @@ namespace blunted {
       void ResetTaskSequenceTime(const std::string &name);
       unsigned long GetTaskSequenceTime_ms(const std::string &name);
       TaskSequenceInfo GetTaskSequenceInfo(const std::string &name);
+      TaskSequenceStats GetTaskSequenceStats(const std::string &name);
 
       /// send due system tasks a SystemTaskMessage_StartFrame message
       /// invoke due user tasks with an Execute() call
+      /// sleeps until either the first timed sequence is due, or somethingIsDone is signalled (which entries do when they're ready)
       bool Run();
 
       boost::condition somethingIsDone;
       boost::mutex somethingIsDoneMutex;
 
     protected:
-      TaskManager *taskManager;
+      // all below: call with sequences locked
+      boost::shared_ptr<TaskSequenceProgram> FindProgram(const std::string &name);
+      unsigned long long GetDueTime_us(boost::shared_ptr<TaskSequenceProgram> program) const;
+      void Enqueue(boost::shared_ptr<TaskSequenceProgram> program, unsigned long long dueTime_us);
+      void StartProgram(boost::shared_ptr<TaskSequenceProgram> program, unsigned long long dueTime_us, unsigned long long time_us);
+      bool AdvanceProgram(boost::shared_ptr<TaskSequenceProgram> program, unsigned long long time_us);
+      void RemoveProgram(boost::shared_ptr<TaskSequenceProgram> program);
+
+      void Wake();
+      void PumpEvents();
+      void LogStats(boost::shared_ptr<TaskSequenceProgram> program);
 
-      unsigned long previousTime_ms;
+      TaskManager *taskManager;
 
       Lockable < std::vector < boost::shared_ptr<TaskSequenceProgram> > > sequences;
 
-      unsigned long cleanUpTimeOffset;
+      // both protected by the sequences lock
+      std::priority_queue<TaskSequenceQueueEntry> timerQueue;
+      std::vector < boost::shared_ptr<TaskSequenceProgram> > runningPrograms;
+
+      unsigned long long cleanUpTime_us;
 
   };
 
@@ -147,7 +147,7 @@ namespace blunted {
 
   // TaskSequence
 
-  TaskSequence::TaskSequence(const std::string &name, int sequenceTime_ms, bool skipOnTooLate) : name(name), sequenceTime_ms(sequenceTime_ms), skipOnTooLate(skipOnTooLate) {
+  TaskSequence::TaskSequence(const std::string &name, int sequenceTime_ms, bool skipOnTooLate) : name(name), sequenceTime_us(sequenceTime_ms * 1000), skipOnTooLate(skipOnTooLate) {
   }
 
   TaskSequence::~TaskSequence() {
@@ -235,11 +235,19 @@ namespace blunted {
   }
 
   int TaskSequence::GetSequenceTime() const {
-    return sequenceTime_ms;
+    return sequenceTime_us / 1000;
   }
 
   void TaskSequence::SetSequenceTime(int value) {
-    sequenceTime_ms = value;
+    sequenceTime_us = value * 1000;
+  }
+
+  unsigned long TaskSequence::GetSequenceTime_us() const {
+    return sequenceTime_us;
+  }
+
+  void TaskSequence::SetSequenceTime_us(unsigned long value) {
+    sequenceTime_us = value;
   }
 
   const std::string TaskSequence::GetName() const {
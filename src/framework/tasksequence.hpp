@@ -143,6 +143,8 @@ namespace blunted {
       boost::shared_ptr<ITaskSequenceEntry> GetEntry(int num);
       int GetSequenceTime() const;
       void SetSequenceTime(int value);
+      unsigned long GetSequenceTime_us() const; // for sequence times that aren't a whole number of ms (like 1/144th of a second)
+      void SetSequenceTime_us(unsigned long value);
       const std::string GetName() const;
       bool GetSkippable() const { return skipOnTooLate; }
 
@@ -153,7 +155,7 @@ namespace blunted {
 
       // time assigned for 1 run of this sequence
       // if 0, run continuously
-      int sequenceTime_ms;
+      unsigned long sequenceTime_us;
 
       // if at due start time the previous run is not ready yet,
       // if true: just forget about the lost time
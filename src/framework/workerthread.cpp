@@ -8,10 +8,11 @@
 
 #include "managers/taskmanager.hpp"
 #include "base/utils.hpp"
+#include "base/profiler.hpp"
 
 namespace blunted {
 
-  WorkerThread::WorkerThread(int affinity) : Thread(), affinity(affinity), messagesHandled(0) {
+  WorkerThread::WorkerThread(int index) : Thread(), index(index), affinity(index), messagesHandled(0) {
     taskManager = TaskManager::GetInstancePtr();
   }
 
@@ -21,6 +22,7 @@ namespace blunted {
 
   void WorkerThread::operator()() {
     Log(e_Notice, "WorkerThread", "operator()()", "Starting worker thread");
+    PROFILE_THREAD_NAME("WorkerThread " + int_to_str(index));
 
     bool forceAffinity = false; // for debugging
     if (forceAffinity && affinity != -1) {
@@ -44,7 +46,8 @@ namespace blunted {
     while (!quit) {
 
       // check mailbox
-      boost::intrusive_ptr<Command> message = taskManager->WaitForWork();
+      boost::intrusive_ptr<Command> message = taskManager->WaitForWork(index);
+      if (!message) break; // task manager is exiting
 
       // need to set thread state and command name at the same time
       LockState();
@@ -52,8 +55,11 @@ namespace blunted {
       currentCommandName.SetData(message->GetName());
       UnlockState();
 
-      if (!message->Handle(this)) quit = true;
-      message.reset();
+      {
+        PROFILE_ZONE(message->GetProfileName());
+        if (!message->Handle(this)) quit = true;
+        message.reset();
+      }
 
       LockState();
       SetState_NoLock(e_ThreadState_Idle);
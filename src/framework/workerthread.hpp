@@ -14,7 +14,7 @@ namespace blunted {
   class WorkerThread : public Thread {
 
     public:
-      WorkerThread(int affinity = -1);
+      WorkerThread(int index); // index into the task manager's pool (and cpu affinity, if forced)
       ~WorkerThread();
 
       void operator()();
@@ -23,6 +23,7 @@ namespace blunted {
 
     protected:
       TaskManager *taskManager;
+      int index;
       int affinity;
       unsigned long messagesHandled;
 
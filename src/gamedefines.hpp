@@ -8,6 +8,7 @@
 #include "defines.hpp"
 
 #include "base/math/vector3.hpp"
+#include "base/tickarena.hpp"
 
 #include <SDL2/SDL.h> // for key ids
 
@@ -69,9 +70,9 @@ const int temporalSmoother_history_ms = 20;
 
 //#define dataSetSortable 1
 #ifdef dataSetSortable
-typedef std::list<int> DataSet;
+typedef std::list<int, TickAllocator<int> > DataSet;
 #else
-typedef std::deque<int> DataSet;
+typedef std::deque<int, TickAllocator<int> > DataSet;
 #endif
 
 const SDL_Keycode defaultKeyIDs[18] = { SDLK_UP, SDLK_RIGHT, SDLK_DOWN, SDLK_LEFT, SDLK_w, SDLK_a, SDLK_s, SDLK_d, SDLK_w, SDLK_a, SDLK_s, SDLK_d, SDLK_q, SDLK_z, SDLK_e, SDLK_c, SDLK_F1, SDLK_RETURN };
@@ -228,7 +229,7 @@ struct PlayerCommand {
   int            modifier;
 };
 
-typedef std::vector<PlayerCommand> PlayerCommandQueue;
+typedef std::vector<PlayerCommand, TickAllocator<PlayerCommand> > PlayerCommandQueue;
 
 enum e_PlayerRole {
   e_PlayerRole_GK,
@@ -266,6 +267,9 @@ struct PlayerImage {
   FormationEntry dynamicFormationEntry;
 };
 
+// construct with TickArena::GetCurrent() for the per-tick ones
+typedef std::vector<PlayerImage, TickAllocator<PlayerImage> > PlayerImages;
+
 bool PlayerImageDepthSortFunc(const PlayerImage &a, const PlayerImage &b);
 
 const float pitchHalfW = 55; // only inside side- and backlines
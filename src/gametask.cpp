@@ -143,9 +143,14 @@ void GameTask::ProcessPhase() {
 
 }
 
+static void UpdateFullbodyModels(const std::vector<PlayerBase*> &playersToProcess, int begin, int end) {
+  for (int i = begin; i < end; i++) {
+    playersToProcess.at(i)->UpdateFullbodyModel();
+  }
+}
+
 void GameTask::PutPhase() {
 
-  std::vector < boost::intrusive_ptr<UpdateFullbodyModel> > updateFullbodyModels;
   std::vector < boost::intrusive_ptr<UploadFullbodyModel> > uploadFullbodyModels;
   std::vector<PlayerBase*> playersToProcess;
 
@@ -172,31 +177,11 @@ void GameTask::PutPhase() {
       playersToProcess.push_back(officials.at(i));
     }
 
-    //printf("%i players, %i threads.\n", playersToProcess.size(), threadCount);
-    unsigned int playersPerThread = 7;
-    unsigned int playerStartIndex = 0;
-    while (playerStartIndex < playersToProcess.size()) {
-      std::vector<PlayerBase*> playersToProcessInThread;
-      for (unsigned int p = 0; p < playersPerThread; p++) {
-        if (playerStartIndex + p >= playersToProcess.size()) break;
-        playersToProcessInThread.push_back(playersToProcess.at(playerStartIndex + p));
-        //printf("adding player %i\n", playerStartIndex + p);
-        // unthreaded version: playersToProcess.at(playerStartIndex + p)->UpdateFullbodyModel();
-      }
-      playerStartIndex += playersPerThread;
-
-      boost::intrusive_ptr<UpdateFullbodyModel> updateFullbodyModel(new UpdateFullbodyModel(playersToProcessInThread));
-      updateFullbodyModels.push_back(updateFullbodyModel);
-      TaskManager::GetInstance().EnqueueWork(updateFullbodyModel, true);
-    }
-
     match->UploadGoalNetting(); // won't this block the whole process thing too? (opengl busy == wait, while mutex locked == no process)
 
-  }
-
+    // unthreaded version: UpdateFullbodyModels(playersToProcess, 0, playersToProcess.size());
+    TaskManager::GetInstance().ParallelFor(playersToProcess.size(), 7, boost::bind(&UpdateFullbodyModels, boost::cref(playersToProcess), _1, _2));
 
-  for (unsigned int t = 0; t < updateFullbodyModels.size(); t++) {
-    updateFullbodyModels.at(t)->Wait();
   }
 
   if (match) {
@@ -226,4 +211,7 @@ void GameTask::PutPhase() {
   if (menuScene) menuScene->Put();
   menuSceneLifetimeMutex.unlock();
 
+  // everything has moved for this frame: refit the culling index, and hand it to the graphics' culling workers
+  if (scene3D) scene3D->UpdateCullIndex();
+
 }
@@ -19,28 +19,6 @@
 using namespace blunted;
 
 
-class UpdateFullbodyModel : public Command {
-
-  public:
-    UpdateFullbodyModel(std::vector<PlayerBase*> playersToProcess) : Command("UpdateFullBodyModel"), playersToProcess(playersToProcess) {};
-    virtual ~UpdateFullbodyModel() {};
-
-  protected:
-    void Update() {
-      for (unsigned int i = 0; i < playersToProcess.size(); i++) {
-        playersToProcess.at(i)->UpdateFullbodyModel();
-      }
-    }
-
-    virtual bool Execute(void *caller = NULL) {
-      Update();
-      return true;
-    }
-
-    std::vector<PlayerBase*> playersToProcess;
-
-};
-
 class UploadFullbodyModel : public Command {
 
   public:
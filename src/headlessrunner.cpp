@@ -0,0 +1,207 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#include "headlessrunner.hpp"
+
+#include "main.hpp"
+
+#include "onthepitch/match.hpp"
+#include "onthepitch/matchinputlog.hpp"
+#include "onthepitch/player/player.hpp"
+#include "onthepitch/player/humanoid/animcollection.hpp"
+#include "data/matchdata.hpp"
+
+#include "managers/environmentmanager.hpp"
+#include "managers/taskmanager.hpp"
+
+#include "base/log.hpp"
+#include "base/utils.hpp"
+#include "base/math/bluntmath.hpp"
+#include "base/tickarena.hpp"
+#include "base/allocationcount.hpp"
+
+#include <boost/bind.hpp>
+
+static void UpdateFullbodyModels(const std::vector<PlayerBase*> &playersToProcess, int begin, int end) {
+  for (int i = begin; i < end; i++) playersToProcess.at(i)->UpdateFullbodyModel();
+}
+
+HeadlessRunner::HeadlessRunner(const Properties &config) {
+  matchCount = config.GetInt("headless_matches", 1);
+  teamDatabaseIDs[0] = config.GetInt("headless_team1", 3);
+  teamDatabaseIDs[1] = config.GetInt("headless_team2", 8);
+  maxTicks = config.GetInt("headless_max_ticks", 0);
+  seed = config.GetInt("headless_seed", 0);
+  skinning = config.GetBool("headless_skinning", false);
+  replayFilename = config.Get("headless_replay", "");
+}
+
+HeadlessRunner::~HeadlessRunner() {
+}
+
+void HeadlessRunner::Run() {
+
+  Log(e_Notice, "HeadlessRunner", "Run", "Running " + int_to_str(matchCount) + " headless match(es)");
+
+  LoadAnims();
+
+  unsigned long totalTicks = 0;
+  unsigned long totalWallTime_ms = 0;
+
+  for (int i = 0; i < matchCount; i++) {
+    HeadlessMatchResult result = RunMatch(i);
+    totalTicks += result.ticks;
+    totalWallTime_ms += result.wallTime_ms;
+    PrintResult(i, result);
+  }
+
+  PrintSummary(totalTicks, totalWallTime_ms);
+}
+
+HeadlessMatchResult HeadlessRunner::RunMatch(int matchIndex) {
+
+  HeadlessMatchResult result;
+
+  MatchData *matchData = 0;
+  if (!replayFilename.empty()) {
+    replayLog = boost::shared_ptr<MatchInputLog>(new MatchInputLog());
+    if (!replayLog->Load(replayFilename)) {
+      replayLog.reset();
+      return result;
+    }
+    replayLog->ApplyConfiguration(*GetConfiguration());
+    matchData = replayLog->CreateMatchData(); // the match seeds itself from the log
+  } else {
+    SeedMatch(matchIndex);
+    matchData = new MatchData(teamDatabaseIDs[0], teamDatabaseIDs[1]);
+  }
+  result.teamDatabaseID[0] = matchData->GetTeamData(0)->GetDatabaseID();
+  result.teamDatabaseID[1] = matchData->GetTeamData(1)->GetDatabaseID();
+
+  GetMenuTask()->SetMatchData(matchData);
+  GetMenuTask()->SetControllerSetup(std::vector<SideSelection>()); // no human gamers, AI vs AI (replays bring their own)
+
+  Match *match = 0;
+  if (replayLog) {
+    match = new Match(matchData, replayLog->GetControllers(), anims, replayLog);
+  } else {
+    match = new Match(matchData, GetControllers(), anims);
+  }
+
+  unsigned long startTime_ms = EnvironmentManager::GetInstance().GetTime_ms();
+  unsigned long startHeapAllocations = GetHeapAllocationCount();
+
+  while (!IsFinished(match, result.ticks)) {
+    Step(match);
+    if (skinning) result.skinningTime_us += SkinPlayers(match);
+    result.ticks++;
+  }
+
+  result.wallTime_ms = EnvironmentManager::GetInstance().GetTime_ms() - startTime_ms;
+  result.heapAllocations = GetHeapAllocationCount() - startHeapAllocations;
+
+  for (int teamID = 0; teamID < 2; teamID++) {
+    result.goals[teamID] = matchData->GetGoalCount(teamID);
+    result.shots[teamID] = matchData->GetShots(teamID);
+    result.possession_ms[teamID] = matchData->GetPossessionTime_ms(teamID);
+  }
+
+  // this deletes matchData as well
+  match->Exit();
+  delete match;
+
+  if (replayLog) {
+    result.replayDivergedTick = replayLog->GetDivergedTick();
+    replayLog.reset();
+  }
+
+  return result;
+}
+
+void HeadlessRunner::LoadAnims() {
+  if (anims) return;
+  Log(e_Notice, "HeadlessRunner", "LoadAnims", "Loading player animations");
+  anims = boost::shared_ptr<AnimCollection>(new AnimCollection(GetScene3D()));
+  anims->Load("media/animations");
+}
+
+void HeadlessRunner::SeedMatch(int matchIndex) {
+  // 0 == keep the clock-based seeds main() has set
+  if (seed == 0) return;
+  randomseed(seed + matchIndex);
+  fastrandomseed(seed + matchIndex);
+}
+
+bool HeadlessRunner::IsFinished(Match *match, unsigned long ticks) const {
+  if (replayLog) {
+    // the recording knows when it ended (which may well be in extra time)
+    if (ticks >= replayLog->GetTickCount()) return true;
+  } else {
+    if (match->IsGameOver()) return true;
+
+    // in the game, the phase menu takes over after regular time. nobody to click it here, so that's the end of it
+    if (match->GetMatchPhase() >= e_MatchPhase_1stExtraTime) return true;
+  }
+
+  if (maxTicks > 0 && ticks >= maxTicks) return true;
+
+  return false;
+}
+
+void HeadlessRunner::Step(Match *match) {
+
+  // same order as the game and graphics sequences would run them, only without waiting for anyone
+  match->Get();
+  match->Process();
+  match->PreparePutBuffers();
+  match->FetchPutBuffers();
+  match->Put();
+
+  // normally, the replay/phase pages unpause the match
+  if (match->GetPause()) match->Pause(false);
+}
+
+unsigned long HeadlessRunner::SkinPlayers(Match *match) const {
+
+  // same set GameTask::PutPhase hands to the renderer when paused: all active players plus officials (minus the upload)
+  std::vector<Player*> players;
+  match->GetActiveTeamPlayers(0, players);
+  match->GetActiveTeamPlayers(1, players);
+  std::vector<PlayerBase*> officials;
+  match->GetOfficialPlayers(officials);
+
+  std::vector<PlayerBase*> playersToProcess(players.begin(), players.end());
+  playersToProcess.insert(playersToProcess.end(), officials.begin(), officials.end());
+
+  boost::posix_time::ptime startTime = boost::posix_time::microsec_clock::local_time();
+  TaskManager::GetInstance().ParallelFor(playersToProcess.size(), 7, boost::bind(&UpdateFullbodyModels, boost::cref(playersToProcess), _1, _2));
+  return (boost::posix_time::microsec_clock::local_time() - startTime).total_microseconds();
+}
+
+void HeadlessRunner::PrintResult(int matchIndex, const HeadlessMatchResult &result) const {
+  unsigned long totalPossession_ms = std::max(result.possession_ms[0] + result.possession_ms[1], 1ul);
+  printf("headless match %i: team %i - team %i, score %i - %i, shots %i - %i, possession %.1f%% - %.1f%%, %lu ticks in %lu ms\n",
+         matchIndex, result.teamDatabaseID[0], result.teamDatabaseID[1], result.goals[0], result.goals[1], result.shots[0], result.shots[1],
+         result.possession_ms[0] * 100.0f / totalPossession_ms, result.possession_ms[1] * 100.0f / totalPossession_ms,
+         result.ticks, result.wallTime_ms);
+  if (result.skinningTime_us > 0) {
+    printf("headless match %i: fullbody skinning %lu us total, %.1f us per tick\n", matchIndex, result.skinningTime_us, result.skinningTime_us / (float)std::max(result.ticks, 1ul));
+  }
+  if (!replayFilename.empty()) {
+    if (result.replayDivergedTick == -1) {
+      printf("headless match %i: replay of %s identical to the recording\n", matchIndex, replayFilename.c_str());
+    } else {
+      printf("headless match %i: replay of %s diverged from the recording at tick %li\n", matchIndex, replayFilename.c_str(), result.replayDivergedTick);
+    }
+  }
+  if (IsCountingAllocations()) {
+    printf("headless match %i: %lu heap allocations, %.1f per tick (tick arena %s)\n", matchIndex, result.heapAllocations, result.heapAllocations / (float)std::max(result.ticks, 1ul), TickArena::IsEnabled() ? "on" : "off");
+  }
+}
+
+void HeadlessRunner::PrintSummary(unsigned long totalTicks, unsigned long totalWallTime_ms) const {
+  // one tick == 10ms of simulated time
+  float ticksPerSecond = totalTicks * 1000.0f / std::max(totalWallTime_ms, 1ul);
+  printf("headless: %lu ticks in %lu ms, %.0f ticks/s (%.1fx realtime)\n", totalTicks, totalWallTime_ms, ticksPerSecond, ticksPerSecond / 100.0f);
+}
@@ -0,0 +1,86 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_FOOTBALL_HEADLESSRUNNER
+#define _HPP_FOOTBALL_HEADLESSRUNNER
+
+#include "defines.hpp"
+
+#include "base/properties.hpp"
+
+#include <boost/shared_ptr.hpp>
+
+using namespace blunted;
+
+class Match;
+class AnimCollection;
+class MatchInputLog;
+
+struct HeadlessMatchResult {
+  HeadlessMatchResult() {
+    for (int i = 0; i < 2; i++) {
+      teamDatabaseID[i] = 0;
+      goals[i] = 0;
+      shots[i] = 0;
+      possession_ms[i] = 0;
+    }
+    ticks = 0;
+    wallTime_ms = 0;
+    skinningTime_us = 0;
+    heapAllocations = 0;
+    replayDivergedTick = -1;
+  }
+  int teamDatabaseID[2];
+  int goals[2];
+  int shots[2];
+  unsigned long possession_ms[2];
+  unsigned long ticks;
+  unsigned long wallTime_ms;
+  unsigned long skinningTime_us;
+  unsigned long heapAllocations; // only counted in COUNT_ALLOCATIONS builds
+  long replayDivergedTick; // -1 == identical to the recording (or not a replay)
+};
+
+// runs AI vs AI matches without renderer, audio or scheduler: every Process() is one 10ms step on the match's virtual clock,
+// and those steps are done back to back, as fast as the cpu allows.
+// config keys: headless_matches, headless_team1, headless_team2, headless_max_ticks (0 == until the end of regular time),
+// headless_seed (0 == seed from the clock; otherwise match i is seeded with headless_seed + i),
+// headless_skinning (also skin all players and officials every tick, like the renderer would, and time it).
+// builds with COUNT_ALLOCATIONS also print the heap allocations per tick (compare with match_tick_arena off).
+// headless_replay: re-simulate the match input log (see match_input_log) in this file instead, headless_matches times. the
+// recorded teams, seed and settings replace the ones above, and every replay checks it's identical to the recording
+class HeadlessRunner {
+
+  public:
+    HeadlessRunner(const Properties &config);
+    virtual ~HeadlessRunner();
+
+    virtual void Run();
+
+    HeadlessMatchResult RunMatch(int matchIndex);
+
+  protected:
+    void LoadAnims();
+    void SeedMatch(int matchIndex);
+    bool IsFinished(Match *match, unsigned long ticks) const;
+    void Step(Match *match);
+    unsigned long SkinPlayers(Match *match) const;
+    void PrintResult(int matchIndex, const HeadlessMatchResult &result) const;
+    void PrintSummary(unsigned long totalTicks, unsigned long totalWallTime_ms) const;
+
+    int matchCount;
+    int teamDatabaseIDs[2];
+    unsigned long maxTicks;
+    unsigned int seed;
+    bool skinning;
+    std::string replayFilename;
+
+    boost::shared_ptr<MatchInputLog> replayLog; // of the match that's running
+
+    // loaded once, shared (read-only) by all matches of the run
+    boost::shared_ptr<AnimCollection> anims;
+
+};
+
+#endif
@@ -0,0 +1,45 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#include "hidreplay.hpp"
+
+HIDReplay::HIDReplay(e_HIDeviceType deviceType, const std::string &identifier) : buttons(0), previousButtons(0) {
+  this->deviceType = deviceType;
+  this->identifier = identifier;
+  direction = Vector3(0, 0, 0);
+}
+
+HIDReplay::~HIDReplay() {
+}
+
+bool HIDReplay::GetButton(e_ButtonFunction buttonFunction) {
+  boost::mutex::scoped_lock blah(mutex);
+  return buttons & (1 << buttonFunction);
+}
+
+float HIDReplay::GetButtonValue(e_ButtonFunction buttonFunction) {
+  if (GetButton(buttonFunction)) return 1.0; else return 0.0;
+}
+
+void HIDReplay::SetButton(e_ButtonFunction buttonFunction, bool state) {
+  boost::mutex::scoped_lock blah(mutex);
+  if (state) buttons |= (1 << buttonFunction); else buttons &= ~(1 << buttonFunction);
+}
+
+bool HIDReplay::GetPreviousButtonState(e_ButtonFunction buttonFunction) {
+  boost::mutex::scoped_lock blah(mutex);
+  return previousButtons & (1 << buttonFunction);
+}
+
+Vector3 HIDReplay::GetDirection() {
+  boost::mutex::scoped_lock blah(mutex);
+  return direction;
+}
+
+void HIDReplay::SetState(unsigned int buttons, unsigned int previousButtons, const Vector3 &direction) {
+  boost::mutex::scoped_lock blah(mutex);
+  this->buttons = buttons;
+  this->previousButtons = previousButtons;
+  this->direction = direction;
+}
@@ -0,0 +1,42 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_HIDREPLAY
+#define _HPP_HIDREPLAY
+
+#include "base/math/vector3.hpp"
+
+#include "ihidevice.hpp"
+
+using namespace blunted;
+
+// stand-in for a keyboard or gamepad while replaying a match input log: Process() does nothing, the log sets the state every tick
+class HIDReplay : public IHIDevice {
+
+  public:
+    HIDReplay(e_HIDeviceType deviceType, const std::string &identifier);
+    virtual ~HIDReplay();
+
+    virtual void LoadConfig() {}
+    virtual void SaveConfig() {}
+
+    virtual void Process() {}
+
+    virtual bool GetButton(e_ButtonFunction buttonFunction);
+    virtual float GetButtonValue(e_ButtonFunction buttonFunction); // for analog support
+    virtual void SetButton(e_ButtonFunction buttonFunction, bool state);
+    virtual bool GetPreviousButtonState(e_ButtonFunction buttonFunction);
+    virtual Vector3 GetDirection();
+
+    /// buttons: bit n == e_ButtonFunction n
+    void SetState(unsigned int buttons, unsigned int previousButtons, const Vector3 &direction);
+
+  protected:
+    unsigned int buttons;
+    unsigned int previousButtons;
+    Vector3 direction;
+
+};
+
+#endif
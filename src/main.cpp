@@ -32,6 +32,9 @@
 
 #include "utils/orbitcamera.hpp"
 
+#include "headlessrunner.hpp"
+#include "matchbatchrunner.hpp"
+
 #include "SDL2/SDL.h"
 #include "SDL2/SDL_ttf.h"
 #include "SDL2/SDL_image.h"
@@ -91,6 +94,7 @@ boost::intrusive_ptr<Image2D> debugOverlay;
 std::vector<IHIDevice*> controllers;
 
 bool superDebug = false;
+bool headless = false;
 e_DebugMode debugMode = e_DebugMode_Off;
 
 std::string activeSaveDirectory;
@@ -153,6 +157,10 @@ bool SuperDebug() {
   return superDebug;
 }
 
+bool IsHeadless() {
+  return headless;
+}
+
 e_DebugMode GetDebugMode() {
   return debugMode;
 }
@@ -273,8 +281,13 @@ class ThreadHudThread : public Thread {
 
 int main(int argc, const char** argv) {
 
+  for (int i = 1; i < argc; i++) {
+    if (std::string(argv[i]) == "--headless") headless = true;
+    else configFile = argv[i];
+  }
+
   // Ensure SDL video subsystem is initialized on the main thread (required on macOS)
-  if ((SDL_WasInit(SDL_INIT_VIDEO) & SDL_INIT_VIDEO) == 0) {
+  if (!IsHeadless() && (SDL_WasInit(SDL_INIT_VIDEO) & SDL_INIT_VIDEO) == 0) {
     SDL_SetHint(SDL_HINT_MAC_CTRL_CLICK_EMULATE_RIGHT_CLICK, "1");
     SDL_SetHint(SDL_HINT_VIDEO_MAC_FULLSCREEN_SPACES, "1");
     SDL_SetHint(SDL_HINT_VIDEO_HIGHDPI_DISABLED, "0");
@@ -287,7 +300,6 @@ int main(int argc, const char** argv) {
   }
 
   config = new Properties();
-  if (argc > 1) configFile = argv[1];
   config->LoadFile(configFile.c_str());
 
   Initialize(*config);
@@ -308,20 +320,26 @@ int main(int argc, const char** argv) {
 
 
   // initialize systems
+  // headless: no systems at all, the scenes are just data then (nobody observes them)
 
   SystemManager *systemManager = SystemManager::GetInstancePtr();
 
-  graphicsSystem = new GraphicsSystem();
-  bool returnvalue = systemManager->RegisterSystem("GraphicsSystem", graphicsSystem);
-  if (!returnvalue) Log(e_FatalError, "football", "main", "Could not register GraphicsSystem");
+  graphicsSystem = 0;
+  audioSystem = 0;
+
+  if (!IsHeadless()) {
+    graphicsSystem = new GraphicsSystem();
+    bool returnvalue = systemManager->RegisterSystem("GraphicsSystem", graphicsSystem);
+    if (!returnvalue) Log(e_FatalError, "football", "main", "Could not register GraphicsSystem");
 
-  audioSystem = new AudioSystem();
-  returnvalue = systemManager->RegisterSystem("AudioSystem", audioSystem);
-  if (!returnvalue) Log(e_FatalError, "football", "main", "Could not register AudioSystem");
+    audioSystem = new AudioSystem();
+    returnvalue = systemManager->RegisterSystem("AudioSystem", audioSystem);
+    if (!returnvalue) Log(e_FatalError, "football", "main", "Could not register AudioSystem");
 
-  // todo: let systemmanager init systems?
-  graphicsSystem->Initialize(*config);
-  audioSystem->Initialize(*config);
+    // todo: let systemmanager init systems?
+    graphicsSystem->Initialize(*config);
+    audioSystem->Initialize(*config);
+  }
 
 
   // init scenes
@@ -332,8 +350,8 @@ int main(int argc, const char** argv) {
   scene3D = boost::shared_ptr<Scene3D>(new Scene3D("scene3D"));
   SceneManager::GetInstance().RegisterScene(scene3D);
 
-  if (SuperDebug()) InitDebugImage();
-  if (GetDebugMode() == e_DebugMode_AI) InitDebugOverlay();
+  if (SuperDebug() && !IsHeadless()) InitDebugImage();
+  if (GetDebugMode() == e_DebugMode_AI && !IsHeadless()) InitDebugOverlay();
 
   ThreadHudThread *threadHudThread = 0;
   if (!IsReleaseVersion() && 1 == 2) {
@@ -409,7 +427,7 @@ int main(int argc, const char** argv) {
 
   HIDKeyboard *keyboard = new HIDKeyboard();
   controllers.push_back(keyboard);
-  for (int i = 0; i < SDL_NumJoysticks(); i++) {
+  for (int i = 0; i < (IsHeadless() ? 0 : SDL_NumJoysticks()); i++) {
     HIDGamepad *gamepad = new HIDGamepad(i);
     controllers.push_back(gamepad);
   }
@@ -419,7 +437,7 @@ int main(int argc, const char** argv) {
 
   boost::mutex graphicsGameMutex; // todo: this mutex seems necessary for visual fluency, doesn't this imply that i'm setting positional stuff during something else than gametask put? (or reading during something else than graphics get)
 
-  gameTask = boost::shared_ptr<GameTask>(new GameTask());
+  if (!IsHeadless()) gameTask = boost::shared_ptr<GameTask>(new GameTask()); // headless runner drives its matches itself
 
   // TTF_Font *defaultFont = TTF_OpenFont("media/fonts/archivonarrow/ArchivoNarrow-Regular.ttf", 28);
   // TTF_Font *defaultOutlineFont = TTF_OpenFont("media/fonts/archivonarrow/ArchivoNarrow-Regular.ttf", 28);
@@ -432,52 +450,71 @@ int main(int argc, const char** argv) {
   if (controllers.size() > 1) menuTask->SetEventJoyButtons(static_cast<HIDGamepad*>(controllers.at(1))->GetControllerMapping(e_ControllerButton_A), static_cast<HIDGamepad*>(controllers.at(1))->GetControllerMapping(e_ControllerButton_B));
 
 
-  gameSequence = boost::shared_ptr<TaskSequence>(new TaskSequence("game", timeStep_ms, false));
+  if (IsHeadless()) {
 
-  // note: the whole locking stuff is now happening from within some of the code, iirc, 't is all very ugly and unclear. sorry
+    // no scheduler, no sequences: step matches back to back on a virtual clock
 
-  //gameSequence->AddLockEntry(graphicsGameMutex, e_LockAction_Lock);   // ---------- lock -----
+    if (config->GetInt("headless_matches", 1) > 1 && config->GetInt("headless_workers", 0) != 1 && config->Get("headless_replay", "").empty()) {
+      MatchBatchRunner batchRunner(*config);
+      batchRunner.Run();
+    } else {
+      HeadlessRunner headlessRunner(*config);
+      headlessRunner.Run();
+    }
 
-  gameSequence->AddUserTaskEntry(menuTask, e_TaskPhase_Get);
-  gameSequence->AddUserTaskEntry(menuTask, e_TaskPhase_Process);
-  gameSequence->AddUserTaskEntry(menuTask, e_TaskPhase_Put);
+  } else {
+
+    gameSequence = boost::shared_ptr<TaskSequence>(new TaskSequence("game", timeStep_ms, false));
+
+    // note: the whole locking stuff is now happening from within some of the code, iirc, 't is all very ugly and unclear. sorry
+
+    //gameSequence->AddLockEntry(graphicsGameMutex, e_LockAction_Lock);   // ---------- lock -----
 
-  //gameSequence->AddLockEntry(graphicsGameMutex, e_LockAction_Unlock); // ---------- unlock ---
+    gameSequence->AddUserTaskEntry(menuTask, e_TaskPhase_Get);
+    gameSequence->AddUserTaskEntry(menuTask, e_TaskPhase_Process);
+    gameSequence->AddUserTaskEntry(menuTask, e_TaskPhase_Put);
 
-  gameSequence->AddUserTaskEntry(gameTask, e_TaskPhase_Get);
-  gameSequence->AddUserTaskEntry(gameTask, e_TaskPhase_Process);
+    //gameSequence->AddLockEntry(graphicsGameMutex, e_LockAction_Unlock); // ---------- unlock ---
 
-//  gameSequence->AddLockEntry(graphicsGameMutex, e_LockAction_Unlock); // ---------- unlock ---
+    gameSequence->AddUserTaskEntry(gameTask, e_TaskPhase_Get);
+    gameSequence->AddUserTaskEntry(gameTask, e_TaskPhase_Process);
 
-  GetScheduler()->RegisterTaskSequence(gameSequence);
+//    gameSequence->AddLockEntry(graphicsGameMutex, e_LockAction_Unlock); // ---------- unlock ---
 
+    GetScheduler()->RegisterTaskSequence(gameSequence);
 
 
-  graphicsSequence = boost::shared_ptr<TaskSequence>(new TaskSequence("graphics", config->GetInt("graphics3d_frametime_ms", 0), true));
 
-  graphicsSequence->AddUserTaskEntry(gameTask, e_TaskPhase_Put);
+    graphicsSequence = boost::shared_ptr<TaskSequence>(new TaskSequence("graphics", config->GetInt("graphics3d_frametime_ms", 0), true));
+    // frame times like 1/144th of a second aren't a whole number of ms
+    int framerate = config->GetInt("graphics3d_framerate", 0);
+    if (framerate > 0) graphicsSequence->SetSequenceTime_us(1000000 / framerate);
 
-  //graphicsSequence->AddLockEntry(graphicsGameMutex, e_LockAction_Lock);   // ---------- lock -----
+    graphicsSequence->AddUserTaskEntry(gameTask, e_TaskPhase_Put);
 
-  graphicsSequence->AddSystemTaskEntry(graphicsSystem, e_TaskPhase_Get);
+    //graphicsSequence->AddLockEntry(graphicsGameMutex, e_LockAction_Lock);   // ---------- lock -----
 
-  //graphicsSequence->AddLockEntry(graphicsGameMutex, e_LockAction_Unlock); // ---------- unlock ---
+    graphicsSequence->AddSystemTaskEntry(graphicsSystem, e_TaskPhase_Get);
 
-  graphicsSequence->AddSystemTaskEntry(graphicsSystem, e_TaskPhase_Process);
-  graphicsSequence->AddSystemTaskEntry(graphicsSystem, e_TaskPhase_Put);
+    //graphicsSequence->AddLockEntry(graphicsGameMutex, e_LockAction_Unlock); // ---------- unlock ---
 
-  GetScheduler()->RegisterTaskSequence(graphicsSequence);
+    graphicsSequence->AddSystemTaskEntry(graphicsSystem, e_TaskPhase_Process);
+    graphicsSequence->AddSystemTaskEntry(graphicsSystem, e_TaskPhase_Put);
 
+    GetScheduler()->RegisterTaskSequence(graphicsSequence);
 
-  // fire!
 
-  Run();
+    // fire!
+
+    Run();
+
+  }
 
 
   // exit
 
-  if (SuperDebug()) scene2D->DeleteObject(debugImage);
-  if (GetDebugMode() == e_DebugMode_AI) scene2D->DeleteObject(debugOverlay);
+  if (SuperDebug() && !IsHeadless()) scene2D->DeleteObject(debugImage);
+  if (GetDebugMode() == e_DebugMode_AI && !IsHeadless()) scene2D->DeleteObject(debugOverlay);
 
   gameTask.reset();
   menuTask.reset();
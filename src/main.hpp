@@ -60,6 +60,7 @@ Properties *GetConfiguration();
 std::string GetActiveSaveDirectory();
 void SetActiveSaveDirectory(const std::string &dir);
 bool SuperDebug();
+bool IsHeadless();
 e_DebugMode GetDebugMode();
 boost::intrusive_ptr<Image2D> GetDebugImage();
 boost::intrusive_ptr<Image2D> GetDebugOverlay();
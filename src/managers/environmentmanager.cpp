@@ -13,16 +13,18 @@ namespace blunted {
 
   EnvironmentManager::EnvironmentManager() {
     quit.SetData(false);
-    startTime = boost::posix_time::microsec_clock::local_time();
+    startTime = std::chrono::steady_clock::now();
   };
 
   EnvironmentManager::~EnvironmentManager() {
   };
 
   unsigned long EnvironmentManager::GetTime_ms() {
-    boost::posix_time::ptime now = boost::posix_time::microsec_clock::local_time();
-    boost::posix_time::time_duration msdiff = now - startTime;
-    return msdiff.total_milliseconds();
+    return GetTime_us() / 1000;
+  }
+
+  unsigned long long EnvironmentManager::GetTime_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
   }
 
   void EnvironmentManager::Pause_ms(int duration) {
@@ -10,6 +10,8 @@
 #include "types/singleton.hpp"
 #include "types/lockable.hpp"
 
+#include <chrono>
+
 namespace blunted {
 
   class EnvironmentManager : public Singleton<EnvironmentManager> {
@@ -22,12 +24,13 @@ namespace blunted {
       bool GetQuit();
 
       unsigned long GetTime_ms();
+      unsigned long long GetTime_us();
       void Pause_ms(int duration);
 
     protected:
       Lockable<bool> quit;
-      unsigned long startTime_ms;
-      boost::posix_time::ptime startTime;
+      // monotonic: wall clock adjustments (ntp, dst) shouldn't make the sequences skip or stall
+      std::chrono::steady_clock::time_point startTime;
 
   };
 
@@ -7,12 +7,67 @@
 #include "framework/workerthread.hpp"
 
 #include "base/log.hpp"
+#include "base/utils.hpp"
+
+#include <boost/thread/thread.hpp>
+
+#ifndef WIN32
+#include <unistd.h>
+#endif
 
 namespace blunted {
 
   template<> TaskManager* Singleton<TaskManager>::singleton = 0;
 
-  TaskManager::TaskManager() {
+  // -1 == not one of our worker threads
+  thread_local int currentWorkerThreadIndex = -1;
+
+  // see TaskManager::ParallelFor. the job itself is handled by the calling thread, its children (helpers) by whichever workers get to them.
+  // everyone grabs chunks off the same counter until there are none left, so it doesn't matter how many helpers actually get to run
+  class ParallelForJob : public Command {
+
+    public:
+      ParallelForJob(int count, int grainSize, const boost::function<void(int, int)> &body) : Command("ParallelFor"), count(count), grainSize(grainSize), body(body), nextBegin(0) {};
+      virtual ~ParallelForJob() {};
+
+      void RunChunks() {
+        int begin = nextBegin.fetch_add(grainSize);
+        while (begin < count) {
+          body(begin, std::min(begin + grainSize, count));
+          begin = nextBegin.fetch_add(grainSize);
+        }
+      }
+
+    protected:
+      virtual bool Execute(void *caller = NULL) {
+        RunChunks();
+        return true;
+      }
+
+      int count;
+      int grainSize;
+      const boost::function<void(int, int)> &body; // lives on the caller's stack, which waits for all of us
+      std::atomic<int> nextBegin;
+
+  };
+
+  class ParallelForHelper : public Command {
+
+    public:
+      ParallelForHelper(ParallelForJob *job) : Command("ParallelForHelper"), job(job) {};
+      virtual ~ParallelForHelper() {};
+
+    protected:
+      virtual bool Execute(void *caller = NULL) {
+        job->RunChunks();
+        return true;
+      }
+
+      ParallelForJob *job; // our parent, so it outlives us
+
+  };
+
+  TaskManager::TaskManager() : idleWorkerCount(0), exiting(false), workersProcessID(0) {
   }
 
   TaskManager::~TaskManager() {
@@ -22,6 +77,13 @@ namespace blunted {
 
     int numthreads = boost::thread::hardware_concurrency();
     if (numthreads < 3) numthreads = 3; // todo: make minimum configurable
+    exiting = false;
+#ifndef WIN32
+    workersProcessID = getpid();
+#endif
+    for (int i = 0; i < numthreads; i++) {
+      deques.push_back(new WorkStealingDeque());
+    }
     for (int i = 0; i < numthreads; i++) {
       WorkerThread *worker = new WorkerThread(i);
       pool.push_back(worker);
@@ -31,23 +93,18 @@ namespace blunted {
 
   void TaskManager::EmptyQueue() {
     // wait till workqueue empty
-    while (workQueue.GetPending() > 0) {}
+    while (GetPending() > 0) {}
   }
 
   void TaskManager::Exit() {
     EmptyQueue();
 
-    // gracefully shutdown threads
-    int poolSize = pool.size();
-    for (int i = 0; i < poolSize; i++) {
-      boost::intrusive_ptr<Message_Shutdown> shutdown(new Message_Shutdown());
-      workQueue.PushMessage(shutdown);
-      //printf("waiting for wait\n");
-      shutdown->Wait();
-      //printf("ready waiting\n");
-    }
+    // gracefully shutdown threads: they leave as soon as they run out of work
+    exiting = true;
+    NotifyWorkers();
 
     // then STRIKE THEM DOWN WITH FURIOUS ANGER
+    int poolSize = pool.size();
     for (int i = 0; i < poolSize; i++) {
       pool.at(i)->Join();
       // raAAAH!!
@@ -56,13 +113,32 @@ namespace blunted {
 
     pool.clear();
 
-    if (workQueue.GetPending() > 0) Log(e_FatalError, "TaskManager", "Exit", workQueue.GetPending() + " messages left on quit!");
+    if (GetPending() > 0) Log(e_FatalError, "TaskManager", "Exit", int_to_str(GetPending()) + " messages left on quit!");
+
+    for (unsigned int i = 0; i < deques.size(); i++) {
+      delete deques.at(i);
+    }
+    deques.clear();
+  }
+
+  void TaskManager::DetachWorkers() {
+    // leaked on purpose: their thread handles refer to threads of the parent, and anything still queued is the parent's work
+    pool.clear();
+    deques.clear();
   }
 
   int TaskManager::GetWorkerThreadCount() {
     return pool.size();
   }
 
+  bool TaskManager::HasLiveWorkers() {
+    if (pool.empty()) return false;
+#ifndef WIN32
+    if (getpid() != workersProcessID) return false;
+#endif
+    return true;
+  }
+
   e_ThreadState TaskManager::GetWorkerThreadState(int workerThreadIndex) {
     return pool.at(workerThreadIndex)->GetState();
   }
@@ -72,28 +148,133 @@ namespace blunted {
   }
 
   void TaskManager::EnqueueWork(boost::intrusive_ptr<Command> message, bool notify) { // ATOMIC
-    if (pool.size() > 0) {
+    // without anyone to pick it up, queued work would never run
+    if (HasLiveWorkers()) {
 
-      if (workQueue.GetPending() > 50) {
-        Log(e_Warning, "TaskManager", "EnqueueWork", "Too much work to do! Blocking for 1 ms!");
-        while (workQueue.GetPending() > 0) {
-          EnvironmentManager::GetInstance().Pause_ms(1);
+      if (currentWorkerThreadIndex != -1) {
+        // no locks, no allocation (mostly)
+        deques.at(currentWorkerThreadIndex)->Push(message);
+      } else {
+        if (workQueue.GetPending() > 50) {
+          Log(e_Warning, "TaskManager", "EnqueueWork", "Too much work to do! Blocking for 1 ms!");
+          while (workQueue.GetPending() > 0) {
+            EnvironmentManager::GetInstance().Pause_ms(1);
+          }
         }
+        workQueue.PushMessage(message, false);
       }
-      workQueue.PushMessage(message, notify);
+
+      if (notify) NotifyWorkers(e_NotificationSubject_One);
+
     } else {
       message->Handle(this);
       message.reset();
     }
   }
 
-  // todo: won't work optimally with multiple threads notifying
   void TaskManager::NotifyWorkers(e_NotificationSubject notificationSubject) {
-    workQueue.NotifyWaiting(notificationSubject);
+    // pairs with the idleWorkerCount increment in WaitForWork: either the worker sees our work on its recheck, or we see it's idle
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (idleWorkerCount.load() == 0 && !exiting) return;
+
+    boost::mutex::scoped_lock lock(idleMutex);
+    if (notificationSubject == e_NotificationSubject_One) workAvailable.notify_one();
+    if (notificationSubject == e_NotificationSubject_All) workAvailable.notify_all();
+  }
+
+  boost::intrusive_ptr<Command> TaskManager::FindWork(int workerThreadIndex) {
+    boost::intrusive_ptr<Command> work = deques.at(workerThreadIndex)->Pop();
+    if (work) return work;
+
+    bool isMessage = false;
+    work = workQueue.GetMessage(isMessage);
+    if (isMessage) return work;
+
+    // steal, starting at our neighbour, so not everyone goes after the same victim
+    int dequeCount = deques.size();
+    for (int i = 1; i < dequeCount; i++) {
+      work = deques.at((workerThreadIndex + i) % dequeCount)->Steal();
+      if (work) return work;
+    }
+
+    return boost::intrusive_ptr<Command>();
   }
 
-  boost::intrusive_ptr<Command> TaskManager::WaitForWork() { // ATOMIC
-    return workQueue.WaitForMessage();
+  boost::intrusive_ptr<Command> TaskManager::WaitForWork(int workerThreadIndex) { // ATOMIC
+    currentWorkerThreadIndex = workerThreadIndex;
+
+    while (true) {
+      boost::intrusive_ptr<Command> work = FindWork(workerThreadIndex);
+      if (work) return work;
+
+      // nothing to do: go idle. check once more after registering as idle, else we could sleep through an EnqueueWork
+      boost::mutex::scoped_lock lock(idleMutex);
+      idleWorkerCount++;
+      work = FindWork(workerThreadIndex);
+      if (!work && !exiting) {
+        // steal attempts may fail on a race, so don't trust an empty result forever
+        workAvailable.timed_wait(lock, boost::posix_time::milliseconds(10));
+      }
+      idleWorkerCount--;
+
+      if (work) return work;
+      if (exiting) {
+        lock.unlock();
+        work = FindWork(workerThreadIndex);
+        return work;
+      }
+    }
+  }
+
+  void TaskManager::ParallelFor(int count, int grainSize, const boost::function<void(int, int)> &body) {
+    if (count <= 0) return;
+    grainSize = std::max(grainSize, 1);
+
+    // helpers nobody picks up would leave job->Wait() below waiting forever
+    int chunkCount = (count + grainSize - 1) / grainSize;
+    int helperCount = HasLiveWorkers() ? std::min(chunkCount - 1, (int)pool.size()) : 0;
+    if (helperCount <= 0) {
+      body(0, count);
+      return;
+    }
+
+    boost::intrusive_ptr<ParallelForJob> job(new ParallelForJob(count, grainSize, body));
+    std::vector < boost::intrusive_ptr<ParallelForHelper> > helpers;
+    for (int i = 0; i < helperCount; i++) {
+      helpers.push_back(boost::intrusive_ptr<ParallelForHelper>(new ParallelForHelper(job.get())));
+      job->AddChild(helpers.back());
+    }
+    for (int i = 0; i < helperCount; i++) {
+      EnqueueWork(helpers.at(i), false);
+    }
+    NotifyWorkers(helperCount == 1 ? e_NotificationSubject_One : e_NotificationSubject_All);
+
+    // do our share, then wait for the chunks still in progress elsewhere (helpers that start after the last chunk is gone just finish)
+    job->Handle();
+
+    // a worker waiting on its own deque would wait forever if nobody else is free to steal from it: take back the helpers nobody started yet.
+    // (only ours, they're on top. anything below is none of our business; it could be waiting on a lock we're holding)
+    if (currentWorkerThreadIndex != -1) {
+      for (int i = 0; i < helperCount; i++) {
+        boost::intrusive_ptr<Command> work = deques.at(currentWorkerThreadIndex)->Pop();
+        if (!work) break;
+        if (std::find(helpers.begin(), helpers.end(), work) == helpers.end()) {
+          deques.at(currentWorkerThreadIndex)->Push(work);
+          break;
+        }
+        work->Handle(this);
+      }
+    }
+
+    job->Wait();
+  }
+
+  int TaskManager::GetPending() {
+    int pending = workQueue.GetPending();
+    for (unsigned int i = 0; i < deques.size(); i++) {
+      pending += deques.at(i)->GetPending();
+    }
+    return pending;
   }
 
 }
@@ -12,6 +12,11 @@
 #include "systems/isystemtask.hpp"
 #include "base/properties.hpp"
 
+#include "types/workstealingdeque.hpp"
+
+#include <atomic>
+#include <boost/function.hpp>
+
 namespace blunted {
 
   class WorkerThread;
@@ -31,22 +36,44 @@ namespace blunted {
       /// gracefully exit and then kill worker threads
       void Exit();
 
+      /// for a fork()ed child: forgets the workers, which don't exist there, without touching their threads, queues or locks
+      /// (one of them may have held a lock at the moment of the fork). from then on everything runs on the calling thread
+      void DetachWorkers();
+
       int GetWorkerThreadCount();
+      /// false when there are none, or when we're in a fork()ed copy of the process that started them (only the forking thread lives on there)
+      bool HasLiveWorkers();
       e_ThreadState GetWorkerThreadState(int workerThreadIndex);
       void GetFullWorkerThreadState(int workerThreadIndex, e_ThreadState &state, std::string &commandName);
 
-      /// insert a message in the workQueue
+      /// insert a message: worker threads push onto their own deque, other threads onto the shared workQueue
       void EnqueueWork(boost::intrusive_ptr<Command> message, bool notify = true); // ATOMIC
 
       void NotifyWorkers(e_NotificationSubject notificationSubject = e_NotificationSubject_All);
 
-      /// wait on a new workQueue item
-      boost::intrusive_ptr<Command> WaitForWork(); // ATOMIC
+      /// wait on new work for this worker: own deque first, then the shared workQueue, then steal from the others. returns 0 on exit
+      boost::intrusive_ptr<Command> WaitForWork(int workerThreadIndex); // ATOMIC
+
+      /// calls body(begin, end) on chunks of [0, count), of at most grainSize each, spread over the workers and the calling thread.
+      /// returns once all chunks are done. chunks may run in any order, on any thread
+      void ParallelFor(int count, int grainSize, const boost::function<void(int, int)> &body);
+
+      int GetPending();
 
     protected:
+      boost::intrusive_ptr<Command> FindWork(int workerThreadIndex);
+
       MessageQueue < boost::intrusive_ptr<Command> > workQueue;
+      std::vector<WorkStealingDeque*> deques; // [worker thread]
       std::vector<WorkerThread*> pool;
 
+      // idle workers sleep on this
+      boost::mutex idleMutex;
+      boost::condition workAvailable;
+      std::atomic<int> idleWorkerCount;
+      std::atomic<bool> exiting;
+
+      int workersProcessID; // the process the workers were started in
 
   };
 
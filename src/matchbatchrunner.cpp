@@ -0,0 +1,158 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#include "matchbatchrunner.hpp"
+
+#include "managers/environmentmanager.hpp"
+#include "managers/taskmanager.hpp"
+
+#include "base/log.hpp"
+#include "base/utils.hpp"
+
+#include <boost/thread.hpp>
+
+#include <fstream>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+  // lives in memory shared between the parent and all workers
+  struct BatchState {
+    volatile int nextMatchIndex;
+  };
+
+}
+
+MatchBatchRunner::MatchBatchRunner(const Properties &config) : HeadlessRunner(config) {
+  workerCount = config.GetInt("headless_workers", 0);
+  if (workerCount <= 0) workerCount = std::max((int)boost::thread::hardware_concurrency(), 1);
+  workerCount = std::min(workerCount, std::max(matchCount, 1));
+  resultsFilename = config.Get("headless_results", "");
+}
+
+MatchBatchRunner::~MatchBatchRunner() {
+}
+
+void MatchBatchRunner::Run() {
+
+#ifdef WIN32
+  // no fork() here; run them one after another
+  HeadlessRunner::Run();
+  return;
+#else
+
+  Log(e_Notice, "MatchBatchRunner", "Run", "Running " + int_to_str(matchCount) + " headless match(es) on " + int_to_str(workerCount) + " worker(s)");
+
+  // load before forking, so all workers share the same pages
+  LoadAnims();
+
+  size_t sharedSize = sizeof(BatchState) + sizeof(HeadlessMatchResult) * matchCount + sizeof(bool) * matchCount;
+  void *shared = mmap(0, sharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (shared == MAP_FAILED) Log(e_FatalError, "MatchBatchRunner", "Run", "Could not map shared result memory");
+
+  BatchState *state = static_cast<BatchState*>(shared);
+  HeadlessMatchResult *results = reinterpret_cast<HeadlessMatchResult*>(state + 1);
+  bool *done = reinterpret_cast<bool*>(results + matchCount);
+  state->nextMatchIndex = 0;
+  for (int i = 0; i < matchCount; i++) {
+    results[i] = HeadlessMatchResult();
+    done[i] = false;
+  }
+
+  // don't let the workers inherit (and flush twice) buffered output
+  fflush(stdout);
+  fflush(stderr);
+
+  unsigned long startTime_ms = EnvironmentManager::GetInstance().GetTime_ms();
+
+  std::vector<pid_t> workers;
+  for (int w = 0; w < workerCount; w++) {
+    pid_t pid = fork();
+    if (pid < 0) {
+      Log(e_Error, "MatchBatchRunner", "Run", "Could not fork worker " + int_to_str(w));
+      break;
+    }
+    if (pid == 0) {
+      // worker. only this thread survives the fork, the task manager's threads don't. the matches run on this thread only then;
+      // there's a worker process per core anyway
+      TaskManager::GetInstance().DetachWorkers();
+      while (true) {
+        int matchIndex = __sync_fetch_and_add(&state->nextMatchIndex, 1);
+        if (matchIndex >= matchCount) break;
+        results[matchIndex] = RunMatch(matchIndex);
+        __sync_synchronize();
+        done[matchIndex] = true;
+      }
+      fflush(stdout);
+      // skip atexit handlers and singleton destructors, they belong to the parent
+      _exit(0);
+    }
+    workers.push_back(pid);
+  }
+
+  // no workers at all? do it ourselves
+  if (workers.empty()) {
+    for (int i = 0; i < matchCount; i++) {
+      results[i] = RunMatch(i);
+      done[i] = true;
+    }
+  }
+
+  for (unsigned int w = 0; w < workers.size(); w++) {
+    int status = 0;
+    waitpid(workers[w], &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      Log(e_Error, "MatchBatchRunner", "Run", "Worker " + int_to_str(w) + " did not finish cleanly");
+    }
+  }
+
+  unsigned long wallTime_ms = EnvironmentManager::GetInstance().GetTime_ms() - startTime_ms;
+
+  unsigned long totalTicks = 0;
+  int finishedCount = 0;
+  for (int i = 0; i < matchCount; i++) {
+    if (!done[i]) {
+      printf("headless match %i: did not finish\n", i);
+      continue;
+    }
+    totalTicks += results[i].ticks;
+    finishedCount++;
+    PrintResult(i, results[i]);
+  }
+
+  WriteResults(results, done);
+
+  printf("headless: %i of %i matches finished on %i worker(s)\n", finishedCount, matchCount, (int)workers.size());
+  // ticks summed over all workers against batch wall time, so this is the throughput of the whole machine
+  PrintSummary(totalTicks, wallTime_ms);
+
+  munmap(shared, sharedSize);
+
+#endif
+}
+
+void MatchBatchRunner::WriteResults(const HeadlessMatchResult *results, const bool *done) const {
+  if (resultsFilename.empty()) return;
+
+  std::ofstream file(resultsFilename.c_str(), std::ios::out | std::ios::trunc);
+  if (!file.is_open()) {
+    Log(e_Error, "MatchBatchRunner", "WriteResults", "Could not open " + resultsFilename);
+    return;
+  }
+
+  file << "match,team1,team2,goals1,goals2,shots1,shots2,possession1_ms,possession2_ms,ticks,walltime_ms,skinning_us\n";
+  for (int i = 0; i < matchCount; i++) {
+    if (!done[i]) continue;
+    const HeadlessMatchResult &result = results[i];
+    file << i << "," << result.teamDatabaseID[0] << "," << result.teamDatabaseID[1] << ","
+         << result.goals[0] << "," << result.goals[1] << "," << result.shots[0] << "," << result.shots[1] << ","
+         << result.possession_ms[0] << "," << result.possession_ms[1] << "," << result.ticks << "," << result.wallTime_ms << "," << result.skinningTime_us << "\n";
+  }
+  file.close();
+}
@@ -0,0 +1,32 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_FOOTBALL_MATCHBATCHRUNNER
+#define _HPP_FOOTBALL_MATCHBATCHRUNNER
+
+#include "headlessrunner.hpp"
+
+// runs a batch of headless matches on all cores.
+// the match code leans on process-wide singletons (environment, config, db, scene, random generators), so matches can't share
+// a process. instead, the animations are loaded once and a worker process is forked per core: the animation collection is then
+// shared copy-on-write, read-only. workers grab the next match index from a shared counter until the batch is done, so fast
+// workers pick up the slack of slow ones. results are collected in shared memory and written in match order.
+// config keys (on top of the HeadlessRunner ones): headless_workers (0 == one per core), headless_results (csv filename, optional)
+class MatchBatchRunner : public HeadlessRunner {
+
+  public:
+    MatchBatchRunner(const Properties &config);
+    virtual ~MatchBatchRunner();
+
+    virtual void Run();
+
+  protected:
+    void WriteResults(const HeadlessMatchResult *results, const bool *done) const;
+
+    int workerCount;
+    std::string resultsFilename;
+
+};
+
+#endif
@@ -181,7 +181,7 @@ Vector3 AI_GetAdaptedFormationPosition(Match *match, Player *player, float backX
   return position;
 }
 
-float AI_CalculatePassingOdds(Match *match, const Vector3 &origin, const Vector3 &target, const std::vector<PlayerImage> &opponentPlayerImages) {
+float AI_CalculatePassingOdds(Match *match, const Vector3 &origin, const Vector3 &target, const PlayerImages &opponentPlayerImages) {
   float currentOdds = 1.0;
 
   // draw imaginary line between this and target player
@@ -209,7 +209,7 @@ float AI_CalculatePassingOdds(Match *match, const Vector3 &origin, const Vector3
   return currentOdds;
 }
 
-float AI_CalculatePassingOdds(Match *match, PlayerImage thisPlayerImage, PlayerImage targetPlayerImage, const std::vector<PlayerImage> &opponentPlayerImages) {
+float AI_CalculatePassingOdds(Match *match, PlayerImage thisPlayerImage, PlayerImage targetPlayerImage, const PlayerImages &opponentPlayerImages) {
 
   // player position predictions
   thisPlayerImage.position = thisPlayerImage.position + thisPlayerImage.directionVec * thisPlayerImage.velocity * 0.1;
@@ -226,10 +226,10 @@ void AI_GetPassRatings(Match *match, int thisPlayerID, const MentalImage *mental
 
   PlayerImage thisPlayerImage = mentalImage->GetPlayerImage(thisPlayerID);
 
-  std::vector<PlayerImage> playerImages;
+  PlayerImages playerImages(TickArena::GetCurrent());
   mentalImage->GetTeamPlayerImages(match->GetPlayer(thisPlayerID)->GetTeamID(), thisPlayerID, playerImages);
 
-  std::vector<PlayerImage> opponentPlayerImages;
+  PlayerImages opponentPlayerImages(TickArena::GetCurrent());
   mentalImage->GetTeamPlayerImages(abs(teamID - 1), -1, opponentPlayerImages);
   for (int i = 0; i < (signed int)opponentPlayerImages.size(); i++) {
     opponentPlayerImages.at(i).position = opponentPlayerImages.at(i).position + opponentPlayerImages.at(i).directionVec * opponentPlayerImages.at(i).velocity * 0.3; // situation in half a second
@@ -273,7 +273,7 @@ float AI_GetSituationRating(Match *match, int thisPlayerID, const MentalImage *m
 
   PlayerImage thisPlayerImage = mentalImage->GetPlayerImage(thisPlayerID);
 
-  std::vector<PlayerImage> opponentPlayerImages;
+  PlayerImages opponentPlayerImages(TickArena::GetCurrent());
   mentalImage->GetTeamPlayerImages(abs(match->GetPlayer(thisPlayerID)->GetTeamID() - 1), -1, opponentPlayerImages);
 
   // player position predictions
@@ -307,7 +307,7 @@ float AI_CalculateFreeSpace(Match *match, const MentalImage *mentalImage, int te
 
   float currentSituation = 0.0f;
 
-  std::vector<PlayerImage> opponentPlayerImages;
+  PlayerImages opponentPlayerImages(TickArena::GetCurrent());
   mentalImage->GetTeamPlayerImages(abs(teamID - 1), -1, opponentPlayerImages);
 
   // player position predictions
@@ -334,7 +334,7 @@ float AI_GetOffsideLine(Match *match, const MentalImage *mentalImage, int teamID
 
   signed int side = match->GetTeam(teamID)->GetSide();
 
-  std::vector<PlayerImage> opponentPlayerImages;
+  PlayerImages opponentPlayerImages(TickArena::GetCurrent());
   mentalImage->GetTeamPlayerImages(teamID, -1, opponentPlayerImages);
 
   int dudDeepestOpponent = 0;
@@ -386,12 +386,10 @@ void AI_GetBestDribbleMovement(Match *match, int thisPlayerID, const MentalImage
 
   float future_sec = 0.25f;
 
-  PlayerImage thisPlayerImage = mentalImage->GetPlayerImage(thisPlayerID);
-
   Team *team = player->GetTeam();
   signed int side = team->GetSide();
 
-  std::vector<PlayerImage> opponentPlayerImages;
+  PlayerImages opponentPlayerImages(TickArena::GetCurrent());
 
   std::vector<Player*> opponents;
   AI_GetClosestPlayers(match->GetTeam(abs(team->GetID() - 1)), myPos, false, opponents, 5);
@@ -944,7 +942,6 @@ bool AI_HasPossession(Ball *ball, Player *player) {
   // premature optimization ;)
   if ((player->GetPosition() - ball->Predict(0)).GetLength() > 5.0) return false;
 
-  Vector3 ballMovement = ball->GetMovement();
   if (fabs(ball->Predict(0).coords[2]) > 0.5) return false;
 
 
@@ -1133,7 +1130,7 @@ void AI_GetPass(Player *player, e_FunctionType passType, const Vector3 &inputDir
   Vector3 manualTarget = playerPos + inputDirection * clamp(inputPower * 60.0f, 1.0f, 100.0f);
   //if (player->GetDebug()) SetGreenDebugPilon(manualTarget);
 
-  std::vector<Player*> players;
+  TickVector<Player*> players(TickArena::GetCurrent());
   player->GetTeam()->GetActivePlayers(players);
 
   if (players.size() < 2) {
@@ -28,8 +28,8 @@ struct TimeNeeded {
 
 Vector3 AI_GetAdaptedInitialPos(Match *match, const Vector3 &initialPosition, Vector3 focusPoint = Vector3(0, 0, -100.0), float ballMagnetDistance = 50.0, float ballMagnetDistancePow = 1.5);
 Vector3 AI_GetAdaptedFormationPosition(Match *match, Player *player, float backXBound, float frontXBound, float lowYBound, float highYBound, float xFocus, float xFocusStrength, float yFocus, float yFocusStrength, const Vector3 &microFocus, float microFocusStrength, float midfieldFocus, float midfieldFocusStrength, bool useDynamicFormationPosition = true);
-float AI_CalculatePassingOdds(Match *match, const Vector3 &origin, const Vector3 &target, const std::vector<PlayerImage> &opponentPlayerImages);
-float AI_CalculatePassingOdds(Match *match, PlayerImage thisPlayerImage, PlayerImage targetPlayerImage, const std::vector<PlayerImage> &opponentPlayerImages);
+float AI_CalculatePassingOdds(Match *match, const Vector3 &origin, const Vector3 &target, const PlayerImages &opponentPlayerImages);
+float AI_CalculatePassingOdds(Match *match, PlayerImage thisPlayerImage, PlayerImage targetPlayerImage, const PlayerImages &opponentPlayerImages);
 void AI_GetPassRatings(Match *match, int thisPlayerID, const MentalImage *mentalImage, float opportunism, PassRatings &passRatings);
 float AI_GetSituationRating(Match *match, int thisPlayerID, const MentalImage *mentalImage);
 float AI_CalculateFreeSpace(Match *match, const MentalImage *mentalImage, int teamID, const Vector3 &focusPos, float safeDistance = 8.0, float futureTime_sec = 0.3, bool ignoreKeeper = false);
@@ -10,72 +10,82 @@ MentalImage::MentalImage(Match *match) : match(match) {
   timeStampNeg_ms = 0;
   maxDistanceDeviation = 2.5f; // if reality is this much (or more) off from mental image, enforce as maximum offset
   maxMovementDeviation = walkVelocity;
+
+  players.resize(match->GetPlayerSlotCount());
+  for (unsigned int slot = 0; slot < players.size(); slot++) {
+    players[slot].player = 0;
+  }
 }
 
 MentalImage::~MentalImage() {
 }
 
 void MentalImage::TakeSnapshot() {
-  players.clear();
-
-  std::vector<Player*> allPlayers;
-  match->GetTeam(0)->GetActivePlayers(allPlayers);
-  match->GetTeam(1)->GetActivePlayers(allPlayers);
-
-  for (int playerCounter = 0; playerCounter < (signed int)allPlayers.size(); playerCounter++) {
-
-    Player *player = allPlayers.at(playerCounter);
-
-    PlayerImage playerImage;
-    playerImage.teamID = player->GetTeamID();
-    playerImage.side = player->GetTeam()->GetSide();
-    playerImage.playerID = player->GetID();
-    playerImage.player = player;
-    playerImage.position = player->GetPosition();
-    playerImage.directionVec = player->GetDirectionVec();
-    playerImage.bodyDirectionVec = player->GetBodyDirectionVec();
-    playerImage.velocity = player->GetFloatVelocity();
-    playerImage.movement = player->GetMovement();
-    playerImage.formationEntry = player->GetFormationEntry();
-    playerImage.dynamicFormationEntry = player->GetDynamicFormationEntry();
-    players.push_back(playerImage);
+  // may be a recycled image, so start out like a new one
+  timeStampNeg_ms = 0;
+
+  // slots run through team 0's players, then team 1's, so the active ones come out in GetActivePlayers order
+  int slot = 0;
+  for (int teamID = 0; teamID < 2; teamID++) {
+
+    const std::vector<Player*> &allPlayers = match->GetTeam(teamID)->GetAllPlayers();
+
+    for (unsigned int playerCounter = 0; playerCounter < allPlayers.size(); playerCounter++, slot++) {
+
+      Player *player = allPlayers.at(playerCounter);
+      PlayerImage &playerImage = players.at(slot);
+
+      if (!player->IsActive()) {
+        playerImage.player = 0;
+        continue;
+      }
+
+      playerImage.teamID = player->GetTeamID();
+      playerImage.side = player->GetTeam()->GetSide();
+      playerImage.playerID = player->GetID();
+      playerImage.player = player;
+      playerImage.position = player->GetPosition();
+      playerImage.directionVec = player->GetDirectionVec();
+      playerImage.bodyDirectionVec = player->GetBodyDirectionVec();
+      playerImage.velocity = player->GetFloatVelocity();
+      playerImage.movement = player->GetMovement();
+      playerImage.formationEntry = player->GetFormationEntry();
+      playerImage.dynamicFormationEntry = player->GetDynamicFormationEntry();
+    }
   }
 
   UpdateBallPredictions();
 }
 
-PlayerImage MentalImage::GetPlayerImage(int playerID) const {
+PlayerImage MentalImage::GetExtrapolatedPlayerImage(const PlayerImage &playerImage) const {
+  PlayerImage newImage = playerImage;
+  Vector3 extrapolation = playerImage.movement * GetTimeStampNeg_ms() * 0.001f;
+  newImage.position = playerImage.position + extrapolation;
+  newImage.position = newImage.position.EnforceMaximumDeviation(newImage.player->GetPosition(), maxDistanceDeviation);
+  newImage.movement = newImage.movement.EnforceMaximumDeviation(newImage.player->GetMovement(), maxMovementDeviation);
+  return newImage;
+}
 
-  for (unsigned int playerCounter = 0; playerCounter < players.size(); playerCounter++) {
+PlayerImage MentalImage::GetPlayerImage(int playerID) const {
 
-    if (players.at(playerCounter).playerID == playerID) {
-      PlayerImage newImage = players.at(playerCounter);
-      Vector3 extrapolation = players.at(playerCounter).movement * GetTimeStampNeg_ms() * 0.001f;
-      newImage.position = players.at(playerCounter).position + extrapolation;
-      newImage.position = newImage.position.EnforceMaximumDeviation(newImage.player->GetPosition(), maxDistanceDeviation);
-      newImage.movement = newImage.movement.EnforceMaximumDeviation(newImage.player->GetMovement(), maxMovementDeviation);
-      return newImage;
-    }
+  int slot = match->GetPlayerSlot(playerID);
+  if (slot != -1 && players.at(slot).player != 0) {
+    return GetExtrapolatedPlayerImage(players.at(slot));
   }
 
-  // failsafe
+  // failsafe: first active player
+  for (unsigned int i = 0; i < players.size(); i++) {
+    if (players.at(i).player != 0) return players.at(i);
+  }
   return players.at(0);
 }
 
-void MentalImage::GetTeamPlayerImages(int teamID, int exceptPlayerID, std::vector<PlayerImage> &playerImages) const {
-  for (unsigned int playerCounter = 0; playerCounter < players.size(); playerCounter++) {
-    //printf("playercounter: %i\n", playerCounter);
-    //printf("active players size: %i\n", players.size());
-    //printf("player id: %i\n", players.at(playerCounter).playerID);
-    Player *player = match->GetPlayer(players.at(playerCounter).playerID);
-    assert(player);
+void MentalImage::GetTeamPlayerImages(int teamID, int exceptPlayerID, PlayerImages &playerImages) const {
+  for (unsigned int slot = 0; slot < players.size(); slot++) {
+    Player *player = players.at(slot).player;
+    if (!player) continue;
     if (player->IsActive() && player->GetTeamID() == teamID && player->GetID() != exceptPlayerID) {
-      PlayerImage newImage = players.at(playerCounter);
-      Vector3 extrapolation = players.at(playerCounter).movement * GetTimeStampNeg_ms() * 0.001f;
-      newImage.position = players.at(playerCounter).position + extrapolation;
-      newImage.position = newImage.position.EnforceMaximumDeviation(newImage.player->GetPosition(), maxDistanceDeviation);
-      newImage.movement = newImage.movement.EnforceMaximumDeviation(newImage.player->GetMovement(), maxMovementDeviation); // new
-      playerImages.push_back(newImage);
+      playerImages.push_back(GetExtrapolatedPlayerImage(players.at(slot)));
     }
   }
 }
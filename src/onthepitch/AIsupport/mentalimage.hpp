@@ -24,7 +24,7 @@ class MentalImage {
     void TakeSnapshot();
 
     PlayerImage GetPlayerImage(int playerID) const;
-    void GetTeamPlayerImages(int teamID, int exceptPlayerID, std::vector<PlayerImage> &playerImages) const;
+    void GetTeamPlayerImages(int teamID, int exceptPlayerID, PlayerImages &playerImages) const;
 
     void UpdateBallPredictions();
     Vector3 GetBallPrediction(unsigned int time_ms) const;
@@ -33,8 +33,11 @@ class MentalImage {
     int GetTimeStampNeg_ms() const { return timeStampNeg_ms; }
 
   protected:
+    PlayerImage GetExtrapolatedPlayerImage(const PlayerImage &playerImage) const;
+
     Match *match;
 
+    // [match player slot], allocated once and overwritten by every snapshot. player == 0 means not active at snapshot time
     std::vector<PlayerImage> players;
     Vector3 ballPredictions[ballPredictionSize_ms / 10];
 
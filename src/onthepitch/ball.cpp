@@ -13,6 +13,8 @@
 #include "managers/usereventmanager.hpp"
 #include "managers/resourcemanagerpool.hpp"
 
+#include "base/profiler.hpp"
+
 #include "scene/resources/soundbuffer.hpp"
 
 #include "match.hpp"
@@ -31,6 +33,9 @@ Ball::Ball(Match *match) : match(match) {
 
   ballTouchesNet = false;
 
+  predictionCacheValid = false;
+  verifyPredictionCache = GetConfiguration()->GetBool("ball_prediction_verify", false);
+
   scene3D = GetScene3D();
 
   Log(e_Notice, "Ball", "Ball", "Loading ball object");
@@ -73,6 +78,8 @@ Ball::Ball(Match *match) : match(match) {
 }
 
 Ball::~Ball() {
+  Log(e_Notice, "Ball", "~Ball", "Prediction: " + int_to_str(predictionStats.ticks) + " runs, " + int_to_str(predictionStats.fullPredictions) + " full, " +
+                                 real_to_str(predictionStats.steps / (float)std::max(predictionStats.ticks, 1ul)) + " steps per run on average");
   match->GetDynamicNode()->DeleteNode(ballNode);
   scene3D->DeleteObject(sound);
   scene3D->DeleteObject(goalpostsound);
@@ -94,6 +101,7 @@ void Ball::Touch(const Vector3 &target) {
   std::cout << "[BALL TOUCH] Ball touched with force: " << target.GetLength() << std::endl;
 
   if (positionBuffer.coords[2] < 0.11f) positionBuffer.coords[2] = 0.11f;
+  predictionCacheValid = false;
 
   SetMomentum(target);
 
@@ -106,6 +114,7 @@ void Ball::Touch(const Vector3 &target) {
 }
 
 void Ball::SetPosition(const Vector3 &target) {
+  predictionCacheValid = false;
   positionBuffer.Set(target);
   momentum.Set(0);
   SetRotation(0, 0, 0, 1.0);
@@ -115,6 +124,7 @@ void Ball::SetPosition(const Vector3 &target) {
 }
 
 void Ball::SetMomentum(const Vector3 &target) {
+  predictionCacheValid = false;
   momentum.Set(target);
   CalculatePrediction();
 }
@@ -129,6 +139,7 @@ void Ball::SetRotation(radian x, radian y, radian z, float bias) { // radians pe
 
   Quaternion tmpRotation_ms = rotX * rotY * rotZ;
   rotation_ms = rotation_ms.GetSlerped(bias, tmpRotation_ms);
+  predictionCacheValid = false;
 
   CalculatePrediction();
 }
@@ -137,406 +148,456 @@ void Ball::SetRotation(const Vector3 &rot, float bias) { // radians per second f
   SetRotation(rot.coords[0], rot.coords[1], rot.coords[2], bias);
 }
 
+bool IsSamePredictionState(const BallPredictionState &state1, const BallPredictionState &state2) {
+  if (state1.position != state2.position || state1.momentum != state2.momentum) return false;
+  for (int i = 0; i < 4; i++) {
+    if (state1.rotation_ms.elements[i] != state2.rotation_ms.elements[i] ||
+        state1.orientation.elements[i] != state2.orientation.elements[i]) return false;
+  }
+  return true;
+}
+
 BallSpatialInfo Ball::CalculatePrediction() {
 
-  Vector3 newMomentum;
-  Quaternion newRotation_ms;
+  PROFILE_ZONE("Ball::CalculatePrediction");
 
+  // first step, from the current ball state. this is the only step that checks for woodwork and netting contact
 
-  // fill predictions
+  BallPredictionState current;
+  current.position = positionBuffer;
+  current.momentum = momentum;
+  current.rotation_ms = rotation_ms;
+  current.orientation = orientationBuffer;
 
-  Vector3 nextPos = positionBuffer;
-  Quaternion nextOrientation = orientationBuffer;
-  Vector3 momentumPredict = momentum;
-  Quaternion rotationPredict_ms = rotation_ms;
+  BallPredictionState firstStep = current;
+  bool woodwork = false;
+  bool netting = false;
+  PredictStep(firstStep, 10, woodwork, netting);
 
-  predictions[0] = nextPos;
+  ballTouchesNet = netting;
 
-  bool drag_enabled = true;
-  bool groundFriction_enabled = true;
-  bool woodwork_enabled = true;
-  bool netting_enabled = true;
-  bool groundRotationEffects_enabled = true;
-  bool swerve_enabled = true;
+  if (woodwork) {
+    goalpostsound->SetGain(clamp(firstStep.momentum.GetLength() * 0.05f, 0.01f, 1.0f) * 0.5f * GetConfiguration()->GetReal("audio_volume", 0.5f));
+    goalpostsound->Poke(e_SystemType_Audio);
+  }
 
-  float timeStep = 0.01f;//0.001f; // seconds
-  bool autoDegrade_timeStep = false;
+  predictionStats.ticks++;
+  predictionStats.steps++;
 
-  //printf("timestep: %i\n", int(timeStep * 1000.0f));
-  bool firstTime = true;
+  // if the ball is exactly where our previous first step said it would be, and it didn't touch anything this step, then
+  // the rest of the trajectory is the one we already have, only one slot further along. shift it and integrate only the new tail.
+  // (later steps never check for contact, so an untouched first step is the very same computation the previous run did for its 2nd step)
+  bool shift = predictionCacheValid && !woodwork && !netting && IsSamePredictionState(current, predictionCacheFirstStep);
 
-  ballTouchesNet = false;
+  if (shift) {
+
+    for (unsigned int i = 0; i < ballPredictionSize_ms / 10 - 1; i++) {
+      predictions[i] = predictions[i + 1];
+    }
+    bool dud1, dud2;
+    PredictStep(predictionCacheTail, ballPredictionSize_ms - 10, dud1, dud2);
+    predictions[ballPredictionSize_ms / 10 - 1] = predictionCacheTail.position;
+    predictionStats.steps++;
+
+    if (verifyPredictionCache) {
+      Vector3 verifyPredictions[ballPredictionSize_ms / 10];
+      BallPredictionState verifyTail;
+      PredictTrajectory(firstStep, verifyPredictions, verifyTail);
+      float maxError = 0.0f;
+      for (unsigned int i = 2; i < ballPredictionSize_ms / 10; i++) {
+        maxError = std::max(maxError, (verifyPredictions[i] - predictions[i]).GetLength());
+      }
+      if (maxError > 0.001f) Log(e_Warning, "Ball", "CalculatePrediction", "Shifted prediction differs from full prediction by " + real_to_str(maxError) + " meters");
+    }
+
+  } else {
 
-  for (unsigned int predictTime_ms = int(timeStep * 1000.0f); predictTime_ms < ballPredictionSize_ms; predictTime_ms += int(timeStep * 1000.0f)) {
+    predictions[0] = current.position;
+    predictions[1] = firstStep.position;
+    PredictTrajectory(firstStep, predictions, predictionCacheTail);
+    predictionStats.fullPredictions++;
+    predictionStats.steps += ballPredictionSize_ms / 10 - 2;
+
+  }
 
-    float frictionFactor = 0.0f;
+  predictionCacheFirstStep = firstStep;
+  predictionCacheValid = true;
 
+  orientPrediction = firstStep.orientation;
 
-    // gravity
+  return BallSpatialInfo(firstStep.momentum, firstStep.rotation_ms);
+}
 
-    // vz = vz0 + g * t
-    momentumPredict.coords[2] = momentumPredict.coords[2] + gravity * timeStep;
+void Ball::PredictTrajectory(const BallPredictionState &firstStep, Vector3 *target, BallPredictionState &tail) {
+  tail = firstStep;
+  bool dud1, dud2;
+  for (unsigned int predictTime_ms = 20; predictTime_ms < ballPredictionSize_ms; predictTime_ms += 10) {
+    PredictStep(tail, predictTime_ms, dud1, dud2);
+    target[predictTime_ms / 10] = tail.position;
+  }
+}
 
+void Ball::PredictStep(BallPredictionState &state, unsigned int predictTime_ms, bool &woodwork, bool &netting) {
 
-    // air resistance
+  Vector3 &nextPos = state.position;
+  Vector3 &momentumPredict = state.momentum;
+  Quaternion &rotationPredict_ms = state.rotation_ms;
 
-    float momentumVelo = momentumPredict.GetLength();
-    float momentumVeloDragged =
-        momentumVelo - drag * std::pow(momentumVelo, 2.0f) * timeStep;
-    if (drag_enabled) momentumPredict = momentumPredict.GetNormalized(0) * momentumVeloDragged;
+  bool drag_enabled = true;
+  bool groundFriction_enabled = true;
+  bool woodwork_enabled = true;
+  bool netting_enabled = true;
+  bool groundRotationEffects_enabled = true;
+  bool swerve_enabled = true;
 
+  // can't go above 0.01f, would leave open spaces in array
+  const float timeStep = 0.01f; // seconds
 
-    float ballBottom = nextPos.coords[2] - 0.11f;
-    float grassInfluenceBias = clamp(1.0f - (ballBottom / grassHeight), 0.0f, 1.0f); // 0 == no friction, 1 == all friction
-    // todo: seems to cause 'feedback' on multibump (1st bump: ball gets lots of rotation. second bump: rotation makes ball accelerate too much)
-    grassInfluenceBias = std::pow(
-        grassInfluenceBias, 0.7f);  // at half grass height, there's already a
-                                    // bigger amount of friction than 50%
-    //printf("%f\n", bias);
+  woodwork = false;
+  netting = false;
 
+  float frictionFactor = 0.0f;
 
-    // bounce
 
-    if (nextPos.coords[2] < 0.11f) {
-      if (momentumPredict.coords[2] < 0.0f) {
-        frictionFactor = NormalizedClamp(-momentumPredict.coords[2] - 0.5f, 0.0f, 12.0f); // when the ball is slammed into the ground, there's gonna be more friction. only set it here so it is only done once (on impact)
-        momentumPredict.coords[2] = -momentumPredict.coords[2] * bounce;
-        momentumPredict.coords[2] = std::max(momentumPredict.coords[2] - linearBounce, 0.0f); // linear bounce
-      }
+  // gravity
 
-      nextPos.coords[2] = 0.11f;
-    }
+  // vz = vz0 + g * t
+  momentumPredict.coords[2] = momentumPredict.coords[2] + gravity * timeStep;
 
 
-    // ground friction
+  // air resistance
 
-    if (nextPos.coords[2] < 0.11f + grassHeight && groundFriction_enabled) {
-      float adaptedFriction = (friction * grassInfluenceBias);
+  float momentumVelo = momentumPredict.GetLength();
+  float momentumVeloDragged =
+      momentumVelo - drag * std::pow(momentumVelo, 2.0f) * timeStep;
+  if (drag_enabled) momentumPredict = momentumPredict.GetNormalized(0) * momentumVeloDragged;
 
-      // v(t) = v(0) * (k ^ t)
 
-      Vector3 xy = momentumPredict.Get2D();
-      float velo = xy.GetLength();
+  float ballBottom = nextPos.coords[2] - 0.11f;
+  float grassInfluenceBias = clamp(1.0f - (ballBottom / grassHeight), 0.0f, 1.0f); // 0 == no friction, 1 == all friction
+  // todo: seems to cause 'feedback' on multibump (1st bump: ball gets lots of rotation. second bump: rotation makes ball accelerate too much)
+  grassInfluenceBias = std::pow(
+      grassInfluenceBias, 0.7f);  // at half grass height, there's already a
+                                  // bigger amount of friction than 50%
+  //printf("%f\n", bias);
 
-      float newVelo = velo - adaptedFriction * std::pow(velo, 2.0f) * timeStep;
 
-      // linear friction
-      newVelo = clamp(newVelo - (linearFriction * grassInfluenceBias * timeStep), 0.0f, 100000.0f);
+  // bounce
 
-      xy.Normalize(Vector3(0));
-      xy *= newVelo;
-      momentumPredict.coords[0] = xy.coords[0];
-      momentumPredict.coords[1] = xy.coords[1];
+  if (nextPos.coords[2] < 0.11f) {
+    if (momentumPredict.coords[2] < 0.0f) {
+      frictionFactor = NormalizedClamp(-momentumPredict.coords[2] - 0.5f, 0.0f, 12.0f); // when the ball is slammed into the ground, there's gonna be more friction. only set it here so it is only done once (on impact)
+      momentumPredict.coords[2] = -momentumPredict.coords[2] * bounce;
+      momentumPredict.coords[2] = std::max(momentumPredict.coords[2] - linearBounce, 0.0f); // linear bounce
     }
 
-    float netAbsorbInv = 0.95f;
-    float powFactor = 2.6f;
-    float powerFac = 1.8f; // lol varnames
-    float postAbsorbInv = 0.8f;
-    float ballRadius = 0.11f;
-    float postRadius = 0.07f;
+    nextPos.coords[2] = 0.11f;
+  }
 
-    netAbsorbInv = std::pow(netAbsorbInv, timeStep * 100.0f);
 
-    // woodwork
+  // ground friction
 
-    if (firstTime && woodwork_enabled) {
+  if (nextPos.coords[2] < 0.11f + grassHeight && groundFriction_enabled) {
+    float adaptedFriction = (friction * grassInfluenceBias);
 
-      bool woodwork = false;
+    // v(t) = v(0) * (k ^ t)
 
+    Vector3 xy = momentumPredict.Get2D();
+    float velo = xy.GetLength();
 
-      // posts
+    float newVelo = velo - adaptedFriction * std::pow(velo, 2.0f) * timeStep;
 
-      if (nextPos.coords[2] < goalHeight + ballRadius + postRadius && (nextPos.Get2D().GetAbsolute() - Vector3(pitchHalfW, goalHalfWidth, 0)).GetLength() < ballRadius + postRadius) {
-        Vector3 normal;
+    // linear friction
+    newVelo = clamp(newVelo - (linearFriction * grassInfluenceBias * timeStep), 0.0f, 100000.0f);
 
-        if (nextPos.coords[0] < 0) {
-          // left side of pitch
-          if (nextPos.coords[1] < 0) {
-            // 'lower' side of pitch
-            normal = (nextPos.Get2D() - Vector3(-pitchHalfW, -goalHalfWidth, 0)).GetNormalized(Vector3(1, 0, 0));
-            float nextPosZ = nextPos.coords[2];
-            nextPos = Vector3(-pitchHalfW, -goalHalfWidth, 0) + normal * (postRadius + ballRadius);
-            nextPos.coords[2] = nextPosZ;
-            woodwork = true;
+    xy.Normalize(Vector3(0));
+    xy *= newVelo;
+    momentumPredict.coords[0] = xy.coords[0];
+    momentumPredict.coords[1] = xy.coords[1];
+  }
 
-          } else {
-            // 'upper' side of pitch
-            normal = (nextPos.Get2D() - Vector3(-pitchHalfW, goalHalfWidth, 0)).GetNormalized(Vector3(1, 0, 0));
-            float nextPosZ = nextPos.coords[2];
-            nextPos = Vector3(-pitchHalfW, goalHalfWidth, 0) + normal * (postRadius + ballRadius);
-            nextPos.coords[2] = nextPosZ;
-            woodwork = true;
+  float netAbsorbInv = 0.95f;
+  float powFactor = 2.6f;
+  float powerFac = 1.8f; // lol varnames
+  float postAbsorbInv = 0.8f;
+  float ballRadius = 0.11f;
+  float postRadius = 0.07f;
 
-          }
-        } else {
-          // right side of pitch
-          if (nextPos.coords[1] < 0) {
-            // 'lower' side of pitch
-            normal = (nextPos.Get2D() - Vector3(pitchHalfW, -goalHalfWidth, 0)).GetNormalized(Vector3(-1, 0, 0));
-            float nextPosZ = nextPos.coords[2];
-            nextPos = Vector3(pitchHalfW, -goalHalfWidth, 0) + normal * (postRadius + ballRadius);
-            nextPos.coords[2] = nextPosZ;
-            woodwork = true;
-
-          } else {
-            // 'upper' side of pitch
-            normal = (nextPos.Get2D() - Vector3(pitchHalfW, goalHalfWidth, 0)).GetNormalized(Vector3(-1, 0, 0));
-            //match->SetDebugPilon(Vector3(55, 3.8, 0) + normal * 5);
-            float nextPosZ = nextPos.coords[2];
-            nextPos = Vector3(pitchHalfW, goalHalfWidth, 0) + normal * (postRadius + ballRadius);
-            nextPos.coords[2] = nextPosZ;
-            woodwork = true;
-
-          }
-        }
+  netAbsorbInv = std::pow(netAbsorbInv, timeStep * 100.0f);
 
-        momentumPredict = (momentumPredict.Get2D().GetNormalized(normal) + (normal * 1.1f)).GetNormalized() * momentumPredict.Get2D().GetLength() * postAbsorbInv + (Vector3(0, 0, 1) * momentumPredict.coords[2]);
-      }
+  // woodwork
 
+  if (predictTime_ms == 10 && woodwork_enabled) {
 
-      // crossbar
+    // posts
 
-      Vector3 nextPosXZ = nextPos * Vector3(1, 0, 1);
-      if ((nextPosXZ.GetAbsolute() - Vector3(pitchHalfW, 0, goalHeight)).GetLength() < ballRadius + postRadius &&
-          fabs(nextPos.coords[1]) < goalHalfWidth + ballRadius + postRadius) {
-        Vector3 normal;
+    if (nextPos.coords[2] < goalHeight + ballRadius + postRadius && (nextPos.Get2D().GetAbsolute() - Vector3(pitchHalfW, goalHalfWidth, 0)).GetLength() < ballRadius + postRadius) {
+      Vector3 normal;
 
-        if (nextPos.coords[0] < 0) {
-          // left side of pitch
-          normal = (nextPosXZ - Vector3(-pitchHalfW, 0, goalHeight)).GetNormalized(Vector3(0, 0, 1));
-          float nextPosY = nextPos.coords[1];
-          nextPos = Vector3(-pitchHalfW, 0, goalHeight) + normal * (postRadius + ballRadius);
-          nextPos.coords[1] = nextPosY;
+      if (nextPos.coords[0] < 0) {
+        // left side of pitch
+        if (nextPos.coords[1] < 0) {
+          // 'lower' side of pitch
+          normal = (nextPos.Get2D() - Vector3(-pitchHalfW, -goalHalfWidth, 0)).GetNormalized(Vector3(1, 0, 0));
+          float nextPosZ = nextPos.coords[2];
+          nextPos = Vector3(-pitchHalfW, -goalHalfWidth, 0) + normal * (postRadius + ballRadius);
+          nextPos.coords[2] = nextPosZ;
           woodwork = true;
 
         } else {
-          // right side of pitch
-          normal = (nextPosXZ - Vector3(pitchHalfW, 0, goalHeight)).GetNormalized(Vector3(0, 0, -1));
-          float nextPosY = nextPos.coords[1];
-          nextPos = Vector3(pitchHalfW, 0, goalHeight) + normal * (postRadius + ballRadius);
-          nextPos.coords[1] = nextPosY;
+          // 'upper' side of pitch
+          normal = (nextPos.Get2D() - Vector3(-pitchHalfW, goalHalfWidth, 0)).GetNormalized(Vector3(1, 0, 0));
+          float nextPosZ = nextPos.coords[2];
+          nextPos = Vector3(-pitchHalfW, goalHalfWidth, 0) + normal * (postRadius + ballRadius);
+          nextPos.coords[2] = nextPosZ;
           woodwork = true;
 
         }
+      } else {
+        // right side of pitch
+        if (nextPos.coords[1] < 0) {
+          // 'lower' side of pitch
+          normal = (nextPos.Get2D() - Vector3(pitchHalfW, -goalHalfWidth, 0)).GetNormalized(Vector3(-1, 0, 0));
+          float nextPosZ = nextPos.coords[2];
+          nextPos = Vector3(pitchHalfW, -goalHalfWidth, 0) + normal * (postRadius + ballRadius);
+          nextPos.coords[2] = nextPosZ;
+          woodwork = true;
+
+        } else {
+          // 'upper' side of pitch
+          normal = (nextPos.Get2D() - Vector3(pitchHalfW, goalHalfWidth, 0)).GetNormalized(Vector3(-1, 0, 0));
+          //match->SetDebugPilon(Vector3(55, 3.8, 0) + normal * 5);
+          float nextPosZ = nextPos.coords[2];
+          nextPos = Vector3(pitchHalfW, goalHalfWidth, 0) + normal * (postRadius + ballRadius);
+          nextPos.coords[2] = nextPosZ;
+          woodwork = true;
 
-        Vector3 momentumPredictXZ = momentumPredict * Vector3(1, 0, 1);
-        momentumPredict = (momentumPredictXZ.GetNormalized(normal) + (normal * 1.1f)).GetNormalized() * momentumPredictXZ.GetLength() * postAbsorbInv + (Vector3(0, 1, 0) * momentumPredict.coords[1]);
+        }
       }
 
-      if (woodwork) {
-        goalpostsound->SetGain(clamp(momentumPredict.GetLength() * 0.05f, 0.01f, 1.0f) * 0.5f * GetConfiguration()->GetReal("audio_volume", 0.5f));
-        goalpostsound->Poke(e_SystemType_Audio);
+      momentumPredict = (momentumPredict.Get2D().GetNormalized(normal) + (normal * 1.1f)).GetNormalized() * momentumPredict.Get2D().GetLength() * postAbsorbInv + (Vector3(0, 0, 1) * momentumPredict.coords[2]);
+    }
+
+
+    // crossbar
+
+    Vector3 nextPosXZ = nextPos * Vector3(1, 0, 1);
+    if ((nextPosXZ.GetAbsolute() - Vector3(pitchHalfW, 0, goalHeight)).GetLength() < ballRadius + postRadius &&
+        fabs(nextPos.coords[1]) < goalHalfWidth + ballRadius + postRadius) {
+      Vector3 normal;
+
+      if (nextPos.coords[0] < 0) {
+        // left side of pitch
+        normal = (nextPosXZ - Vector3(-pitchHalfW, 0, goalHeight)).GetNormalized(Vector3(0, 0, 1));
+        float nextPosY = nextPos.coords[1];
+        nextPos = Vector3(-pitchHalfW, 0, goalHeight) + normal * (postRadius + ballRadius);
+        nextPos.coords[1] = nextPosY;
+        woodwork = true;
+
+      } else {
+        // right side of pitch
+        normal = (nextPosXZ - Vector3(pitchHalfW, 0, goalHeight)).GetNormalized(Vector3(0, 0, -1));
+        float nextPosY = nextPos.coords[1];
+        nextPos = Vector3(pitchHalfW, 0, goalHeight) + normal * (postRadius + ballRadius);
+        nextPos.coords[1] = nextPosY;
+        woodwork = true;
+
       }
+
+      Vector3 momentumPredictXZ = momentumPredict * Vector3(1, 0, 1);
+      momentumPredict = (momentumPredictXZ.GetNormalized(normal) + (normal * 1.1f)).GetNormalized() * momentumPredictXZ.GetLength() * postAbsorbInv + (Vector3(0, 1, 0) * momentumPredict.coords[1]);
     }
 
+  }
+
 
-    // netting
+  // netting
 
-    if (predictTime_ms <= 10 && netting_enabled) {
+  if (predictTime_ms <= 10 && netting_enabled) {
 
-      bool ballIsInGoal = match->IsBallInGoal();
-      signed int inGoal = ballIsInGoal ? 1 : -1;
+    bool ballIsInGoal = match->IsBallInGoal();
+    signed int inGoal = ballIsInGoal ? 1 : -1;
 
-      bool behindBackline = fabs(nextPos.coords[0]) > pitchHalfW + 0.11f;
-      bool behindGoalBack = fabs(nextPos.coords[0]) > pitchHalfW + goalDepth + 0.11f;
-      bool beforeGoalBack = fabs(nextPos.coords[0]) < pitchHalfW + goalDepth - 0.11f;
-      bool belowGoalHeight = nextPos.coords[2] < goalHeight + 0.11f;
-      bool aboveGoalHeight = nextPos.coords[2] > goalHeight - 0.11f;
-      bool betweenGoalWidth = fabs(nextPos.coords[1]) < goalHalfWidth - 0.11f;
-      bool asideGoalWidth = fabs(nextPos.coords[1]) > goalHalfWidth + 0.11f;
+    bool behindBackline = fabs(nextPos.coords[0]) > pitchHalfW + 0.11f;
+    bool behindGoalBack = fabs(nextPos.coords[0]) > pitchHalfW + goalDepth + 0.11f;
+    bool beforeGoalBack = fabs(nextPos.coords[0]) < pitchHalfW + goalDepth - 0.11f;
+    bool belowGoalHeight = nextPos.coords[2] < goalHeight + 0.11f;
+    bool aboveGoalHeight = nextPos.coords[2] > goalHeight - 0.11f;
+    bool betweenGoalWidth = fabs(nextPos.coords[1]) < goalHalfWidth - 0.11f;
+    bool asideGoalWidth = fabs(nextPos.coords[1]) > goalHalfWidth + 0.11f;
 
 
-      // side netting
+    // side netting
 
-      if (( ballIsInGoal && !betweenGoalWidth && behindBackline)) {
+    if (( ballIsInGoal && !betweenGoalWidth && behindBackline)) {
 
-        float netDist;
-        netDist = fabs(fabs(nextPos.coords[1]) - goalHalfWidth);
-        netDist = clamp(netDist, 0, 1);
-        float power = std::pow(netDist, powFactor) *
-                      -signSide(nextPos.coords[1]) * inGoal;
+      float netDist;
+      netDist = fabs(fabs(nextPos.coords[1]) - goalHalfWidth);
+      netDist = clamp(netDist, 0, 1);
+      float power = std::pow(netDist, powFactor) *
+                    -signSide(nextPos.coords[1]) * inGoal;
 
-        // net is stuck to woodwork so lay off there
-        float woodworkTensionBiasInv = clamp((fabs(momentumPredict.coords[0]) - pitchHalfW) * 2.0f, 0.0f, 1.0f);
-        float adaptedPowerFac = powerFac + (1.0f - woodworkTensionBiasInv) * 3.0f;
+      // net is stuck to woodwork so lay off there
+      float woodworkTensionBiasInv = clamp((fabs(momentumPredict.coords[0]) - pitchHalfW) * 2.0f, 0.0f, 1.0f);
+      float adaptedPowerFac = powerFac + (1.0f - woodworkTensionBiasInv) * 3.0f;
 
-        momentumPredict.coords[1] = momentumPredict.coords[1] * netAbsorbInv + power * adaptedPowerFac * (100 * timeStep);// + -momentumPredict.coords[1] * netDist;
+      momentumPredict.coords[1] = momentumPredict.coords[1] * netAbsorbInv + power * adaptedPowerFac * (100 * timeStep);// + -momentumPredict.coords[1] * netDist;
 
-        if (predictTime_ms == 10) ballTouchesNet = true;
-      }
+      netting = true;
+    }
 
 
-      // rear netting
+    // rear netting
 
 //      if ((fabs(nextPos.coords[0]) > (pitchHalfW + 2.5) - 0.11 && ballIsInGoal)/* ||
 //          (fabs(nextPos.coords[0]) < (pitchHalfW + 2.5) + 0.11 && !ballIsInGoal) todo disabled: too hard to code :p */) {
 
-      if (( ballIsInGoal && !beforeGoalBack && behindBackline)/* ||
-          (!ballIsInGoal && !asideGoalWidth && behindBackline && !behindGoalBack && belowGoalHeight ** todo disabled: too hard to code :p */) {
+    if (( ballIsInGoal && !beforeGoalBack && behindBackline)/* ||
+        (!ballIsInGoal && !asideGoalWidth && behindBackline && !behindGoalBack && belowGoalHeight ** todo disabled: too hard to code :p */) {
 
-        float netDist;
-        netDist = fabs(fabs(nextPos.coords[0]) - (pitchHalfW + goalDepth));
-        netDist = clamp(netDist, 0, 1);
-        float power = std::pow(netDist, powFactor) *
-                      -signSide(nextPos.coords[0]) * inGoal;
-        momentumPredict.coords[0] = momentumPredict.coords[0] * netAbsorbInv + power * powerFac * (100 * timeStep);
+      float netDist;
+      netDist = fabs(fabs(nextPos.coords[0]) - (pitchHalfW + goalDepth));
+      netDist = clamp(netDist, 0, 1);
+      float power = std::pow(netDist, powFactor) *
+                    -signSide(nextPos.coords[0]) * inGoal;
+      momentumPredict.coords[0] = momentumPredict.coords[0] * netAbsorbInv + power * powerFac * (100 * timeStep);
 
-        if (predictTime_ms == 10) ballTouchesNet = true;
-      }
+      netting = true;
+    }
 
 
-      // top netting
+    // top netting
 
 //      if (((nextPos.coords[2] > 2.5 - 0.11 && ballIsInGoal)/*( ||
 //           (nextPos.coords[2] < 2.5 + 0.11 && !ballIsInGoal) todo disabled: too hard to code :p */) &&
 //          fabs(nextPos.coords[0]) > pitchHalfW) {
 
-      if (( ballIsInGoal && !belowGoalHeight && behindBackline )) { // todo: from above. so hard to code. wow.
+    if (( ballIsInGoal && !belowGoalHeight && behindBackline )) { // todo: from above. so hard to code. wow.
 
-        float netDist;
-        netDist = fabs(fabs(nextPos.coords[2]) - goalHeight);
-        netDist = clamp(netDist, 0, 1);
-        float power = std::pow(netDist, powFactor) * -inGoal;
+      float netDist;
+      netDist = fabs(fabs(nextPos.coords[2]) - goalHeight);
+      netDist = clamp(netDist, 0, 1);
+      float power = std::pow(netDist, powFactor) * -inGoal;
 
-        // net is stuck to woodwork so lay off there
-        float woodworkTensionBiasInv = clamp((fabs(momentumPredict.coords[0]) - pitchHalfW) * 2.0f, 0.0f, 1.0f);
-        float adaptedPowerFac = powerFac + (1.0f - woodworkTensionBiasInv) * 3.0f;
+      // net is stuck to woodwork so lay off there
+      float woodworkTensionBiasInv = clamp((fabs(momentumPredict.coords[0]) - pitchHalfW) * 2.0f, 0.0f, 1.0f);
+      float adaptedPowerFac = powerFac + (1.0f - woodworkTensionBiasInv) * 3.0f;
 
-        momentumPredict.coords[2] = momentumPredict.coords[2] * netAbsorbInv + power * adaptedPowerFac * (100 * timeStep);
+      momentumPredict.coords[2] = momentumPredict.coords[2] * netAbsorbInv + power * adaptedPowerFac * (100 * timeStep);
 
-        if (predictTime_ms == 10) ballTouchesNet = true;
-      }
+      netting = true;
+    }
 
-    } // </goal collisions>
+  } // </goal collisions>
 
 
-    // calculate rotation
+  // calculate rotation
 
-    if (nextPos.coords[2] < 0.11f + grassHeight && groundRotationEffects_enabled) {
+  if (nextPos.coords[2] < 0.11f + grassHeight && groundRotationEffects_enabled) {
 
 
-      // rewrite idea: find out difference in ball velo / roll velo and then change both ball velo and rot (instead of having these 2 seperate sections)
+    // rewrite idea: find out difference in ball velo / roll velo and then change both ball velo and rot (instead of having these 2 seperate sections)
 
-      // ground friction induced rotation
-      radian xR, yR;
+    // ground friction induced rotation
+    radian xR, yR;
 
-      // x movement causes roll over y axis.. so this is correct ;)
-      float radius = 0.11f;
-      xR = momentumPredict.coords[1] / radius;
-      yR = momentumPredict.coords[0] / radius;
+    // x movement causes roll over y axis.. so this is correct ;)
+    float radius = 0.11f;
+    xR = momentumPredict.coords[1] / radius;
+    yR = momentumPredict.coords[0] / radius;
 
-      // clamp, because we can not rotate faster than this or the maths don't know what direction to rotate into anymore
-      Quaternion rotX;
-      rotX.SetAngleAxis(clamp(xR * 0.001f, -pi * 0.49f, pi * 0.49f), Vector3(-1, 0, 0));
-      Quaternion rotY;
-      rotY.SetAngleAxis(clamp(yR * 0.001f, -pi * 0.49f, pi * 0.49f), Vector3(0, 1, 0));
+    // clamp, because we can not rotate faster than this or the maths don't know what direction to rotate into anymore
+    Quaternion rotX;
+    rotX.SetAngleAxis(clamp(xR * 0.001f, -pi * 0.49f, pi * 0.49f), Vector3(-1, 0, 0));
+    Quaternion rotY;
+    rotY.SetAngleAxis(clamp(yR * 0.001f, -pi * 0.49f, pi * 0.49f), Vector3(0, 1, 0));
 
-      Quaternion groundRot = rotX * rotY;
+    Quaternion groundRot = rotX * rotY;
 
-      Quaternion oldToNewRotation = rotationPredict_ms.GetRotationTo(groundRot).GetNormalized();
-      radian rotationChangePerSecond = fabs(oldToNewRotation.GetRotationAngle(QUATERNION_IDENTITY)) * 1000.0f;
+    Quaternion oldToNewRotation = rotationPredict_ms.GetRotationTo(groundRot).GetNormalized();
+    radian rotationChangePerSecond = fabs(oldToNewRotation.GetRotationAngle(QUATERNION_IDENTITY)) * 1000.0f;
 
-      radian maxRotationChangePerSecond = 1.0f * pi * grassInfluenceBias;
-      // ball slams into ground; see origin of frictionFactor variable for more clarity. this happens only once per bounce
-      // this works here because the 'if' statement is always true when frictionFactor > 0, because when then happens, nextPos.coords[2] has been set to ballRadius anyway
-      if (frictionFactor > 0.0f) {
-        maxRotationChangePerSecond += 4.0f * pi;
-      }
-      volatile radian factor = 1.0f;
-      if (rotationChangePerSecond > maxRotationChangePerSecond) {
-        factor = maxRotationChangePerSecond / rotationChangePerSecond;
-      }
-      if (factor < 1.0f) {
-        oldToNewRotation = oldToNewRotation.GetRotationMultipliedBy(factor);
-      }
+    radian maxRotationChangePerSecond = 1.0f * pi * grassInfluenceBias;
+    // ball slams into ground; see origin of frictionFactor variable for more clarity. this happens only once per bounce
+    // this works here because the 'if' statement is always true when frictionFactor > 0, because when then happens, nextPos.coords[2] has been set to ballRadius anyway
+    if (frictionFactor > 0.0f) {
+      maxRotationChangePerSecond += 4.0f * pi;
+    }
+    volatile radian factor = 1.0f;
+    if (rotationChangePerSecond > maxRotationChangePerSecond) {
+      factor = maxRotationChangePerSecond / rotationChangePerSecond;
+    }
+    if (factor < 1.0f) {
+      oldToNewRotation = oldToNewRotation.GetRotationMultipliedBy(factor);
+    }
 
-      Quaternion newRotationPredict_ms = oldToNewRotation * rotationPredict_ms;
+    Quaternion newRotationPredict_ms = oldToNewRotation * rotationPredict_ms;
 
 
-      // rotation induced ground friction
+    // rotation induced ground friction
 
-      radian x, y, z;
-      rotationPredict_ms.GetAngles(x, y, z);
-      x = -x;
+    radian x, y, z;
+    rotationPredict_ms.GetAngles(x, y, z);
+    x = -x;
 
-      // how fast the ball would move if we took 100% of its rotational velo
-      Vector3 ballRotationMomentum;
-      ballRotationMomentum.coords[0] = y * radius * 1000.0f;// * bias;
-      ballRotationMomentum.coords[1] = x * radius * 1000.0f;// * bias;
+    // how fast the ball would move if we took 100% of its rotational velo
+    Vector3 ballRotationMomentum;
+    ballRotationMomentum.coords[0] = y * radius * 1000.0f;// * bias;
+    ballRotationMomentum.coords[1] = x * radius * 1000.0f;// * bias;
 
-      // mix (not sure if mathematically correct, i think so, but maybe check out on a rainy sunday once)
-      float rotBias = 0.01f; // lower == ball is lighter. higher == pitch/ball contact seems more 'rubbery'
-      rotBias *= grassInfluenceBias;
+    // mix (not sure if mathematically correct, i think so, but maybe check out on a rainy sunday once)
+    float rotBias = 0.01f; // lower == ball is lighter. higher == pitch/ball contact seems more 'rubbery'
+    rotBias *= grassInfluenceBias;
 
-      // ball slams into ground; see origin of frictionFactor variable for more clarity. this happens only once per bounce
-      // this works here because the 'if' statement is always true when frictionFactor > 0, because when then happens, nextPos.coords[2] has been set to ballRadius anyway
-      if (frictionFactor > 0.0f) {
-        rotBias += 0.5f * frictionFactor;
-      }
-      rotBias = clamp(rotBias, 0.0f, 1.0f);
-      momentumPredict.coords[0] = momentumPredict.coords[0] * (1.0f - rotBias) + ballRotationMomentum.coords[0] * rotBias;
-      momentumPredict.coords[1] = momentumPredict.coords[1] * (1.0f - rotBias) + ballRotationMomentum.coords[1] * rotBias;
+    // ball slams into ground; see origin of frictionFactor variable for more clarity. this happens only once per bounce
+    // this works here because the 'if' statement is always true when frictionFactor > 0, because when then happens, nextPos.coords[2] has been set to ballRadius anyway
+    if (frictionFactor > 0.0f) {
+      rotBias += 0.5f * frictionFactor;
+    }
+    rotBias = clamp(rotBias, 0.0f, 1.0f);
+    momentumPredict.coords[0] = momentumPredict.coords[0] * (1.0f - rotBias) + ballRotationMomentum.coords[0] * rotBias;
+    momentumPredict.coords[1] = momentumPredict.coords[1] * (1.0f - rotBias) + ballRotationMomentum.coords[1] * rotBias;
 
 
-      // finally, add the previously calculated ground friction induced rotation
-      rotationPredict_ms = newRotationPredict_ms;
-    }
+    // finally, add the previously calculated ground friction induced rotation
+    rotationPredict_ms = newRotationPredict_ms;
+  }
 
 
-    // magnus effect (swerve)
+  // magnus effect (swerve)
 
-    if (swerve_enabled) {
-      Vector3 rotVec;
-      rotationPredict_ms.GetAngles(rotVec.coords[0], rotVec.coords[1], rotVec.coords[2]);
-      rotVec *= 10.0f;
+  if (swerve_enabled) {
+    Vector3 rotVec;
+    rotationPredict_ms.GetAngles(rotVec.coords[0], rotVec.coords[1], rotVec.coords[2]);
+    rotVec *= 10.0f;
 
-      // magnus effect has a strength curve that goes down after a certain velocity
-      float swerveAmount = NormalizedClamp(momentumPredict.GetLength(), 0.0f, 70.0f);
-      // http://www.wolframalpha.com/input/?i=sin%28x+*+pi+*+0.7%29+^+2.2+from+x+%3D+0+to+1
-      // <bazkie_drunk> ^ tnx, past myself, that's very convenient!
-      swerveAmount = pow(std::sin(swerveAmount * pi * 0.94f), 2.6f);
-      Vector3 adaptedMomentumPredict = momentumPredict.GetNormalized(0) * swerveAmount * 30.0f;
+    // magnus effect has a strength curve that goes down after a certain velocity
+    float swerveAmount = NormalizedClamp(momentumPredict.GetLength(), 0.0f, 70.0f);
+    // http://www.wolframalpha.com/input/?i=sin%28x+*+pi+*+0.7%29+^+2.2+from+x+%3D+0+to+1
+    // <bazkie_drunk> ^ tnx, past myself, that's very convenient!
+    swerveAmount = pow(std::sin(swerveAmount * pi * 0.94f), 2.6f);
+    Vector3 adaptedMomentumPredict = momentumPredict.GetNormalized(0) * swerveAmount * 30.0f;
 
-      Vector3 swerve = adaptedMomentumPredict.GetCrossProduct(-rotVec) * 1.0;
+    Vector3 swerve = adaptedMomentumPredict.GetCrossProduct(-rotVec) * 1.0;
 
-      momentumPredict += swerve * timeStep;
-    }
+    momentumPredict += swerve * timeStep;
+  }
 
 
-    // predict next ms
+  // predict next ms
 
-    nextPos += momentumPredict * timeStep;
+  nextPos += momentumPredict * timeStep;
 
+  // orientation is only used for the first step (see orientPrediction)
+  if (predictTime_ms == 10) {
     Vector3 rotationVector;
     rotationPredict_ms.GetAngles(rotationVector.coords[0], rotationVector.coords[1], rotationVector.coords[2]);
     rotationVector *= timeStep / 0.001f;
     Quaternion rotationPredictTimeStepped;
     rotationPredictTimeStepped.SetAngles(rotationVector.coords[0], rotationVector.coords[1], rotationVector.coords[2]);
 
-    nextOrientation = rotationPredictTimeStepped * nextOrientation;
-
-    if (predictTime_ms % 10 == 0) {
-
-      if (autoDegrade_timeStep) {
-        if (predictTime_ms == 100) timeStep = 0.005f;
-        if (predictTime_ms == 200) timeStep = 0.01f;
-        //if (predictTime_ms == 2000) timeStep = 0.04f; can't go above 0.01f, would leave open spaces in array
-      }
-
-      predictions[predictTime_ms / 10] = nextPos;
-    }
-
-    if (predictTime_ms == 10) {
-      newMomentum = momentumPredict;
-      newRotation_ms = rotationPredict_ms;
-      orientPrediction = nextOrientation;
-    }
-
-    firstTime = false;
+    state.orientation = rotationPredictTimeStepped * state.orientation;
   }
-
-  return BallSpatialInfo(newMomentum, newRotation_ms);
 }
 
 Vector3 Ball::GetAveragePosition(unsigned int duration_ms) const {
@@ -556,7 +617,7 @@ Vector3 Ball::GetAveragePosition(unsigned int duration_ms) const {
 void Ball::TriggerBallTouchSound(float gain) {
   float finalGain = gain * 0.6f * GetConfiguration()->GetReal("audio_volume", 0.5f);
   if (finalGain > 0.01f) {
-    sound->SetPitch(0.9f + random(0.0f, 0.2f));
+    sound->SetPitch(0.9f + soundRandomStream.Get(0.0f, 0.2f));
     sound->SetGain(finalGain);
     sound->Poke(e_SystemType_Audio);
   }
@@ -581,8 +642,6 @@ void Ball::Process() {
   ballPosHistory.push_back(positionBuffer);
   if (ballPosHistory.size() > ballHistorySize_ms) ballPosHistory.pop_front();
 
-  Vector3 changedMomentum = momentum - previousMomentum;
-
   previousMomentum = momentum;
   previousPosition = positionBuffer;
 }
@@ -615,4 +674,5 @@ void Ball::ResetSituation(const Vector3 &focusPos) {
   positionBuffer = Vector3(focusPos + Vector3(0, 0, 0.11));
   orientationBuffer = QUATERNION_IDENTITY;
   ballTouchesNet = false;
+  predictionCacheValid = false;
 }
@@ -40,6 +40,25 @@ struct BallSpatialInfo {
   Quaternion rotation_ms;
 };
 
+// ball state at one step of the prediction
+struct BallPredictionState {
+  Vector3 position;
+  Vector3 momentum;
+  Quaternion rotation_ms;
+  Quaternion orientation;
+};
+
+struct BallPredictionStats {
+  BallPredictionStats() {
+    ticks = 0;
+    fullPredictions = 0;
+    steps = 0;
+  }
+  unsigned long ticks; // CalculatePrediction calls
+  unsigned long fullPredictions; // of which needed the whole trajectory integrated
+  unsigned long steps; // 10ms integration steps, in total
+};
+
 class Ball {
 
   public:
@@ -64,6 +83,7 @@ class Ball {
     void SetRotation(radian x, radian y, radian z, float bias = 1.0); // radians per second for each axis
     void SetRotation(const Vector3 &rot, float bias = 1.0); // radians per second for each axis
     BallSpatialInfo CalculatePrediction(); // returns momentum in 10ms
+    const BallPredictionStats &GetPredictionStats() const { return predictionStats; }
     Vector3 GetPositionBuffer() { return buf_positionBuffer.GetValue(EnvironmentManager::GetInstance().GetTime_ms()); }
 
     bool BallTouchesNet() { return ballTouchesNet; }
@@ -79,12 +99,16 @@ class Ball {
     void ResetSituation(const Vector3 &focusPos);
 
   protected:
+    void PredictTrajectory(const BallPredictionState &firstStep, Vector3 *target, BallPredictionState &tail);
+    void PredictStep(BallPredictionState &state, unsigned int predictTime_ms, bool &woodwork, bool &netting);
+
     boost::shared_ptr<Scene3D> scene3D;
 
     boost::intrusive_ptr<Node> ballNode;
     boost::intrusive_ptr<Geometry> ball;
     boost::intrusive_ptr<Sound> sound;
     boost::intrusive_ptr<Sound> goalpostsound;
+    RandomStream soundRandomStream; // not random(): audio is off in headless runs, which must draw the same numbers as live ones
 
     Vector3 momentum;
     Quaternion rotation_ms;
@@ -92,6 +116,13 @@ class Ball {
     Vector3 predictions[ballPredictionSize_ms / 10];
     Quaternion orientPrediction;
 
+    // the first and last step of the current predictions, so that next time, if the ball went untouched, the array can be shifted
+    bool predictionCacheValid;
+    BallPredictionState predictionCacheFirstStep;
+    BallPredictionState predictionCacheTail;
+    bool verifyPredictionCache; // debug: compare shifted predictions with fully recalculated ones
+    BallPredictionStats predictionStats;
+
     std::list<Vector3> ballPosHistory;
     Vector3 previousMomentum;
     Vector3 previousPosition;
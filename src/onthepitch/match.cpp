@@ -25,14 +25,25 @@
 #include "player/playerofficial.hpp"
 
 #include "base/log.hpp"
+#include "base/profiler.hpp"
 
 #include "menu/pagefactory.hpp"
 #include "menu/startmatch/loadingmatch.hpp"
 
-const unsigned int replaySize_ms = 10000;
 const unsigned int camPosSize = 150;//180; //130
 
-Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) : matchData(matchData), controllers(controllers) {
+// beyond 2m (the tackle check), CheckHumanoidCollision does nothing. the rest is margin for the offsets players get while the pairs are being checked
+const float humanoidCollisionRange = 2.5f;
+// same as the 3d distance check in CheckBallCollisions
+const float ballCollisionRange = 2.5f;
+const float playerGridCellSize = 5.0f;
+
+const int mentalImageHistorySize = 30;
+
+Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers, boost::shared_ptr<AnimCollection> preloadedAnims, boost::shared_ptr<MatchInputLog> replayLog) : matchData(matchData), controllers(controllers), playerGrid(playerGridCellSize) {
+
+  // every logged stage below is timed, and the times are logged once the match is set up
+  StageTimer timer("Match", "Match");
 
   Log(e_Notice, "Match", "Match", "Starting Match");
 
@@ -54,12 +65,26 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   matchDurationFactor = GetConfiguration()->GetReal("match_duration", 1.0) * 0.2f + 0.05f;
   matchDifficulty = GetConfiguration()->GetReal("match_difficulty", 0.8f);
+  TickArena::SetEnabled(GetConfiguration()->GetBool("match_tick_arena", true));
+
+  effectsRandomStream.Seed(int(random(0.0f, 16777216.0f)));
+
+  // input log: recording this match, or replaying one (then the runner has already applied the recorded setup and settings)
+  inputLog = replayLog;
+  const std::string &inputLogFilename = GetConfiguration()->Get("match_input_log", "");
+  if (!inputLog && !inputLogFilename.empty()) {
+    inputLog = boost::shared_ptr<MatchInputLog>(new MatchInputLog());
+    inputLog->StartRecording(inputLogFilename, (unsigned int)std::time(0), matchData, *GetConfiguration(), controllers);
+  }
+  if (inputLog) SeedRandom(inputLog->GetSeed());
 
+  timer.Stage("Creating dynamicNode");
   Log(e_Notice, "Match", "Match", "Creating dynamicNode");
 
   dynamicNode = boost::intrusive_ptr<Node>(new Node("dynamicNode"));
   GetScene3D()->AddNode(dynamicNode);
 
+  timer.Stage("Adding debugpilons");
   Log(e_Notice, "Match", "Match", "Adding debugpilons");
 
   dynamicNode->AddObject(GetGreenDebugPilon());
@@ -73,6 +98,7 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   // ball
 
+  timer.Stage("Creating a ball");
   Log(e_Notice, "Match", "Match", "Creating a ball");
 
   ball = new Ball(this);
@@ -80,18 +106,25 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   // animation database
 
+  timer.Stage("Loading player animations");
   Log(e_Notice, "Match", "Match", "Loading player animations");
 
-  anims = boost::shared_ptr<AnimCollection>(new AnimCollection(GetScene3D()));
-  
   // Initialize commentary system
   commentaryManager = new CommentaryManager();
   commentaryManager->Initialize(this);
-  anims->Load("media/animations");
+
+  // batch runs load the animations once and share them between matches; they are only read from during the match
+  if (preloadedAnims) {
+    anims = preloadedAnims;
+  } else {
+    anims = boost::shared_ptr<AnimCollection>(new AnimCollection(GetScene3D()));
+    anims->Load("media/animations");
+  }
 
 
   // cache animation positions
 
+  timer.Stage("Caching animation positions");
   Log(e_Notice, "Match", "Match", "Caching animation positions");
 
   const std::vector < Animation* > &animationsTmp = anims->GetAnimations();
@@ -114,11 +147,13 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   // full body model template
 
+  timer.Stage("Loading fullbody object");
   Log(e_Notice, "Match", "Match", "Loading fullbody object");
 
   ObjectLoader loader;
   fullbodyNode = loader.LoadObject(GetScene3D(), "media/objects/players/fullbody.object");
 
+  timer.Stage("Fullbody object: getting vertex colors");
   Log(e_Notice, "Match", "Match", "Fullbody object: getting vertex colors");
 
   GetVertexColors(colorCoords);
@@ -128,6 +163,7 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   // teams
 
+  timer.Stage("Creating teams/players");
   Log(e_Notice, "Match", "Match", "Creating teams/players");
 
   assert(matchData != 0);
@@ -144,9 +180,32 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
   designatedPossessionPlayer = activePlayers.at(0);
   ballRetainer = 0;
 
+  // player ids are global, slots are per match: they let the mental images store players in a plain array
+  std::vector<Player*> allPlayers;
+  teams[0]->GetAllPlayers(allPlayers);
+  teams[1]->GetAllPlayers(allPlayers);
+  firstPlayerSlotID = allPlayers.at(0)->GetID();
+  int lastPlayerSlotID = firstPlayerSlotID;
+  for (unsigned int i = 0; i < allPlayers.size(); i++) {
+    firstPlayerSlotID = std::min(firstPlayerSlotID, allPlayers.at(i)->GetID());
+    lastPlayerSlotID = std::max(lastPlayerSlotID, allPlayers.at(i)->GetID());
+  }
+  playerSlots.resize(lastPlayerSlotID - firstPlayerSlotID + 1, -1);
+  for (unsigned int i = 0; i < allPlayers.size(); i++) {
+    playerSlots.at(allPlayers.at(i)->GetID() - firstPlayerSlotID) = i;
+  }
+  playerSlotCount = allPlayers.size();
+
+  for (int i = 0; i < mentalImageHistorySize; i++) {
+    mentalImages.push_back(new MentalImage(this));
+  }
+  mentalImageFront = 0;
+  mentalImageCount = 0;
+
 
   // officials
 
+  timer.Stage("Creating referee/linesmen models");
   Log(e_Notice, "Match", "Match", "Creating referee/linesmen models");
 
   std::string kitFilename = "media/objects/players/textures/referee_kit.png";
@@ -159,6 +218,7 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   // camera
 
+  timer.Stage("Creating camera objects");
   Log(e_Notice, "Match", "Match", "Creating camera objects");
 
   camera = static_pointer_cast<Camera>(ObjectFactory::GetInstance().CreateObject("camera", e_ObjectType_Camera));
@@ -181,6 +241,7 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   // stadium
 
+  timer.Stage("Loading stadium");
   Log(e_Notice, "Match", "Match", "Loading stadium");
 
   boost::intrusive_ptr<Node> tmpStadiumNode;
@@ -214,6 +275,7 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   // goal netting
 
+  timer.Stage("Preparing goal netting");
   Log(e_Notice, "Match", "Match", "Preparing goal netting");
 
   goalsNode = loader.LoadObject(GetScene3D(), "media/objects/stadiums/goals.object");
@@ -224,9 +286,12 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   // pitch
 
+  timer.Stage("Generating pitch");
   Log(e_Notice, "Match", "Match", "Generating pitch");
 
-  if (IsReleaseVersion()) {
+  if (IsHeadless()) {
+    // nobody's going to look at it
+  } else if (IsReleaseVersion()) {
     GeneratePitch(2048, 1024, 1024, 512, 2048, 1024);
   } else {
     GeneratePitch(1024, 512, 1024, 512, 2048, 1024);
@@ -235,6 +300,7 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   // sun
 
+  timer.Stage("Loading sun object");
   Log(e_Notice, "Match", "Match", "Loading sun object");
 
   sunNode = loader.LoadObject(GetScene3D(), "media/objects/lighting/generic.object");
@@ -244,6 +310,7 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   // human gamers
 
+  timer.Stage("Human gamer controller init");
   Log(e_Notice, "Match", "Match", "Human gamer controller init");
 
   UpdateControllerSetup();
@@ -251,6 +318,7 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   // 12th man sound
 
+  timer.Stage("Loading crowd sounds");
   Log(e_Notice, "Match", "Match", "Loading crowd sounds");
 
   boost::intrusive_ptr < Resource<SoundBuffer> > soundBufferRes = ResourceManagerPool::GetInstance().GetManager<SoundBuffer>(e_ResourceType_SoundBuffer)->Fetch("media/sounds/crowd01.wav", true, true);
@@ -291,14 +359,19 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   gameSequenceInfo = GetScheduler()->GetTaskSequenceInfo("game");
 
-  previousProcessTime_ms = EnvironmentManager::GetInstance().GetTime_ms() - gameSequenceInfo.startTime_ms;
-  previousPutTime_ms = EnvironmentManager::GetInstance().GetTime_ms() - gameSequenceInfo.startTime_ms;
+  previousProcessTime_ms = 0;
+  previousPreparePutTime_ms = GetSequenceTime_ms();
+  previousPutTime_ms = GetSequenceTime_ms();
+  putCount = 0;
+  putTransformUpdateSum = 0;
+  putTransformUpdateMax = 0;
   timeSincePreviousProcess_ms = 0;
   timeSincePreviousPut_ms = 0;
 
 
   // everybody hates him, this poor bloke
 
+  timer.Stage("Creating referee functionality");
   Log(e_Notice, "Match", "Match", "Creating referee functionality");
 
   referee = new Referee(this);
@@ -306,6 +379,7 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   // GUI
 
+  timer.Stage("Creating GUI elements");
   Log(e_Notice, "Match", "Match", "Creating GUI elements");
 
   Gui2Root *root = menuTask->GetWindowManager()->GetRoot();
@@ -354,19 +428,15 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   // replays
 
+  timer.Stage("Initialising replay data array");
   Log(e_Notice, "Match", "Match", "Initialising replay data array");
 
+  replaySize_ms = GetConfiguration()->GetInt("match_replay_seconds", 10) * 1000;
+
   std::list < boost::intrusive_ptr<Spatial> > spatials;
   GetReplaySpatials(spatials);
-
-  std::list < boost::intrusive_ptr<Spatial> >::iterator spatialIter = spatials.begin();
-  while (spatialIter != spatials.end()) {
-    ReplaySpatial *spatial = new ReplaySpatial(GetReplaySize_ms() / 10);
-    spatial->spatial = *spatialIter;
-    replay.push_back(spatial);
-    spatialIter++;
-  }
-  replayBallTouchesNetFrames = boost::circular_buffer<ReplayBallTouchesNetFrame>(GetReplaySize_ms() / 10);
+  replayBuffer.SetSpatials(spatials);
+  replayBuffer.SetLength_ms(GetReplaySize_ms());
 
   excitement = 0.0f;
 
@@ -378,6 +448,8 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   Log(e_Notice, "Match", "Match", "Done creating match!");
 
+  timer.Report();
+
 
   // light test
 
@@ -399,12 +471,18 @@ Match::Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers) :
 
   if (_positionLogging) positionLogFile.open("positions.log", std::ios::out);
 
+  // the setup above draws a different amount of random numbers with or without renderer (pitch, adboards), so start the
+  // simulation's sequence over. from here on, only the simulation draws from it
+  if (inputLog) SeedRandom(inputLog->GetSeed());
+
   if (Verbose()) printf("ready..\n");
   sig_OnCreatedMatch(this);
   if (Verbose()) printf("set..\n");
-  LoadingMatchPage *loadingMatchPage = static_cast<LoadingMatchPage*>(menuTask->GetWindowManager()->GetPageFactory()->GetMostRecentlyCreatedPage());
-  loadingMatchPage->Close();
-  if (Verbose()) printf("loadingmatchpage closed\n");
+  if (!IsHeadless()) {
+    LoadingMatchPage *loadingMatchPage = static_cast<LoadingMatchPage*>(menuTask->GetWindowManager()->GetPageFactory()->GetMostRecentlyCreatedPage());
+    loadingMatchPage->Close();
+    if (Verbose()) printf("loadingmatchpage closed\n");
+  }
 }
 
 Match::~Match() {
@@ -441,9 +519,8 @@ void Match::Exit() {
   }
   mentalImages.clear();
 
-  for (unsigned int i = 0; i < replay.size(); i++) {
-    delete replay.at(i);
-  }
+  if (Verbose()) printf("replay buffer: %u frames in %lu bytes\n", replayBuffer.GetFrameCount(), (unsigned long)replayBuffer.GetMemoryUsage());
+  if (Verbose() && putCount > 0) printf("derived transforms computed per put: %.1f average, %lu max\n", putTransformUpdateSum / (double)putCount, putTransformUpdateMax);
 
   fullbodyNode->Exit();
   fullbodyNode.reset();
@@ -500,6 +577,16 @@ void Match::Exit() {
 
   if (_positionLogging) positionLogFile.close();
 
+  if (inputLog && inputLog->IsRecording()) inputLog->Save();
+  if (inputLog && inputLog->IsReplaying()) {
+    if (inputLog->GetDivergedTick() == -1) {
+      Log(e_Notice, "Match", "Exit", "Replay was identical to the recording");
+    } else {
+      Log(e_Warning, "Match", "Exit", "Replay diverged from the recording at tick " + int_to_str(inputLog->GetDivergedTick()));
+    }
+  }
+  inputLog.reset();
+
   sig_OnExitedMatch(this);
 }
 
@@ -507,6 +594,8 @@ void Match::SetRandomSunParams() {
 
   if (Verbose()) printf("setting random sun params\n");
 
+  BindRandomStream(&effectsRandomStream);
+
   float brightness = 1.0f;
 
   Vector3 sunPos = Vector3(-1.2f, 0.4f, 1.0f); // sane default
@@ -534,6 +623,8 @@ void Match::SetRandomSunParams() {
   if (Verbose()) randomAddition.Print();
 
   static_pointer_cast<Light>(sunNode->GetObject("sun"))->SetColor(sunColor * brightness);
+
+  BindRandomStream(0);
 }
 
 void Match::RandomizeAdboards(boost::intrusive_ptr<Node> stadiumNode) {
@@ -604,11 +695,14 @@ void Match::UpdateControllerSetup() {
   teams[1]->DeleteHumanGamers();
 
   // add new
-  const std::vector<SideSelection> sides = menuTask->GetControllerSetup();
+  const std::vector<SideSelection> sides = (inputLog && inputLog->IsReplaying()) ? inputLog->GetControllerSetup(GetIterations()) : menuTask->GetControllerSetup();
+  if (inputLog && inputLog->IsRecording()) inputLog->RecordControllerSetup(GetIterations(), sides);
+  // with an input log, gamers play with the log's copies of the devices, which don't change during a tick
+  const std::vector<IHIDevice*> &gamerControllers = inputLog ? inputLog->GetControllers() : controllers;
   for (unsigned int i = 0; i < sides.size(); i++) {
     if (sides.at(i).side != 0) {
       int teamID = int(round(sides.at(i).side * 0.5 + 0.5));
-      teams[teamID]->AddHumanGamer(controllers.at(sides.at(i).controllerID), (e_PlayerColor)i); // todo: proper color
+      teams[teamID]->AddHumanGamer(gamerControllers.at(sides.at(i).controllerID), (e_PlayerColor)i); // todo: proper color
       //printf("team id %i, %i\n", teamID, sides.at(i).controllerID);
     }
   }
@@ -647,28 +741,30 @@ void Match::GetOfficialPlayers(std::vector<PlayerBase*> &players) {
   officials->GetPlayers(players);
 }
 
-const MentalImage *Match::GetMentalImage(int history_ms) {
+int Match::GetPlayerSlot(int playerID) const {
+  int index = playerID - firstPlayerSlotID;
+  if (index < 0 || index >= (signed int)playerSlots.size()) return -1;
+  return playerSlots[index];
+}
+
+const MentalImage *Match::GetMentalImage(int history_ms) const {
   int index = int(round((float)history_ms / 10.0));
-  if (index >= (signed int)mentalImages.size()) index = mentalImages.size() - 1;
+  if (index >= mentalImageCount) index = mentalImageCount - 1;
   if (index < 0) index = 0;
 
-  mentalImages.at(index)->SetTimeStampNeg_ms(index * 10.0f);
-
-  return mentalImages.at(index);
+  // read-only: players may be fetching these from several threads at once (timestamps are set when the ring rotates)
+  return mentalImages[(mentalImageFront + index) % mentalImageHistorySize];
 }
 
 void Match::UpdateLatestMentalImageBallPredictions() {
-  if (mentalImages.size() > 0) mentalImages.at(0)->UpdateBallPredictions();
+  if (mentalImageCount > 0) mentalImages[mentalImageFront]->UpdateBallPredictions();
 }
 
 void Match::ResetSituation(const Vector3 &focusPos) {
   camPos.clear();
   SetBallRetainer(0);
   SetGoalScored(false);
-  for (unsigned int i = 0; i < mentalImages.size(); i++) {
-    delete mentalImages[i];
-  }
-  mentalImages.clear();
+  mentalImageCount = 0;
   goalScored = false;
   ballIsInGoal = false;
   for (unsigned int i = 0; i < e_TouchType_SIZE; i++) {
@@ -678,7 +774,6 @@ void Match::ResetSituation(const Vector3 &focusPos) {
   lastGoalScorer = 0;
   bestPossessionTeamID = -1;
 
-  mentalImages.clear();
   possessionSideHistory->Clear();
 
   lastBodyBallCollisionTime_ms = 0;
@@ -730,6 +825,48 @@ void Match::GameOver() {
   gameOver = true;
 }
 
+unsigned long Match::GetSequenceTime_ms() {
+  // headless matches aren't scheduled, they run on a virtual clock of one step per Process()
+  if (IsHeadless()) return GetIterations() * 10;
+  return EnvironmentManager::GetInstance().GetTime_ms() - gameSequenceInfo.startTime_ms;
+}
+
+void Match::SeedRandom(unsigned int seed) {
+  randomseed(seed);
+  fastrandomseed(seed);
+}
+
+namespace {
+  // fnv-1a
+  inline void HashBytes(unsigned int &checksum, const void *data, unsigned int size) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char*>(data);
+    for (unsigned int i = 0; i < size; i++) checksum = (checksum ^ bytes[i]) * 16777619u;
+  }
+}
+
+unsigned int Match::CalculateStateChecksum() {
+  // over the bits of the ball and active player positions, the clocks and the score. runs every tick, so straight from the source
+  unsigned int checksum = 2166136261u;
+  Vector3 ballPosition = ball->Predict(0);
+  HashBytes(checksum, ballPosition.coords, sizeof(ballPosition.coords));
+  for (int teamID = 0; teamID < 2; teamID++) {
+    const std::vector<Player*> &players = teams[teamID]->GetAllPlayers();
+    for (unsigned int i = 0; i < players.size(); i++) {
+      if (!players[i]->IsActive()) continue;
+      Vector3 position = players[i]->GetPosition();
+      HashBytes(checksum, position.coords, sizeof(position.coords));
+    }
+  }
+  unsigned long counters[4] = { matchTime_ms, actualTime_ms, (unsigned long)matchData->GetGoalCount(0), (unsigned long)matchData->GetGoalCount(1) };
+  HashBytes(checksum, counters, sizeof(counters));
+  return checksum;
+}
+
+unsigned long Match::GetSnapshotTime_ms() {
+  if (IsHeadless()) return GetIterations() * 10;
+  return gameSequenceInfo.timesRan * gameSequenceInfo.sequenceTime_ms;
+}
+
 void Match::GetCameraParams(float &zoom, float &height, float &fov, float &angleFactor) {
   zoom = cameraUserZoom;
   height = cameraUserHeight;
@@ -769,7 +906,7 @@ void Match::UpdateIngameCamera() {
   if (fabs(ballPos.coords[0]) > maxW) ballPos.coords[0] = maxW * signSide(ballPos.coords[0]);
   if (fabs(ballPos.coords[1]) > maxH) ballPos.coords[1] = maxH * signSide(ballPos.coords[1]);
 
-  Vector3 shudder = Vector3(random(-0.1f, 0.1f), random(-0.1f, 0.1f), 0) * (ball->GetMovement().GetLength() * 0.8f + 6.0f);
+  Vector3 shudder = Vector3(effectsRandomStream.Get(-0.1f, 0.1f), effectsRandomStream.Get(-0.1f, 0.1f), 0) * (ball->GetMovement().GetLength() * 0.8f + 6.0f);
   shudder *= 0.2f;
   camPos.push_back(ballPos + shudder * ((float)camPos.size() / (float)camPosSize));
   if (camPos.size() > camPosSize) camPos.pop_front();
@@ -874,10 +1011,27 @@ void Match::Get() {
 
 void Match::Process() {
 
-  unsigned long time_ms = EnvironmentManager::GetInstance().GetTime_ms() - gameSequenceInfo.startTime_ms;
+  PROFILE_ZONE("Match::Process");
+
+  // containers constructed with TickArena::GetCurrent() from here on live in this thread's tick arena, which this resets
+  TickArenaScope tickArenaScope;
+
+  // the simulation runs on the tick clock, not the wall clock: every Process() is 10ms, however long it really took
+  unsigned long time_ms = GetIterations() * 10;
   timeSincePreviousProcess_ms = time_ms - GetPreviousProcessTime_ms();
   previousProcessTime_ms = time_ms;
 
+  // the input log sees (or, replaying, provides) everything that goes into this tick from the outside
+  if (inputLog) {
+    unsigned long tick = GetIterations();
+    if (inputLog->IsRecording()) {
+      inputLog->RecordTick(tick, pause, CalculateStateChecksum());
+    } else if (inputLog->IsReplaying()) {
+      if (tick > 0 && inputLog->IsControllerSetupChange(tick)) UpdateControllerSetup(); // tick 0's was done by the constructor
+      inputLog->ReplayTick(tick, pause, CalculateStateChecksum());
+    }
+  }
+
   if (UserEventManager::GetInstance().GetKeyboardState(SDLK_F1)) {
     SetRandomSunParams();
     UserEventManager::GetInstance().SetKeyboardState(SDLK_F1, false);
@@ -908,13 +1062,12 @@ void Match::Process() {
 
     // create mental images for the AI to use
 
-    MentalImage *mentalImage = new MentalImage(this);
-    mentalImage->TakeSnapshot();
-    mentalImages.insert(mentalImages.begin(), mentalImage);
-    if (mentalImages.size() > 30) {
-      MentalImage *mentalImageToDelete = mentalImages.back();
-      mentalImages.pop_back();
-      delete mentalImageToDelete;
+    // the oldest one becomes the newest
+    mentalImageFront = (mentalImageFront + mentalImageHistorySize - 1) % mentalImageHistorySize;
+    mentalImages[mentalImageFront]->TakeSnapshot();
+    if (mentalImageCount < mentalImageHistorySize) mentalImageCount++;
+    for (int index = 1; index < mentalImageCount; index++) {
+      mentalImages[(mentalImageFront + index) % mentalImageHistorySize]->SetTimeStampNeg_ms(index * 10);
     }
 
 
@@ -1074,7 +1227,7 @@ void Match::Process() {
 
   } // end if !pause
 
-  if (autoUpdateIngameCamera) UpdateIngameCamera();
+  if (autoUpdateIngameCamera && !IsHeadless()) UpdateIngameCamera();
 
   if (!pause) {
     unsigned int zoomTime = 2000;
@@ -1163,13 +1316,13 @@ void Match::Process() {
 
 void Match::PreparePutBuffers() {
 
-  gameSequenceInfo = GetScheduler()->GetTaskSequenceInfo("game");
-  unsigned long time_ms = EnvironmentManager::GetInstance().GetTime_ms() - gameSequenceInfo.startTime_ms;
+  if (!IsHeadless()) gameSequenceInfo = GetScheduler()->GetTaskSequenceInfo("game");
+  unsigned long time_ms = GetSequenceTime_ms();
   timeSincePreviousPreparePut_ms = time_ms - GetPreviousPreparePutTime_ms();
   previousPreparePutTime_ms = time_ms;
 
   // snapshot time is the time that is 'represented' by the snapshot
-  unsigned long snapshotTime_ms = gameSequenceInfo.timesRan * gameSequenceInfo.sequenceTime_ms;
+  unsigned long snapshotTime_ms = GetSnapshotTime_ms();
   //printf("%lu, %lu\n", (GetIterations() - 1) * 10, gameSequenceInfo.timesRan * gameSequenceInfo.sequenceTime_ms);
   //printf("PREP time: %lu, snapshot time: %lu, actual time: %lu\n", time_ms, snapshotTime_ms, actualTime_ms);
 
@@ -1204,13 +1357,13 @@ void Match::FetchPutBuffers() {
 
   if (GetIterations() < 1) return; // no processes done yet
 
-  unsigned long time_ms = EnvironmentManager::GetInstance().GetTime_ms() - gameSequenceInfo.startTime_ms;
+  unsigned long time_ms = GetSequenceTime_ms();
   timeSincePreviousPut_ms = time_ms - GetPreviousPutTime_ms();
   previousPutTime_ms = time_ms;
   unsigned long putTime_ms = time_ms;// - gameSequenceInfo.startTime_ms; // test: + PredictFrameTimeToGo_ms(7) - 15;
   //printf("FETCH time: %lu - seqstarttime: %lu = put time: %lu, times ran * 10: %i\n", time_ms, gameSequenceInfo.startTime_ms, putTime_ms, (int)gameSequenceInfo.timesRan * gameSequenceInfo.sequenceTime_ms);
   //printf("FETCH buf - snapshot time delta: %i\n", (int)putTime_ms - (int)gameSequenceInfo.timesRan * gameSequenceInfo.sequenceTime_ms);
-  fetchedbuf_timeDelta = (int)putTime_ms - (int)gameSequenceInfo.timesRan * gameSequenceInfo.sequenceTime_ms;
+  fetchedbuf_timeDelta = (int)putTime_ms - (int)GetSnapshotTime_ms();
 
   fetchedbuf_matchTime_ms = buf_matchTime_ms;
   fetchedbuf_actualTime_ms = buf_actualTime_ms;
@@ -1234,6 +1387,19 @@ void Match::Put() {
 
   if (GetIterations() < 2) return; // no processes done yet (todo: this is not the correct way to measure that :p)
 
+  if (IsHeadless()) {
+    // nothing to display, but ball and tackle collisions read the body part geoms, so those still need to be posed
+    if (!GetPause()) {
+      ball->Put();
+      teams[0]->Put();
+      teams[1]->Put();
+      officials->Put();
+    }
+    return;
+  }
+
+  unsigned long startTransformUpdateCount = Spatial::GetDerivedTransformUpdateCount();
+
   // fun!
   //sunNode->SetPosition(Vector3(sin(buf_actualTime_ms * 0.001) * 3000, cos(buf_actualTime_ms * 0.001) * 3000, 1000.0));
 
@@ -1296,7 +1462,13 @@ void Match::Put() {
     ProcessReplayMessages();
   }
 
-  GetDynamicNode()->RecursiveUpdateSpatialData(e_SpatialDataType_Both);
+  // most of the dynamic tree has updated itself already (players, on posing); this does what was only moved
+  GetDynamicNode()->RecursiveUpdatePendingSpatialData();
+
+  unsigned long transformUpdates = Spatial::GetDerivedTransformUpdateCount() - startTransformUpdateCount;
+  putTransformUpdateSum += transformUpdates;
+  putTransformUpdateMax = std::max(putTransformUpdateMax, transformUpdates);
+  putCount++;
 
   if (!pause) {
 
@@ -1351,38 +1523,8 @@ boost::intrusive_ptr<Node> Match::GetDynamicNode() {
 
 void Match::ApplyReplayFrame(unsigned long replayTime_ms) {
 
-  for (unsigned int i = 0; i < replay.size(); i++) {
-
-    /* todo: smoothing
-    std::map<unsigned long, ReplayFrame>::iterator iter1 = replay.at(i).frames.find(first_ms);
-    if (iter1 == replay.at(i).frames.end()) printf("FRAME NOT FOUND, SHOULD NOT HAPPEN AAARGHH\n");
-    std::map<unsigned long, ReplayFrame>::iterator iter2 = replay.at(i).frames.find(last_ms);
-    if (iter2 == replay.at(i).frames.end()) printf("FRAME NOT FOUND, SHOULD NOT HAPPEN AAARGHH\n");
-    */
-
-    boost::circular_buffer<ReplaySpatialFrame>::iterator iter = replay.at(i)->frames.begin();
-    while (iter != replay.at(i)->frames.end()) {
-      if (iter->frameTime_ms >= replayTime_ms) {
-        boost::circular_buffer<ReplaySpatialFrame>::iterator iterPrev = iter;
-        if (iterPrev != replay.at(i)->frames.begin()) iterPrev--;
-        const ReplaySpatialFrame &frame1 = *iterPrev;//->frames.at(frame - 1);
-        const ReplaySpatialFrame &frame2 = *iter;//->frames.at(frame);
-        int count = frame2.frameTime_ms - frame1.frameTime_ms;
-        int offset = replayTime_ms - frame1.frameTime_ms;
-        if (count == 0) count = 1; // never divide by zero, will implode universe
-        float bias = (float)offset / (float)count;
-        //printf("bias: %f\n", bias);
-
-        replay.at(i)->spatial->SetPosition(frame1.position * (1.0f - bias) + frame2.position * bias, false);
-        //frame1.orientation.MakeSameNeighborhood(frame2.orientation); only needed for Lerp
-        replay.at(i)->spatial->SetRotation(frame1.orientation.GetSlerped(bias, frame2.orientation).GetNormalized(), false);
-        replay.at(i)->spatial->RecursiveUpdateSpatialData(e_SpatialDataType_Both);
-        break;
-      }
-      iter++;
-    }
-
-  }
+  bool ballTouchesNet = false;
+  if (!replayBuffer.Apply(replayTime_ms, ballTouchesNet)) return;
 
   std::vector<Player*> players;
   GetActiveTeamPlayers(0, players);
@@ -1396,15 +1538,7 @@ void Match::ApplyReplayFrame(unsigned long replayTime_ms) {
     playerOfficials.at(i)->UpdateFullbodyNodes();
   }
 
-  boost::circular_buffer<ReplayBallTouchesNetFrame>::iterator iter = replayBallTouchesNetFrames.begin();
-  while (iter != replayBallTouchesNetFrames.end()) {
-    if (iter->frameTime_ms >= replayTime_ms) {
-      bool ballTouchesNet = (*iter).ballTouchesNet;
-      UpdateGoalNetting(ballTouchesNet);
-      break;
-    }
-    iter++;
-  }
+  UpdateGoalNetting(ballTouchesNet);
 }
 
 void Match::GetReplaySpatials(std::list < boost::intrusive_ptr<Spatial> > &spatials) {
@@ -1441,23 +1575,7 @@ void Match::GetReplaySpatials(std::list < boost::intrusive_ptr<Spatial> > &spati
 }
 
 void Match::CaptureReplayFrame(unsigned long replayTime_ms) {
-  for (unsigned int i = 0; i < replay.size(); i++) {
-
-    Vector3 pos = replay.at(i)->spatial->GetPosition();
-    Quaternion orient = replay.at(i)->spatial->GetRotation();
-
-    ReplaySpatialFrame frame;
-    frame.frameTime_ms = replayTime_ms;
-    frame.position = pos;
-    frame.orientation = orient;
-    replay.at(i)->frames.push_back(frame);
-
-  }
-
-  ReplayBallTouchesNetFrame ballTouchesNetFrame;
-  ballTouchesNetFrame.frameTime_ms = replayTime_ms;
-  ballTouchesNetFrame.ballTouchesNet = GetBall()->BallTouchesNet();
-  replayBallTouchesNetFrames.push_back(ballTouchesNetFrame);
+  replayBuffer.Capture(replayTime_ms, GetBall()->BallTouchesNet());
 }
 
 bool Match::CheckForGoal(signed int side) {
@@ -1514,26 +1632,24 @@ void Match::CalculateBestPossessionTeamID() {
 }
 
 void Match::CheckHumanoidCollisions() {
-  std::vector<Player*> players;
+  TickVector<Player*> players(TickArena::GetCurrent());
 
   GetTeam(0)->GetActivePlayers(players);
   GetTeam(1)->GetActivePlayers(players);
 
-  // outer vectors index == players[] index
-  std::vector < std::vector<PlayerBounce> > playerBounces;
-
-  // insert an empty entry for every player
+  // outer vectors index == players[] index. inner vectors are cleared, not freed, so their capacity carries over to the next tick
+  playerBounces.resize(players.size());
   for (unsigned int i1 = 0; i1 < players.size(); i1++) {
-    std::vector<PlayerBounce> bounce;
-    playerBounces.push_back(bounce);
+    playerBounces.at(i1).clear();
   }
 
-  // check each combination of humanoids once
-  for (unsigned int i1 = 0; i1 < players.size() - 1; i1++) {
-    for (unsigned int i2 = i1 + 1; i2 < players.size(); i2++) {
-      Vector3 tripVec1, tripVec2;
-      CheckHumanoidCollision(players.at(i1), players.at(i2), playerBounces.at(i1), playerBounces.at(i2));
-    }
+  // check each combination of humanoids that are close enough to interact once, in the same order as checking all combinations would
+  playerGrid.Build(players);
+  playerGrid.GetPairs(humanoidCollisionRange, collisionPairs);
+  for (unsigned int p = 0; p < collisionPairs.size(); p++) {
+    int i1 = collisionPairs[p].first;
+    int i2 = collisionPairs[p].second;
+    CheckHumanoidCollision(players.at(i1), players.at(i2), playerBounces.at(i1), playerBounces.at(i2));
   }
 
   // do bouncy magic
@@ -1962,7 +2078,7 @@ void Match::CheckBallCollisions() {
   //printf("%i - %i hihi\n", actualTime_ms, lastBodyBallCollisionTime_ms + 150);
   if (actualTime_ms <= lastBodyBallCollisionTime_ms + 150) return;
 
-  std::vector<Player*> players;
+  TickVector<Player*> players(TickArena::GetCurrent());
   GetTeam(0)->GetActivePlayers(players);
   GetTeam(1)->GetActivePlayers(players);
 
@@ -1971,8 +2087,14 @@ void Match::CheckBallCollisions() {
   float bias = 0.0;
   int bounceCount = 0; // this shit is shit, average properly in combination with bias or something like that
 
+  // only players near the ball can hit it (see the distance check below)
+  playerGrid.Build(players);
+  playerGrid.GetNearby(ball->Predict(0), ballCollisionRange, nearbyPlayers);
+
   //printf("lasttouchbias: %f, isnul?: %s\n", GetLastTouchBias(200), GetLastTouchBias(200) == 0.0f ? "true" : "false");
-  for (int i = 0; i < (signed int)players.size(); i++) {
+  for (unsigned int n = 0; n < nearbyPlayers.size(); n++) {
+
+    int i = nearbyPlayers[n];
 
     bool biggestRatio = false;
     int teamID = players[i]->GetTeam()->GetID();
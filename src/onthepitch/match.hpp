@@ -11,6 +11,9 @@
 #include "ball.hpp"
 #include "referee.hpp"
 #include "officials.hpp"
+#include "playergrid.hpp"
+#include "matchinputlog.hpp"
+#include "replaybuffer.hpp"
 
 #include "../data/matchdata.hpp"
 #include "player/humanoid/animcollection.hpp"
@@ -33,30 +36,10 @@
 #include "types/command.hpp"
 #include "types/lockable.hpp"
 
-#include <boost/circular_buffer.hpp>
 
 #include <fstream>
 #include <iostream>
 
-struct ReplaySpatialFrame {
-  unsigned long frameTime_ms;
-  Vector3 position;
-  Quaternion orientation;
-};
-
-struct ReplayBallTouchesNetFrame {
-  unsigned long frameTime_ms;
-  bool ballTouchesNet;
-};
-
-struct ReplaySpatial {
-  ReplaySpatial(int frameCount) {
-    frames = boost::circular_buffer<ReplaySpatialFrame>(frameCount);
-  }
-  boost::intrusive_ptr<Spatial> spatial;
-  boost::circular_buffer<ReplaySpatialFrame> frames;
-};
-
 struct PlayerBounce {
   Player *opp;
   float force;
@@ -105,7 +88,9 @@ struct MissingAnim {
 class Match {
 
   public:
-    Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers);
+    // replayLog: re-simulate a recorded match (pass its GetControllers() as controllers). otherwise, the match_input_log config key
+    // names the file to record this match's input log to (empty == don't)
+    Match(MatchData *matchData, const std::vector<IHIDevice*> &controllers, boost::shared_ptr<AnimCollection> preloadedAnims = boost::shared_ptr<AnimCollection>(), boost::shared_ptr<MatchInputLog> replayLog = boost::shared_ptr<MatchInputLog>());
     virtual ~Match();
 
     void Exit();
@@ -118,13 +103,15 @@ class Match {
     Ball *GetBall() { return ball; }
     Team *GetTeam(int teamID) { return teams[teamID]; }
     Player *GetPlayer(int playerID);
+    int GetPlayerSlot(int playerID) const; // index into team 0's, then team 1's GetAllPlayers, or -1
+    int GetPlayerSlotCount() const { return playerSlotCount; }
     void GetAllTeamPlayers(int teamID, std::vector<Player*> &players);
     void GetActiveTeamPlayers(int teamID, std::vector<Player*> &players);
     void GetOfficialPlayers(std::vector<PlayerBase*> &players);
 
     boost::shared_ptr<AnimCollection> GetAnimCollection() { return anims; }
 
-    const MentalImage *GetMentalImage(int history_ms);
+    const MentalImage *GetMentalImage(int history_ms) const;
     void UpdateLatestMentalImageBallPredictions();
 
     void ResetSituation(const Vector3 &focusPos);
@@ -173,6 +160,7 @@ class Match {
     unsigned long GetActualTime_ms() const { return actualTime_ms; }
 
     void GameOver();
+    bool IsGameOver() const { return gameOver; }
 
     void GetCameraParams(float &zoom, float &height, float &fov, float &angleFactor);
     void SetCameraParams(float zoom, float height, float fov, float angleFactor);
@@ -229,7 +217,12 @@ class Match {
     boost::signals2::signal<void(Match*)> sig_OnCreatedMatch;
     boost::signals2::signal<void(Match*)> sig_OnExitedMatch;
 
+    boost::shared_ptr<MatchInputLog> GetInputLog() { return inputLog; }
+
   protected:
+    unsigned long GetSequenceTime_ms();
+    unsigned long GetSnapshotTime_ms();
+
     void GetReplaySpatials(std::list < boost::intrusive_ptr<Spatial> > &spatials);
     void CaptureReplayFrame(unsigned long replayTime_ms);
     bool CheckForGoal(signed int side);
@@ -239,6 +232,9 @@ class Match {
     void CheckHumanoidCollision(Player *p1, Player *p2, std::vector<PlayerBounce> &p1Bounce, std::vector<PlayerBounce> &p2Bounce);
     void CheckBallCollisions();
 
+    void SeedRandom(unsigned int seed);
+    unsigned int CalculateStateChecksum();
+
     void PrepareGoalNetting();
     void UpdateGoalNetting(bool ballTouchesNet = false);
 
@@ -250,6 +246,11 @@ class Match {
     int timeSincePreviousPreparePut_ms;
     int timeSincePreviousPut_ms;
 
+    // derived transforms (Spatial) computed during Put, all of them together
+    unsigned long putCount;
+    unsigned long putTransformUpdateSum;
+    unsigned long putTransformUpdateMax;
+
     MatchData *matchData;
     Team *teams[2];
 
@@ -276,7 +277,20 @@ class Match {
 
     Ball *ball;
 
-    std::vector<MentalImage*> mentalImages; // [index] == index * 10 ms ago ([0] == now)
+    // ring buffer, allocated once: mentalImages[(mentalImageFront + index) % mentalImageHistorySize] == index * 10 ms ago (index 0 == now)
+    std::vector<MentalImage*> mentalImages;
+    int mentalImageFront;
+    int mentalImageCount;
+
+    std::vector<int> playerSlots; // [playerID - firstPlayerSlotID] == slot
+    int firstPlayerSlotID;
+    int playerSlotCount;
+
+    // collision broadphase and scratch buffers, kept around so the per-tick checks don't allocate
+    PlayerGrid playerGrid;
+    std::vector< std::pair<int, int> > collisionPairs;
+    std::vector<int> nearbyPlayers;
+    std::vector < std::vector<PlayerBounce> > playerBounces; // outer index == active players index
 
     Gui2ScoreBoard *scoreboard;
     Gui2Radar *radar;
@@ -285,6 +299,12 @@ class Match {
     unsigned long messageCaptionRemoveTime_ms;
 
     mutable Lockable<unsigned long> iterations;
+
+    boost::shared_ptr<MatchInputLog> inputLog;
+    // for effects (camera shake, sun, ...) that only run when there's something to look at: drawing those from the
+    // simulation's random() sequence would make live and headless runs of the same input log diverge
+    RandomStream effectsRandomStream;
+
     TaskSequenceInfo gameSequenceInfo;
     unsigned long matchTime_ms;
     unsigned long actualTime_ms;
@@ -355,8 +375,8 @@ class Match {
     boost::intrusive_ptr<Sound> crowd01;
     boost::intrusive_ptr<Sound> crowd02;
 
-    std::vector<ReplaySpatial*> replay;
-    boost::circular_buffer<ReplayBallTouchesNetFrame> replayBallTouchesNetFrames;
+    ReplayBuffer replayBuffer;
+    int replaySize_ms;
     bool resetNetting;
     bool nettingHasChanged;
 
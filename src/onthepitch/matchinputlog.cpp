@@ -0,0 +1,384 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#include "matchinputlog.hpp"
+
+#include "../data/matchdata.hpp"
+#include "../hid/hidreplay.hpp"
+
+#include "base/log.hpp"
+#include "base/utils.hpp"
+
+#include <fstream>
+#include <cstring>
+
+namespace {
+
+  const char magic[4] = { 'F', 'B', 'I', 'L' };
+  const unsigned int version = 1;
+
+  // everything native endian: logs are for replaying on the machine (or at least the kind of machine) they were recorded on
+
+  template <typename T> void Write(std::ofstream &file, const T &value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void WriteString(std::ofstream &file, const std::string &value) {
+    Write(file, (unsigned int)value.size());
+    file.write(value.data(), value.size());
+  }
+
+  template <typename T> void Read(std::ifstream &file, T &value) {
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+  }
+
+  void ReadString(std::ifstream &file, std::string &value) {
+    unsigned int size = 0;
+    Read(file, size);
+    if (!file || size > 65536) {
+      file.setstate(std::ios::failbit);
+      return;
+    }
+    value.resize(size);
+    file.read(&value[0], size);
+  }
+
+  bool IsSimulationSetting(const std::string &key) {
+    return key.compare(0, 9, "gameplay_") == 0 || key == "match_duration" || key == "match_difficulty";
+  }
+
+}
+
+MatchInputLog::MatchInputLog() : recording(false), replaying(false), seed(0), recordedControllers(0), divergedTick(-1) {
+  for (int teamID = 0; teamID < 2; teamID++) teams[teamID].databaseID = 0;
+}
+
+MatchInputLog::~MatchInputLog() {
+  for (unsigned int i = 0; i < tickControllers.size(); i++) delete tickControllers.at(i);
+  tickControllers.clear();
+}
+
+void MatchInputLog::StartRecording(const std::string &filename, unsigned int seed, MatchData *matchData, const Properties &config, const std::vector<IHIDevice*> &controllers) {
+  recording = true;
+  this->filename = filename;
+  this->seed = seed;
+
+  for (int teamID = 0; teamID < 2; teamID++) {
+    TeamData *teamData = matchData->GetTeamData(teamID);
+    MatchInputLogTeam &team = teams[teamID];
+    team.databaseID = teamData->GetDatabaseID();
+    for (int i = 0; i < teamData->GetPlayerNum(); i++) team.playerDatabaseIDs.push_back(teamData->GetPlayerData(i)->GetDatabaseID());
+    for (int i = 0; i < playerNum; i++) team.formation.push_back(teamData->GetFormationEntry(i));
+    const map_Properties *tactics = teamData->GetTactics().userProperties.GetProperties();
+    team.tactics.assign(tactics->begin(), tactics->end());
+  }
+
+  const map_Properties *properties = config.GetProperties();
+  for (map_Properties::const_iterator iter = properties->begin(); iter != properties->end(); iter++) {
+    if (IsSimulationSetting((*iter).first)) settings.push_back(*iter);
+  }
+
+  recordedControllers = &controllers;
+  for (unsigned int i = 0; i < controllers.size(); i++) {
+    deviceTypes.push_back(controllers.at(i)->GetDeviceType());
+    deviceIdentifiers.push_back(controllers.at(i)->GetIdentifier());
+    tickControllers.push_back(new HIDReplay(controllers.at(i)->GetDeviceType(), controllers.at(i)->GetIdentifier()));
+  }
+
+  Log(e_Notice, "MatchInputLog", "StartRecording", "Recording match input to " + filename + " (seed " + int_to_str(seed) + ")");
+}
+
+void MatchInputLog::RecordControllerSetup(unsigned long tick, const std::vector<SideSelection> &sides) {
+  MatchInputLogSetup setup;
+  setup.tick = tick;
+  setup.sides = sides;
+  // several changes before the same tick: only the last one counts
+  if (!setups.empty() && setups.back().tick == tick) setups.back() = setup; else setups.push_back(setup);
+}
+
+void MatchInputLog::RecordTick(unsigned long tick, bool pause, unsigned int checksum) {
+  assert(tick == ticks.size());
+
+  MatchInputLogTick logTick;
+  logTick.pause = pause;
+  logTick.checksum = checksum;
+  ticks.push_back(logTick);
+
+  for (unsigned int i = 0; i < recordedControllers->size(); i++) {
+    IHIDevice *controller = recordedControllers->at(i);
+    MatchInputLogDeviceState state;
+    state.buttons = 0;
+    state.previousButtons = 0;
+    for (int b = 0; b < e_ButtonFunction_Size; b++) {
+      if (controller->GetButton((e_ButtonFunction)b)) state.buttons |= (1 << b);
+      if (controller->GetPreviousButtonState((e_ButtonFunction)b)) state.previousButtons |= (1 << b);
+    }
+    Vector3 direction = controller->GetDirection();
+    for (int c = 0; c < 3; c++) state.direction[c] = direction.coords[c];
+    deviceStates.push_back(state);
+
+    // this tick plays with what was recorded, not with whatever the device says by the time the gamers get to it
+    static_cast<HIDReplay*>(tickControllers.at(i))->SetState(state.buttons, state.previousButtons, Vector3(state.direction[0], state.direction[1], state.direction[2]));
+  }
+}
+
+bool MatchInputLog::Save() const {
+  std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+  if (!file) {
+    Log(e_Error, "MatchInputLog", "Save", "Could not open " + filename);
+    return false;
+  }
+
+  file.write(magic, 4);
+  Write(file, version);
+  Write(file, seed);
+
+  for (int teamID = 0; teamID < 2; teamID++) {
+    const MatchInputLogTeam &team = teams[teamID];
+    Write(file, team.databaseID);
+    Write(file, (unsigned int)team.playerDatabaseIDs.size());
+    for (unsigned int i = 0; i < team.playerDatabaseIDs.size(); i++) Write(file, team.playerDatabaseIDs.at(i));
+    Write(file, (unsigned int)team.formation.size());
+    for (unsigned int i = 0; i < team.formation.size(); i++) {
+      const FormationEntry &entry = team.formation.at(i);
+      Write(file, (int)entry.role);
+      for (int c = 0; c < 3; c++) Write(file, entry.databasePosition.coords[c]);
+      for (int c = 0; c < 3; c++) Write(file, entry.position.coords[c]);
+    }
+    Write(file, (unsigned int)team.tactics.size());
+    for (unsigned int i = 0; i < team.tactics.size(); i++) {
+      WriteString(file, team.tactics.at(i).first);
+      WriteString(file, team.tactics.at(i).second);
+    }
+  }
+
+  Write(file, (unsigned int)settings.size());
+  for (unsigned int i = 0; i < settings.size(); i++) {
+    WriteString(file, settings.at(i).first);
+    WriteString(file, settings.at(i).second);
+  }
+
+  Write(file, (unsigned int)deviceTypes.size());
+  for (unsigned int i = 0; i < deviceTypes.size(); i++) {
+    Write(file, deviceTypes.at(i));
+    WriteString(file, deviceIdentifiers.at(i));
+  }
+
+  Write(file, (unsigned int)setups.size());
+  for (unsigned int i = 0; i < setups.size(); i++) {
+    const MatchInputLogSetup &setup = setups.at(i);
+    Write(file, (unsigned int)setup.tick);
+    Write(file, (unsigned int)setup.sides.size());
+    for (unsigned int s = 0; s < setup.sides.size(); s++) {
+      Write(file, setup.sides.at(s).controllerID);
+      Write(file, setup.sides.at(s).side);
+    }
+  }
+
+  Write(file, (unsigned int)ticks.size());
+  unsigned int deviceCount = deviceTypes.size();
+  for (unsigned int t = 0; t < ticks.size(); t++) {
+    Write(file, (unsigned char)ticks.at(t).pause);
+    Write(file, ticks.at(t).checksum);
+    for (unsigned int d = 0; d < deviceCount; d++) {
+      const MatchInputLogDeviceState &state = deviceStates.at(t * deviceCount + d);
+      Write(file, state.buttons);
+      Write(file, state.previousButtons);
+      for (int c = 0; c < 3; c++) Write(file, state.direction[c]);
+    }
+  }
+
+  file.close();
+  if (!file) {
+    Log(e_Error, "MatchInputLog", "Save", "Could not write " + filename);
+    return false;
+  }
+
+  Log(e_Notice, "MatchInputLog", "Save", "Wrote " + int_to_str(ticks.size()) + " ticks of match input to " + filename);
+  return true;
+}
+
+bool MatchInputLog::Load(const std::string &filename) {
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!file) {
+    Log(e_Error, "MatchInputLog", "Load", "Could not open " + filename);
+    return false;
+  }
+
+  char fileMagic[4] = { 0, 0, 0, 0 };
+  file.read(fileMagic, 4);
+  unsigned int fileVersion = 0;
+  Read(file, fileVersion);
+  if (!file || memcmp(fileMagic, magic, 4) != 0 || fileVersion != version) {
+    Log(e_Error, "MatchInputLog", "Load", filename + " is not a match input log (of this version)");
+    return false;
+  }
+
+  this->filename = filename;
+  Read(file, seed);
+
+  unsigned int count = 0;
+  for (int teamID = 0; teamID < 2; teamID++) {
+    MatchInputLogTeam &team = teams[teamID];
+    Read(file, team.databaseID);
+    Read(file, count);
+    team.playerDatabaseIDs.resize(file ? count : 0);
+    for (unsigned int i = 0; i < team.playerDatabaseIDs.size(); i++) Read(file, team.playerDatabaseIDs.at(i));
+    Read(file, count);
+    team.formation.resize(file ? count : 0);
+    for (unsigned int i = 0; i < team.formation.size(); i++) {
+      FormationEntry &entry = team.formation.at(i);
+      int role = 0;
+      Read(file, role);
+      entry.role = (e_PlayerRole)role;
+      for (int c = 0; c < 3; c++) Read(file, entry.databasePosition.coords[c]);
+      for (int c = 0; c < 3; c++) Read(file, entry.position.coords[c]);
+    }
+    Read(file, count);
+    team.tactics.resize(file ? count : 0);
+    for (unsigned int i = 0; i < team.tactics.size(); i++) {
+      ReadString(file, team.tactics.at(i).first);
+      ReadString(file, team.tactics.at(i).second);
+    }
+  }
+
+  Read(file, count);
+  settings.resize(file ? count : 0);
+  for (unsigned int i = 0; i < settings.size(); i++) {
+    ReadString(file, settings.at(i).first);
+    ReadString(file, settings.at(i).second);
+  }
+
+  Read(file, count);
+  deviceTypes.resize(file ? count : 0);
+  deviceIdentifiers.resize(deviceTypes.size());
+  for (unsigned int i = 0; i < deviceTypes.size(); i++) {
+    Read(file, deviceTypes.at(i));
+    ReadString(file, deviceIdentifiers.at(i));
+  }
+
+  Read(file, count);
+  setups.resize(file ? count : 0);
+  for (unsigned int i = 0; i < setups.size(); i++) {
+    MatchInputLogSetup &setup = setups.at(i);
+    unsigned int tick = 0;
+    Read(file, tick);
+    setup.tick = tick;
+    Read(file, count);
+    setup.sides.resize(file ? count : 0);
+    for (unsigned int s = 0; s < setup.sides.size(); s++) {
+      setup.sides.at(s).controllerImage = 0;
+      Read(file, setup.sides.at(s).controllerID);
+      Read(file, setup.sides.at(s).side);
+    }
+  }
+
+  Read(file, count);
+  ticks.resize(file ? count : 0);
+  unsigned int deviceCount = deviceTypes.size();
+  deviceStates.resize(ticks.size() * deviceCount);
+  for (unsigned int t = 0; t < ticks.size(); t++) {
+    unsigned char pause = 0;
+    Read(file, pause);
+    ticks.at(t).pause = pause != 0;
+    Read(file, ticks.at(t).checksum);
+    for (unsigned int d = 0; d < deviceCount; d++) {
+      MatchInputLogDeviceState &state = deviceStates.at(t * deviceCount + d);
+      Read(file, state.buttons);
+      Read(file, state.previousButtons);
+      for (int c = 0; c < 3; c++) Read(file, state.direction[c]);
+    }
+  }
+
+  if (!file) {
+    Log(e_Error, "MatchInputLog", "Load", filename + " is truncated");
+    return false;
+  }
+
+  for (unsigned int i = 0; i < deviceTypes.size(); i++) {
+    tickControllers.push_back(new HIDReplay((e_HIDeviceType)deviceTypes.at(i), deviceIdentifiers.at(i)));
+  }
+
+  replaying = true;
+  Log(e_Notice, "MatchInputLog", "Load", "Replaying " + int_to_str(ticks.size()) + " ticks of match input from " + filename + " (seed " + int_to_str(seed) + ")");
+  return true;
+}
+
+MatchData *MatchInputLog::CreateMatchData() const {
+  MatchData *matchData = new MatchData(teams[0].databaseID, teams[1].databaseID);
+
+  for (int teamID = 0; teamID < 2; teamID++) {
+    const MatchInputLogTeam &team = teams[teamID];
+    TeamData *teamData = matchData->GetTeamData(teamID);
+
+    // lineup: swap the recorded players into place, one index at a time
+    for (unsigned int i = 0; i < team.playerDatabaseIDs.size() && (int)i < teamData->GetPlayerNum(); i++) {
+      int currentID = teamData->GetPlayerData(i)->GetDatabaseID();
+      int recordedID = team.playerDatabaseIDs.at(i);
+      if (currentID == recordedID) continue;
+      bool found = false;
+      for (int p = 0; p < teamData->GetPlayerNum(); p++) if (teamData->GetPlayerData(p)->GetDatabaseID() == recordedID) found = true;
+      if (found) {
+        teamData->SwitchPlayers(currentID, recordedID);
+      } else {
+        Log(e_Warning, "MatchInputLog", "CreateMatchData", "Player " + int_to_str(recordedID) + " is no longer in team " + int_to_str(team.databaseID) + "; the replay will diverge");
+      }
+    }
+
+    for (unsigned int i = 0; i < team.formation.size(); i++) teamData->SetFormationEntry(i, team.formation.at(i));
+
+    Properties &tactics = teamData->GetTacticsWritable().userProperties;
+    for (unsigned int i = 0; i < team.tactics.size(); i++) tactics.Set(team.tactics.at(i).first.c_str(), team.tactics.at(i).second);
+  }
+
+  return matchData;
+}
+
+void MatchInputLog::ApplyConfiguration(Properties &config) const {
+  const map_Properties *properties = config.GetProperties();
+  for (map_Properties::const_iterator iter = properties->begin(); iter != properties->end(); iter++) {
+    if (!IsSimulationSetting((*iter).first)) continue;
+    bool recorded = false;
+    for (unsigned int i = 0; i < settings.size(); i++) if (settings.at(i).first == (*iter).first) recorded = true;
+    if (!recorded) Log(e_Warning, "MatchInputLog", "ApplyConfiguration", (*iter).first + " was not set when the log was recorded; the replay may diverge");
+  }
+
+  for (unsigned int i = 0; i < settings.size(); i++) config.Set(settings.at(i).first.c_str(), settings.at(i).second);
+}
+
+bool MatchInputLog::IsControllerSetupChange(unsigned long tick) const {
+  for (unsigned int i = 0; i < setups.size(); i++) {
+    if (setups.at(i).tick == tick) return true;
+  }
+  return false;
+}
+
+const std::vector<SideSelection> &MatchInputLog::GetControllerSetup(unsigned long tick) const {
+  static const std::vector<SideSelection> none;
+  const std::vector<SideSelection> *sides = &none;
+  for (unsigned int i = 0; i < setups.size(); i++) {
+    if (setups.at(i).tick <= tick) sides = &setups.at(i).sides;
+  }
+  return *sides;
+}
+
+bool MatchInputLog::ReplayTick(unsigned long tick, bool &pause, unsigned int checksum) {
+  if (tick >= ticks.size()) return false;
+
+  const MatchInputLogTick &logTick = ticks.at(tick);
+  pause = logTick.pause;
+
+  if (logTick.checksum != checksum && divergedTick == -1) {
+    divergedTick = tick;
+    Log(e_Warning, "MatchInputLog", "ReplayTick", "Replay diverged from the recording at tick " + int_to_str(tick));
+  }
+
+  unsigned int deviceCount = tickControllers.size();
+  for (unsigned int d = 0; d < deviceCount; d++) {
+    const MatchInputLogDeviceState &state = deviceStates.at(tick * deviceCount + d);
+    static_cast<HIDReplay*>(tickControllers.at(d))->SetState(state.buttons, state.previousButtons, Vector3(state.direction[0], state.direction[1], state.direction[2]));
+  }
+
+  return true;
+}
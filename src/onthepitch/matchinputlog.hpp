@@ -0,0 +1,106 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_MATCHINPUTLOG
+#define _HPP_MATCHINPUTLOG
+
+#include "defines.hpp"
+
+#include "../gamedefines.hpp"
+#include "../menu/menutask.hpp"
+
+#include "base/properties.hpp"
+
+class IHIDevice;
+class MatchData;
+
+struct MatchInputLogTeam {
+  int databaseID;
+  std::vector<int> playerDatabaseIDs; // lineup order
+  std::vector<FormationEntry> formation;
+  std::vector< std::pair<std::string, std::string> > tactics; // user tactics properties
+};
+
+struct MatchInputLogDeviceState {
+  unsigned int buttons; // bit n == e_ButtonFunction n
+  unsigned int previousButtons;
+  float direction[3];
+};
+
+struct MatchInputLogTick {
+  bool pause;
+  unsigned int checksum; // of the simulation state at the start of this tick
+};
+
+struct MatchInputLogSetup {
+  unsigned long tick; // applies from the start of this tick on
+  std::vector<SideSelection> sides;
+};
+
+// everything that goes into a match from the outside: random seed, match setup, gameplay settings, and the state of every
+// controller at the start of every tick. the simulation itself only depends on those (and runs on the tick clock), so a
+// replayed log re-simulates the match bit for bit. the human gamers never read the keyboard and gamepads themselves: while
+// recording, they read HIDReplay copies of them, taken once at the start of every tick (the live devices keep changing
+// during the tick), and while replaying, HIDReplay devices set from the log.
+// every tick also stores a checksum of the simulation state, so replays can tell where they stopped being identical
+class MatchInputLog {
+
+  public:
+    MatchInputLog();
+    virtual ~MatchInputLog();
+
+    // recording
+
+    void StartRecording(const std::string &filename, unsigned int seed, MatchData *matchData, const Properties &config, const std::vector<IHIDevice*> &controllers);
+    void RecordControllerSetup(unsigned long tick, const std::vector<SideSelection> &sides);
+    void RecordTick(unsigned long tick, bool pause, unsigned int checksum);
+    bool Save() const;
+
+    // replaying
+
+    bool Load(const std::string &filename);
+
+    /// new match data, set up like the recorded match's was
+    MatchData *CreateMatchData() const;
+    /// overwrites the settings the simulation depends on with the recorded ones
+    void ApplyConfiguration(Properties &config) const;
+    /// what the human gamers read, instead of the live devices: the per-tick copies while recording, the log's while replaying
+    const std::vector<IHIDevice*> &GetControllers() const { return tickControllers; }
+
+    bool IsControllerSetupChange(unsigned long tick) const;
+    const std::vector<SideSelection> &GetControllerSetup(unsigned long tick) const;
+
+    /// sets the replay controllers to their state at the start of this tick. false if the log does not go this far
+    bool ReplayTick(unsigned long tick, bool &pause, unsigned int checksum);
+
+    bool IsRecording() const { return recording; }
+    bool IsReplaying() const { return replaying; }
+    unsigned int GetSeed() const { return seed; }
+    unsigned long GetTickCount() const { return ticks.size(); }
+    /// first tick at which a replay's state did not match the recorded one, or -1
+    long GetDivergedTick() const { return divergedTick; }
+
+  protected:
+    bool recording;
+    bool replaying;
+    std::string filename;
+
+    unsigned int seed;
+    MatchInputLogTeam teams[2];
+    std::vector< std::pair<std::string, std::string> > settings;
+    std::vector<int> deviceTypes;
+    std::vector<std::string> deviceIdentifiers;
+
+    std::vector<MatchInputLogSetup> setups;
+    std::vector<MatchInputLogTick> ticks;
+    std::vector<MatchInputLogDeviceState> deviceStates; // [tick * deviceCount + device]
+
+    const std::vector<IHIDevice*> *recordedControllers;
+    std::vector<IHIDevice*> tickControllers; // HIDReplay
+
+    long divergedTick;
+
+};
+
+#endif
@@ -501,7 +501,7 @@ Vector3 ElizaController::GetSupportPosition(const MentalImage *mentalImage, cons
   // get closest opponents
 
   std::vector<Player*> opponents;
-  std::vector<PlayerImage> opponentImages;
+  PlayerImages opponentImages(TickArena::GetCurrent());
   AI_GetClosestPlayers(match->GetTeam(abs(team->GetID() - 1)), playerPos, false, opponents, 4);
   for (unsigned int i = 0; i < opponents.size(); i++) {
     PlayerImage oppImage = mentalImage->GetPlayerImage(opponents.at(i)->GetID());
@@ -806,13 +806,13 @@ void ElizaController::Reset() {
   lastDesiredVelocity = 0;
 }
 
-void ElizaController::GetOnTheBallCommands(std::vector<PlayerCommand> &commandQueue, Vector3 &rawInputDirection, float &rawInputVelocityFloat) {
+void ElizaController::GetOnTheBallCommands(PlayerCommandQueue &commandQueue, Vector3 &rawInputDirection, float &rawInputVelocityFloat) {
 
   float oneTouchIsHard = 0.0f;
   float movementDiff = NormalizedClamp((match->GetBall()->GetMovement() - CastPlayer()->GetMovement()).GetLength(), 0.0f, 10.0f);
   oneTouchIsHard = movementDiff - CastPlayer()->GetStat("technical_shortpass") * movementDiff * 0.8f;
 
-  std::vector<PlayerImage> opponentPlayerImages;
+  PlayerImages opponentPlayerImages(TickArena::GetCurrent());
   _mentalImage->GetTeamPlayerImages(abs(team->GetID() - 1), -1, opponentPlayerImages);
 
 
@@ -851,7 +851,7 @@ void ElizaController::GetOnTheBallCommands(std::vector<PlayerCommand> &commandQu
   tacticalRating /= totalWeight1;
 
   // collect pass target candidates
-  std::vector<Player*> mates;
+  TickVector<Player*> mates(TickArena::GetCurrent());
   team->GetActivePlayers(mates);
 
   struct MateRating {
@@ -976,7 +976,7 @@ void ElizaController::GetOnTheBallCommands(std::vector<PlayerCommand> &commandQu
   AI_GetBestDribbleMovement(match, player->GetID(), _mentalImage, rawInputDirection, rawInputVelocityFloat, team->GetTeamData()->GetTactics());
 }
 
-void ElizaController::_AddPass(std::vector<PlayerCommand> &commandQueue, Player *target, e_FunctionType passType) {
+void ElizaController::_AddPass(PlayerCommandQueue &commandQueue, Player *target, e_FunctionType passType) {
   PlayerCommand command;
   command.desiredFunctionType = passType;
   command.useDesiredMovement = false;
@@ -991,7 +991,7 @@ void ElizaController::_AddPass(std::vector<PlayerCommand> &commandQueue, Player
   commandQueue.push_back(command);
 }
 
-void ElizaController::_AddPanicPass(std::vector<PlayerCommand> &commandQueue) {
+void ElizaController::_AddPanicPass(PlayerCommandQueue &commandQueue) {
 
   int yside = signSide(player->GetDirectionVec().coords[1]); // > 0 ? 1 : -1;
   Vector3 sensibleAwayDir = ((player->GetDirectionVec() * Vector3(0.8f, 1.0f, 0.0f)).GetNormalized() + Vector3(-team->GetSide() * 0.7f, yside * 0.5f, 0)).GetNormalized(0) + Vector3(0, 0, 0.3f);
@@ -1022,7 +1022,7 @@ void ElizaController::_AddPanicPass(std::vector<PlayerCommand> &commandQueue) {
   commandQueue.push_back(command);
 }
 
-float ElizaController::_GetPassingOdds(Player *targetPlayer, e_FunctionType passType, const std::vector<PlayerImage> &opponentPlayerImages, float ballVelocityMultiplier) {
+float ElizaController::_GetPassingOdds(Player *targetPlayer, e_FunctionType passType, const PlayerImages &opponentPlayerImages, float ballVelocityMultiplier) {
 
   float initialTargetDistance = (targetPlayer->GetPosition() - player->GetPosition()).GetLength();
   if (passType == e_FunctionType_HighPass && initialTargetDistance < 10.0f) return 0.0f;
@@ -1034,7 +1034,7 @@ float ElizaController::_GetPassingOdds(Player *targetPlayer, e_FunctionType pass
   return _GetPassingOdds(target, passType, opponentPlayerImages, ballVelocityMultiplier);
 }
 
-float ElizaController::_GetPassingOdds(const Vector3 &target, e_FunctionType passType, const std::vector<PlayerImage> &opponentPlayerImages, float ballVelocityMultiplier) {
+float ElizaController::_GetPassingOdds(const Vector3 &target, e_FunctionType passType, const PlayerImages &opponentPlayerImages, float ballVelocityMultiplier) {
 
   float secondScale = 1.0f; // how many seconds of range to measure danger in
 
@@ -1076,7 +1076,7 @@ float ElizaController::_GetPassingOdds(const Vector3 &target, e_FunctionType pas
   return odds;
 }
 
-void ElizaController::_AddCelebration(std::vector<PlayerCommand> &commandQueue) {
+void ElizaController::_AddCelebration(PlayerCommandQueue &commandQueue) {
 
   signed int xSide = (match->GetBall()->Predict(0).Get2D().coords[0] > 0) ? 1 : -1;
   signed int ySide = team->GetSide();
@@ -51,13 +51,13 @@ class ElizaController : public PlayerController {
     virtual void Reset();
 
   protected:
-    void GetOnTheBallCommands(std::vector<PlayerCommand> &commandQueue, Vector3 &rawInputDirection, float &rawInputVelocity);
+    void GetOnTheBallCommands(PlayerCommandQueue &commandQueue, Vector3 &rawInputDirection, float &rawInputVelocity);
 
-    void _AddPass(std::vector<PlayerCommand> &commandQueue, Player *target, e_FunctionType passType);
-    void _AddPanicPass(std::vector<PlayerCommand> &commandQueue);
-    float _GetPassingOdds(Player *targetPlayer, e_FunctionType passType, const std::vector<PlayerImage> &opponentPlayerImages, float ballVelocityMultiplier = 1.0f);
-    float _GetPassingOdds(const Vector3 &target, e_FunctionType passType, const std::vector<PlayerImage> &opponentPlayerImages, float ballVelocityMultiplier = 1.0f);
-    void _AddCelebration(std::vector<PlayerCommand> &commandQueue);
+    void _AddPass(PlayerCommandQueue &commandQueue, Player *target, e_FunctionType passType);
+    void _AddPanicPass(PlayerCommandQueue &commandQueue);
+    float _GetPassingOdds(Player *targetPlayer, e_FunctionType passType, const PlayerImages &opponentPlayerImages, float ballVelocityMultiplier = 1.0f);
+    float _GetPassingOdds(const Vector3 &target, e_FunctionType passType, const PlayerImages &opponentPlayerImages, float ballVelocityMultiplier = 1.0f);
+    void _AddCelebration(PlayerCommandQueue &commandQueue);
 
     Strategy *defenseStrategy;
     Strategy *midfieldStrategy;
@@ -161,14 +161,14 @@ Vector3 PlayerController::GetDefendPosition(Player *opp, float distance) {
   midToOppPerpendicularLine.SetVertex(1, midPoint + (meToOppLine.GetVertex(0) - midPoint).GetRotated2D(0.5 * pi));
   // 3
   float u;
-  Vector3 intersect = oppToGoalLine.GetIntersectionPoint(midToOppPerpendicularLine, u);
+  oppToGoalLine.GetIntersectionPoint(midToOppPerpendicularLine, u);
 
   u = clamp(u, 0.0f, 1.0f);
   Vector3 target = oppToGoalLine.GetVertex(0) + (oppToGoalLine.GetVertex(1) - oppToGoalLine.GetVertex(0)) * u;
 
 /*
   if (player->GetDebug()) {
-    SetRedDebugPilon(intersect + Vector3(0, 0, 0.1f));
+    SetRedDebugPilon(oppToGoalLine.GetIntersectionPoint(midToOppPerpendicularLine) + Vector3(0, 0, 0.1f));
     SetBlueDebugPilon(target);
   }
 */
@@ -395,7 +395,6 @@ void PlayerController::_SlidingCommand(PlayerCommandQueue &commandQueue) {
 
     Vector3 ballPos = match->GetMentalImage(20)->GetBallPrediction(200);
     Vector3 playerPos = player->GetPosition() + player->GetMovement() * 0.2;
-    Vector3 oppPos = _oppPlayer->GetPosition() + _oppPlayer->GetMovement() * 0.2;
 
     float ballDist = (playerPos - ballPos).GetLength();
     if ((ballDist > 0.7f && ballDist < 1.6f && oppTimeNeededToGetToBall > 260) || (ballDist > 0.6f && ballDist < 1.8f && _oppPlayer->GetCurrentFunctionType() == e_FunctionType_Shot && _oppPlayer->TouchPending())) {
@@ -7,6 +7,7 @@
 #include "utils/directoryparser.hpp"
 
 #include "utils/animationextensions/footballanimationextension.hpp"
+#include "utils/animationcache.hpp"
 
 #include "managers/resourcemanagerpool.hpp"
 
@@ -19,6 +20,12 @@
 
 #include "main.hpp"
 
+#include "base/profiler.hpp"
+#include "managers/taskmanager.hpp"
+
+#include <fstream>
+#include <cstdio>
+
 void FillNodeMap(boost::intrusive_ptr<Node> targetNode, std::map < const std::string, boost::intrusive_ptr<Node> > &nodeMap) {
   //printf("%s\n", targetNode->GetName().c_str());
   nodeMap.insert(std::pair < std::string, boost::intrusive_ptr<Node> >(targetNode->GetName(), targetNode));
@@ -119,6 +126,14 @@ void AnimCollection::Clear() {
     animIter++;
   }
   animations.clear();
+  selectionInfo.clear();
+  for (int functionType = 0; functionType < functionTypeCount; functionType++) {
+    for (int incomingVelocity = 0; incomingVelocity < velocityCount; incomingVelocity++) {
+      for (int outgoingVelocity = 0; outgoingVelocity < velocityCount; outgoingVelocity++) {
+        selectionIndex[functionType][incomingVelocity][outgoingVelocity].clear();
+      }
+    }
+  }
 }
 
 radian GetAngle(int directionID) {
@@ -350,53 +365,97 @@ void GenerateAutoAnims(const std::vector<Animation*> &templates, std::vector<Ani
   Log(e_Notice, "AnimCollection", "GenerateAutoAnims", int_to_str(autoAnims.size()) + " autogenerated anims! huzzah!");
 }
 
+void BakeAnimations(const std::vector<Animation*> &animations, int begin, int end) {
+  for (int i = begin; i < end; i++) {
+    animations.at(i)->Bake();
+  }
+}
+
 void AnimCollection::Load(boost::filesystem::path directory) {
 
+  StageTimer timer("AnimCollection", "Load");
 
-  // load utility player to get things like foot position in the frames around the balltouch etc.
+  timer.Stage("parsing directories");
 
-  Log(e_Notice, "AnimCollection", "Load", "Loading utility player");
+  Log(e_Notice, "AnimCollection", "Load", "Parsing animation directories");
 
-  ObjectLoader loader;
-  boost::intrusive_ptr<Node> playerNode;
-  playerNode = loader.LoadObject(scene3D, "media/objects/players/player.object");
-  playerNode->SetName("player");
-  playerNode->SetLocalMode(e_LocalMode_Absolute);
+  DirectoryParser parser;
+  std::vector<std::string> templateFiles;
+  parser.Parse(directory / "/templates", "anim", templateFiles);
+  std::vector<std::string> files;
+  parser.Parse(directory, "anim", files);
 
-  std::list < boost::intrusive_ptr<Object> > bodyParts;
-  playerNode->GetObjects(e_ObjectType_Geometry, bodyParts, true);
 
-  std::map < const std::string, boost::intrusive_ptr<Node> > nodeMap;
-  FillNodeMap(playerNode, nodeMap);
+  // prepared animations from the cache, if their sources haven't changed since it was written
 
+  timer.Stage("hashing sources");
 
-  // base anim with default angles - all anims' joints will be inversely rotated by the joints in this anim. this way, the fullbody mesh doesn't need to have 0 degree angles
+  const std::string cacheFilename = GetConfiguration()->Get("animation_cache", "animations.cache");
+  unsigned int sourceHash = _HashSources(templateFiles, files);
 
-/*
-  Animation *baseAnim = new Animation();
-  baseAnim->Load("media/animations/base.anim.util");
-*/
+  timer.Stage("loading cache");
 
+  if (cacheFilename.empty() || !_LoadCache(cacheFilename, sourceHash)) {
+    _PrepareAnims(templateFiles, files, timer);
+    timer.Stage("writing cache");
+    if (!cacheFilename.empty()) _SaveCache(cacheFilename, sourceHash);
+  }
 
-  // auto generated anims
+  timer.Stage("baking");
 
-  Log(e_Notice, "AnimCollection", "Load", "Parsing autogenerated animation template directory");
+  Log(e_Notice, "AnimCollection", "Load", "Baking animations");
 
-  DirectoryParser parser;
+  TaskManager::GetInstance().ParallelFor(animations.size(), 16, boost::bind(&BakeAnimations, boost::cref(animations), _1, _2));
+
+  timer.Stage("building selection index");
+
+  Log(e_Notice, "AnimCollection", "Load", "Building selection index");
+
+  _BuildSelectionIndex();
+
+  Log(e_Notice, "AnimCollection", "Load", "Ready");
+
+  timer.Report();
+}
+
+// a skeleton to try animations on while preparing them, to get things like foot position in the frames around the balltouch etc.
+// applying an animation poses it, so every thread preparing animations needs one of its own
+struct AnimUtilityPlayer {
+  boost::intrusive_ptr<Node> playerNode;
+  std::list < boost::intrusive_ptr<Object> > bodyParts;
+  std::map < const std::string, boost::intrusive_ptr<Node> > nodeMap;
+};
+
+struct AnimPrepareContext {
+  // every source yields two animations, at prepared[2 * source] and prepared[2 * source + 1]: an auto anim (mirrored first),
+  // or the file with the same index, minus autoAnims.size() (mirrored second)
+  std::vector<Animation*> autoAnims;
   std::vector<std::string> files;
-  parser.Parse(directory / "/templates", "anim", files);
+  std::vector<Animation*> prepared;
+
+  boost::mutex utilityPlayerMutex;
+  std::vector<AnimUtilityPlayer*> idleUtilityPlayers;
+};
+
+void AnimCollection::_PrepareAnims(const std::vector<std::string> &templateFiles, const std::vector<std::string> &files, StageTimer &timer) {
+
+  AnimPrepareContext context;
+
 
-  Log(e_Notice, "AnimCollection", "Load", "Loading autogenerated animation templates");
+  // auto generated anims
+
+  timer.Stage("generating auto anims");
+
+  Log(e_Notice, "AnimCollection", "_PrepareAnims", "Loading autogenerated animation templates");
 
   std::vector<Animation*> templates;
-  for (unsigned int i = 0; i < files.size(); i++) {
+  for (unsigned int i = 0; i < templateFiles.size(); i++) {
     Animation *animTemplate = new Animation();
-    animTemplate->Load(files.at(i));
+    animTemplate->Load(templateFiles.at(i));
     templates.push_back(animTemplate);
   }
 
-  std::vector<Animation*> autoAnims;
-  GenerateAutoAnims(templates, autoAnims);
+  GenerateAutoAnims(templates, context.autoAnims);
   std::vector < Animation* >::iterator animIter = templates.begin();
   while (animIter != templates.end()) {
     delete *animIter;
@@ -404,50 +463,114 @@ void AnimCollection::Load(boost::filesystem::path directory) {
   }
   templates.clear();
 
-  for (unsigned int i = 0; i < autoAnims.size(); i++) {
-    Animation *animation = new Animation(*autoAnims.at(i));
-    boost::shared_ptr<FootballAnimationExtension> extension(new FootballAnimationExtension(animation));
-    animation->AddExtension("football", extension);
-    animation->Mirror();
-    _PrepareAnim(animation, playerNode, bodyParts, nodeMap, false);
 
-    animation = autoAnims.at(i);
-    extension.reset(new FootballAnimationExtension(animation));
-    animation->AddExtension("football", extension);
-    _PrepareAnim(animation, playerNode, bodyParts, nodeMap, false);
+  // all other animations
+
+  bool omitLuxuryAnims = true;
+
+  for (unsigned int i = 0; i < files.size(); i++) {
+    if ((omitLuxuryAnims && files.at(i).find("luxury") != std::string::npos) || files.at(i).find("templates") != std::string::npos) continue;
+    context.files.push_back(files.at(i));
   }
 
 
-  // load all other animations
+  // one utility player per thread that can be preparing at the same time
 
-  Log(e_Notice, "AnimCollection", "Load", "Parsing animation directory");
+  timer.Stage("loading utility players");
 
-  files.clear();
-  parser.Parse(directory, "anim", files);
+  int sourceCount = context.autoAnims.size() + context.files.size();
+  const int grainSize = 4;
+  int chunkCount = (sourceCount + grainSize - 1) / grainSize;
+  int utilityPlayerCount = std::max(1, std::min(chunkCount, TaskManager::GetInstance().GetWorkerThreadCount() + 1));
 
-  Log(e_Notice, "AnimCollection", "Load", "Loading animations");
+  Log(e_Notice, "AnimCollection", "_PrepareAnims", "Loading " + int_to_str(utilityPlayerCount) + " utility players");
 
-  bool omitLuxuryAnims = true;
+  ObjectLoader loader;
+  std::vector<AnimUtilityPlayer*> utilityPlayers;
+  for (int i = 0; i < utilityPlayerCount; i++) {
+    AnimUtilityPlayer *utilityPlayer = new AnimUtilityPlayer();
+    utilityPlayer->playerNode = loader.LoadObject(scene3D, "media/objects/players/player.object");
+    utilityPlayer->playerNode->SetName("player");
+    utilityPlayer->playerNode->SetLocalMode(e_LocalMode_Absolute);
+    utilityPlayer->playerNode->GetObjects(e_ObjectType_Geometry, utilityPlayer->bodyParts, true);
+    FillNodeMap(utilityPlayer->playerNode, utilityPlayer->nodeMap);
+    utilityPlayers.push_back(utilityPlayer);
+  }
+  context.idleUtilityPlayers = utilityPlayers;
 
-  for (unsigned int i = 0; i < files.size(); i++) {
 
-    //printf("%s\n", files.at(i).c_str());
+  // base anim with default angles - all anims' joints will be inversely rotated by the joints in this anim. this way, the fullbody mesh doesn't need to have 0 degree angles
+
+/*
+  Animation *baseAnim = new Animation();
+  baseAnim->Load("media/animations/base.anim.util");
+*/
+
+
+  timer.Stage("preparing anims");
+
+  Log(e_Notice, "AnimCollection", "_PrepareAnims", "Loading and preparing " + int_to_str(sourceCount * 2) + " animations on " + int_to_str(utilityPlayerCount) + " threads");
+
+  context.prepared.resize(sourceCount * 2, 0);
+  TaskManager::GetInstance().ParallelFor(sourceCount, grainSize, boost::bind(&AnimCollection::_PrepareAnimSources, this, &context, _1, _2));
+
+  // in source order, whatever order they were prepared in
+  animations.insert(animations.end(), context.prepared.begin(), context.prepared.end());
+
+  //Log(e_Notice, "AnimCollection", "_PrepareAnims", "Deleting base anim");
+
+  //delete baseAnim;
+
+  Log(e_Notice, "AnimCollection", "_PrepareAnims", "Deleting player node templates");
+
+  for (unsigned int i = 0; i < utilityPlayers.size(); i++) {
+    utilityPlayers.at(i)->playerNode->Exit();
+    delete utilityPlayers.at(i);
+  }
+}
+
+void AnimCollection::_PrepareAnimSources(AnimPrepareContext *context, int begin, int end) {
+  // may run on a worker thread
+  AnimUtilityPlayer *utilityPlayer = 0;
+  {
+    boost::mutex::scoped_lock lock(context->utilityPlayerMutex);
+    assert(!context->idleUtilityPlayers.empty()); // never more chunks at a time than the task manager has threads
+    utilityPlayer = context->idleUtilityPlayers.back();
+    context->idleUtilityPlayers.pop_back();
+  }
+
+  for (int source = begin; source < end; source++) {
+
+    if (source < (signed int)context->autoAnims.size()) {
+
+      Animation *animation = new Animation(*context->autoAnims.at(source));
+      boost::shared_ptr<FootballAnimationExtension> extension(new FootballAnimationExtension(animation));
+      animation->AddExtension("football", extension);
+      animation->Mirror();
+      _PrepareAnim(animation, utilityPlayer->playerNode, utilityPlayer->bodyParts, utilityPlayer->nodeMap, false);
+      context->prepared.at(source * 2) = animation;
 
-    if ((omitLuxuryAnims && files.at(i).find("luxury") != std::string::npos) || files.at(i).find("templates") != std::string::npos) {
-      //printf ("ignoring\n");
+      animation = context->autoAnims.at(source);
+      extension.reset(new FootballAnimationExtension(animation));
+      animation->AddExtension("football", extension);
+      _PrepareAnim(animation, utilityPlayer->playerNode, utilityPlayer->bodyParts, utilityPlayer->nodeMap, false);
+      context->prepared.at(source * 2 + 1) = animation;
 
     } else {
 
-      if (Verbose()) printf("%s\n", files.at(i).c_str());
+      const std::string &filename = context->files.at(source - context->autoAnims.size());
+
+      if (Verbose()) printf("%s\n", filename.c_str());
 
       for (int mirror = 0; mirror < 2; mirror++) {
         Animation *animation = new Animation();
         boost::shared_ptr<FootballAnimationExtension> extension(new FootballAnimationExtension(animation));
         animation->AddExtension("football", extension);
-        animation->Load(files.at(i));
+        animation->Load(filename);
         if (mirror == 1) animation->Mirror();
 
-        _PrepareAnim(animation, playerNode, bodyParts, nodeMap, false);
+        _PrepareAnim(animation, utilityPlayer->playerNode, utilityPlayer->bodyParts, utilityPlayer->nodeMap, false);
+        context->prepared.at(source * 2 + mirror) = animation;
 
         /* disabled: too many side effects, should just make the most important of these manually
 
@@ -461,9 +584,9 @@ void AnimCollection::Load(boost::filesystem::path directory) {
               Animation *animation2 = new Animation();
               boost::shared_ptr<FootballAnimationExtension> extension(new FootballAnimationExtension(animation));
               animation2->AddExtension("football", extension);
-              animation2->Load(files.at(i), mirror == 0 ? false : true);
+              animation2->Load(filename, mirror == 0 ? false : true);
 
-              _PrepareAnim(animation2, playerNode, bodyParts, nodeMap, true);
+              _PrepareAnim(animation2, utilityPlayer->playerNode, utilityPlayer->bodyParts, utilityPlayer->nodeMap, true);
 
             }
           }
@@ -474,15 +597,115 @@ void AnimCollection::Load(boost::filesystem::path directory) {
 
   }
 
-  //Log(e_Notice, "AnimCollection", "Load", "Deleting base anim");
+  boost::mutex::scoped_lock lock(context->utilityPlayerMutex);
+  context->idleUtilityPlayers.push_back(utilityPlayer);
+}
 
-  //delete baseAnim;
+namespace {
 
-  Log(e_Notice, "AnimCollection", "Load", "Deleting player node template");
+  const char animCacheMagic[4] = { 'F', 'B', 'A', 'C' };
 
-  playerNode->Exit();
+  // bump this whenever the way animations are prepared changes: the cache can't tell from the sources alone
+  const unsigned int animCacheVersion = 1;
 
-  Log(e_Notice, "AnimCollection", "Load", "Ready");
+  bool ReadFile(const std::string &filename, std::vector<unsigned char> &data) {
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    data.resize(size);
+    if (size > 0) file.read(reinterpret_cast<char*>(&data[0]), size);
+    return file.good();
+  }
+
+}
+
+unsigned int AnimCollection::_HashSources(const std::vector<std::string> &templateFiles, const std::vector<std::string> &files) const {
+  // every file that goes into the prepared animations, in the order it goes in (the directory order decides the anim order)
+  std::vector<std::string> sources;
+  sources.push_back("media/objects/players/player.object");
+  sources.insert(sources.end(), templateFiles.begin(), templateFiles.end());
+  sources.insert(sources.end(), files.begin(), files.end());
+
+  unsigned int hash = animationCacheHashBasis;
+  HashAnimationCacheSource(hash, &animCacheVersion, sizeof(animCacheVersion));
+  std::vector<unsigned char> data;
+  for (unsigned int i = 0; i < sources.size(); i++) {
+    if (!ReadFile(sources.at(i), data)) data.clear();
+    unsigned int size = data.size();
+    HashAnimationCacheSource(hash, sources.at(i).data(), sources.at(i).size());
+    HashAnimationCacheSource(hash, &size, sizeof(size));
+    if (size > 0) HashAnimationCacheSource(hash, &data[0], size);
+  }
+  return hash;
+}
+
+bool AnimCollection::_LoadCache(const std::string &filename, unsigned int sourceHash) {
+  std::vector<unsigned char> data;
+  if (!ReadFile(filename, data)) {
+    Log(e_Notice, "AnimCollection", "_LoadCache", "No animation cache at " + filename + ", preparing animations from their sources");
+    return false;
+  }
+
+  AnimationCacheReader reader(data.empty() ? 0 : &data[0], data.size());
+  char magic[4] = { 0, 0, 0, 0 };
+  unsigned int version = 0, hash = 0, count = 0;
+  for (int i = 0; i < 4; i++) reader.Read(magic[i]);
+  reader.Read(version);
+  reader.Read(hash);
+  if (reader.Failed() || memcmp(magic, animCacheMagic, 4) != 0 || version != animCacheVersion || hash != sourceHash) {
+    Log(e_Notice, "AnimCollection", "_LoadCache", "Animation cache " + filename + " is out of date, preparing animations from their sources");
+    return false;
+  }
+
+  reader.ReadCount(count);
+  for (unsigned int i = 0; i < count && !reader.Failed(); i++) {
+    Animation *animation = new Animation();
+    boost::shared_ptr<FootballAnimationExtension> extension(new FootballAnimationExtension(animation));
+    animation->AddExtension("football", extension);
+    if (!animation->LoadCache(reader)) {
+      delete animation;
+      break;
+    }
+    animations.push_back(animation);
+  }
+
+  if (reader.Failed() || !reader.AtEnd()) {
+    Log(e_Warning, "AnimCollection", "_LoadCache", "Animation cache " + filename + " is damaged, preparing animations from their sources");
+    for (unsigned int i = 0; i < animations.size(); i++) delete animations.at(i);
+    animations.clear();
+    return false;
+  }
+
+  Log(e_Notice, "AnimCollection", "_LoadCache", "Loaded " + int_to_str(animations.size()) + " prepared animations from " + filename);
+  return true;
+}
+
+void AnimCollection::_SaveCache(const std::string &filename, unsigned int sourceHash) const {
+  AnimationCacheWriter writer;
+  for (int i = 0; i < 4; i++) writer.Write(animCacheMagic[i]);
+  writer.Write(animCacheVersion);
+  writer.Write(sourceHash);
+  writer.Write((unsigned int)animations.size());
+  for (unsigned int i = 0; i < animations.size(); i++) animations.at(i)->SaveCache(writer);
+
+  // write to a temporary file first, so a crash (or a second instance) never leaves a half written cache behind
+  const std::string temporaryFilename = filename + ".tmp";
+  std::ofstream file(temporaryFilename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (file) file.write(reinterpret_cast<const char*>(&writer.GetData()[0]), writer.GetData().size());
+  file.close();
+  bool written = file.good();
+  if (written && std::rename(temporaryFilename.c_str(), filename.c_str()) != 0) {
+    std::remove(filename.c_str()); // rename doesn't replace on every platform
+    written = std::rename(temporaryFilename.c_str(), filename.c_str()) == 0;
+  }
+  if (!written) {
+    Log(e_Warning, "AnimCollection", "_SaveCache", "Could not write animation cache " + filename);
+    std::remove(temporaryFilename.c_str());
+    return;
+  }
+
+  Log(e_Notice, "AnimCollection", "_SaveCache", "Wrote " + int_to_str(animations.size()) + " prepared animations (" + int_to_str(writer.GetData().size() / 1024) + " kb) to " + filename);
 }
 
 const std::vector < Animation* > &AnimCollection::GetAnimations() const {
@@ -494,23 +717,42 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
 
   // makes a crude selection to later refine
 
+  // only visit the index buckets that can match on function type and in/outgoing velocity (in ascending anim order, like a full scan)
+
+  std::vector<int> candidates;
+
+  int bucketCount = 0;
+  for (int functionType = 0; functionType < functionTypeCount; functionType++) {
+    if (query.byFunctionType == true && (functionType != query.functionType || functionType == e_FunctionType_None)) continue;
+    for (int incomingVelocity = 0; incomingVelocity < velocityCount; incomingVelocity++) {
+      if (query.byIncomingVelocity == true && !_CheckIncomingVelocity((e_Velocity)incomingVelocity, query)) continue;
+      for (int outgoingVelocity = 0; outgoingVelocity < velocityCount; outgoingVelocity++) {
+        if (query.byOutgoingVelocity == true && outgoingVelocity != query.outgoingVelocity) continue;
+        const std::vector<int> &bucket = selectionIndex[functionType][incomingVelocity][outgoingVelocity];
+        if (bucket.empty()) continue;
+        candidates.insert(candidates.end(), bucket.begin(), bucket.end());
+        bucketCount++;
+      }
+    }
+  }
+  if (bucketCount > 1) std::sort(candidates.begin(), candidates.end());
+
+  const std::string &querySpecialState = query.properties.Get("incoming_special_state");
+  const std::string &queryRetainState = query.properties.Get("incoming_retain_state");
+  float querySpecialVar1 = atof(query.properties.Get("specialvar1").c_str());
+  float querySpecialVar2 = atof(query.properties.Get("specialvar2").c_str());
 
-  int animSize = animations.size();
+  int candidateSize = candidates.size();
 
-  for (int i = 0; i < animSize; i++) {
+  for (int c = 0; c < candidateSize; c++) {
 
-    const std::string &animType = animations.at(i)->GetAnimType();
+    int i = candidates[c];
+    const AnimSelectionInfo &info = selectionInfo[i];
 
     bool selectAnim = true;
 
 
-    // select by TYPE
-
-    if (selectAnim) {
-      if (query.byFunctionType == true) {
-        if (_CheckFunctionType(animType, query.functionType) == false) selectAnim = false;
-      }
-    }
+    // select by TYPE, INCOMING VELOCITY (non-linear part) and OUTGOING VELOCITY: done by the index
 
 /*
     // select by FOOT
@@ -528,42 +770,21 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
     if (selectAnim) {
       if (query.byIncomingVelocity == true) {
 
-        e_Velocity animIncomingVelocity = FloatToEnumVelocity(animations.at(i)->GetIncomingVelocity());
-
         if (query.incomingVelocity_Strict == false) {
 
-          selectAnim = true;
-          if (query.incomingVelocity_NoDribbleToIdle) {
-            if (animIncomingVelocity == e_Velocity_Idle && query.incomingVelocity == e_Velocity_Dribble) selectAnim = false;
-          }
-          if (animIncomingVelocity == e_Velocity_Idle && query.incomingVelocity == e_Velocity_Walk) selectAnim = false;
-          if (animIncomingVelocity == e_Velocity_Idle && query.incomingVelocity == e_Velocity_Sprint) selectAnim = false;
-          if (animIncomingVelocity == e_Velocity_Dribble && query.incomingVelocity == e_Velocity_Idle) selectAnim = false;
-          if (animIncomingVelocity == e_Velocity_Walk && query.incomingVelocity == e_Velocity_Idle) selectAnim = false;
-          if (animIncomingVelocity == e_Velocity_Sprint && query.incomingVelocity == e_Velocity_Idle) selectAnim = false;
-
-          if (query.incomingVelocity_NoDribbleToSprint) {
-            if (animIncomingVelocity == e_Velocity_Sprint && query.incomingVelocity == e_Velocity_Dribble) selectAnim = false;
-          }
-
           if (query.incomingVelocity_ForceLinearity) {
             // disallow going from current -> slower/faster -> current; the complete section needs to be linear
-            float animIncomingVelocityFloat = RangeVelocity(animations.at(i)->GetIncomingVelocity());
-            float animOutgoingVelocityFloat = RangeVelocity(animations.at(i)->GetOutgoingVelocity());
+            float animIncomingVelocityFloat = info.linearIncomingVelocity;
+            float animOutgoingVelocityFloat = info.linearOutgoingVelocity;
             float queryVelocityFloat = EnumToFloatVelocity(query.incomingVelocity);
 
             // treat dribble and walk the same
-            if (FloatToEnumVelocity(animIncomingVelocityFloat) == e_Velocity_Dribble) animIncomingVelocityFloat = walkVelocity;
-            if (FloatToEnumVelocity(animOutgoingVelocityFloat) == e_Velocity_Dribble) animOutgoingVelocityFloat = walkVelocity;
             if (FloatToEnumVelocity(queryVelocityFloat) == e_Velocity_Dribble) queryVelocityFloat = walkVelocity;
 
             if (animIncomingVelocityFloat > std::max(queryVelocityFloat, animOutgoingVelocityFloat)) selectAnim = false;
             if (animIncomingVelocityFloat < std::min(queryVelocityFloat, animOutgoingVelocityFloat)) selectAnim = false;
           }
 
-        } else {
-          // strict
-          if (animIncomingVelocity != query.incomingVelocity) selectAnim = false;
         }
 
         // test: disallow idle -> moving and other way around
@@ -579,25 +800,16 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
     // if (animIncomingVelocity == e_Velocity_Sprint || animOutgoingVelocity == e_Velocity_Sprint) selectAnim = false;
 
 
-    // select by OUTGOING VELOCITY
-
-    if (selectAnim) {
-      if (query.byOutgoingVelocity == true) {
-        if (FloatToEnumVelocity(animations.at(i)->GetOutgoingVelocity()) != query.outgoingVelocity) selectAnim = false;
-      }
-    }
-
-
     // CULL WRONG ROTATIONAL SIDE
 
     if (selectAnim) {
       if (query.bySide == true) {
 
-        Vector3 animIncomingDirection = animations.at(i)->GetIncomingBodyDirection();
+        const Vector3 &animIncomingDirection = info.incomingBodyDirection;
 
         // find out in what direction the anim rotates
-        Vector3 animOutgoingDirection = animations.at(i)->GetOutgoingDirection().GetRotated2D(animations.at(i)->GetOutgoingBodyAngle());
-        radian animTurnAngle = animOutgoingDirection.GetAngle2D(animIncomingDirection);
+        const Vector3 &animOutgoingDirection = info.turnOutgoingDirection;
+        radian animTurnAngle = info.turnAngle;
 
         // anim should not pass through opposite (180 deg) of desired look angle
         Vector3 fencedDirection = query.lookAtVecRel.GetRotated2D(pi);
@@ -638,8 +850,8 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
 
     if (selectAnim) {
       if (query.byPickupBall == true) {
-        if ((animations.at(i)->GetVariable("outgoing_retain_state") == "" && query.pickupBall == true) ||
-            (animations.at(i)->GetVariable("outgoing_retain_state") != "" && query.pickupBall == false)) {
+        if ((!info.outgoingRetain && query.pickupBall == true) ||
+            (info.outgoingRetain && query.pickupBall == false)) {
           selectAnim = false;
         }
       }
@@ -650,7 +862,7 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
 
     if (selectAnim) {
       if (query.allowLastDitchAnims == false) {
-        if (animations.at(i)->GetVariable("lastditch") == "true") {
+        if (info.lastDitch) {
           selectAnim = false;
         }
       }
@@ -665,9 +877,9 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
 
         radian marginRadians = 0.06f * pi; // anims can deviate a few degrees from the desired (quantized) directions
 
-        if (FloatToEnumVelocity(animations.at(i)->GetIncomingVelocity()) != e_Velocity_Idle) {
+        if (info.incomingVelocity != e_Velocity_Idle) {
 
-          Vector3 incomingBodyDir = animations.at(i)->GetIncomingBodyDirection();
+          const Vector3 &incomingBodyDir = info.incomingBodyDirection;
 
 /* this is implicitly happening already because of the section after this one anyway, so disable *todo: is it?
           //if (selectAnim) {
@@ -687,13 +899,13 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
             // disallow larger than x radians diff
             //if (fabs(query.incomingBodyDirection.GetAngle2D(animations.at(i)->GetIncomingBodyDirection())) > marginRadians) selectAnim = false;
             // disallow larger incoming than current
-            if (fabs(FixAngle(animations.at(i)->GetIncomingBodyDirection().GetAngle2D())) > fabs(FixAngle(query.incomingBodyDirection.GetAngle2D())) + marginRadians) selectAnim = false;
+            if (info.fixedIncomingBodyAngle > fabs(FixAngle(query.incomingBodyDirection.GetAngle2D())) + marginRadians) selectAnim = false;
           }
 
           if (selectAnim) {
 
             // absolute outgoing body dir is body dir + outgoing dir
-            Vector3 outgoingBodyDir = Vector3(0, -1, 0).GetRotated2D(animations.at(i)->GetOutgoingBodyAngle() + animations.at(i)->GetOutgoingAngle());
+            const Vector3 &outgoingBodyDir = info.outgoingBodyDirection;
 
             // disallow > ~135 degrees (not really needed, i guess)
             //if (fabs(animations.at(i)->GetIncomingBodyDirection().GetAngle2D(query.incomingBodyDirection)) > 0.75f * pi + marginRadians) selectAnim = false;
@@ -733,7 +945,7 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
           }
         }
 
-        else if (FloatToEnumVelocity(animations.at(i)->GetIncomingVelocity()) == e_Velocity_Idle) {
+        else if (info.incomingVelocity == e_Velocity_Idle) {
 
           // allow only same angle (which is moving anims with 0 outgoing body angle. since @ idle, that will become their only angle)
           //if (fabs(animations.at(i)->GetIncomingBodyDirection().GetAngle2D(query.incomingBodyDirection)) > marginRadians) selectAnim = false;
@@ -755,15 +967,13 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
 
     if (selectAnim) {
       if (query.byIncomingBallDirection == true) {
-        Vector3 animBallDirection = GetVectorFromString(animations.at(i)->GetVariable("incomingballdirection"));
-        if (animBallDirection.GetLength() < 0.1f) {
+        if (info.incomingBallDirectionLength < 0.1f) {
           Log(e_FatalError, "AnimCollection", "Crudeselection", "Anim " + animations.at(i)->GetName() + " missing incoming ball direction");
         }
-        if (animBallDirection.GetLength() != 0.0f && query.incomingBallDirection.GetLength() != 0.0f) {
+        if (info.incomingBallDirectionLength != 0.0f && query.incomingBallDirection.GetLength() != 0.0f) {
 
-          // decimate height diff
-          animBallDirection.coords[2] *= 0.4f;
-          animBallDirection.Normalize();
+          // decimate height diff (anim side was done at load)
+          const Vector3 &animBallDirection = info.incomingBallDirection;
           Vector3 adaptedIncomingBallDirection = query.incomingBallDirection;
           adaptedIncomingBallDirection.coords[2] *= 0.4f;
           adaptedIncomingBallDirection.Normalize();
@@ -774,12 +984,7 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
           //query.incomingBallDirection.Print();
           //animBallDirection.Print();
           //printf("%f\n", ballDirectionDiff);
-          radian maxDeviation = fabs(atof(animations.at(i)->GetVariable("incomingballdirection_maxdeviation").c_str()) * pi);
-          if (maxDeviation == 0.0f) {
-            maxDeviation = maxIncomingBallDirectionDeviation;//0.45f;
-            if (animType.compare(defString[e_DefString_Deflect]) == 0) maxDeviation = 0.4f * pi;
-          }
-          if (ballDirectionAngle > maxDeviation) selectAnim = false;
+          if (ballDirectionAngle > info.incomingBallDirectionMaxDeviation) selectAnim = false;
         }
       }
     }
@@ -789,19 +994,14 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
 
     if (selectAnim) {
       if (query.byOutgoingBallDirection == true) {
-        Vector3 animBallDirection = GetVectorFromString(animations.at(i)->GetVariable("balldirection"));
-        animBallDirection.Normalize(Vector3(0));
+        const Vector3 &animBallDirection = info.outgoingBallDirection;
         //printf("%s\n", animations.at(i)->GetName().c_str());
         //float ballDirectionSimilarity = query.outgoingBallDirection.Get2D().GetNormalized(animBallDirection).GetDotProduct(animBallDirection);
         radian ballDirectionAngle = fabs(query.outgoingBallDirection.Get2D().GetNormalized(animBallDirection).GetAngle2D(animBallDirection));
         //query.outgoingBallDirection.Print();
         //animBallDirection.Print();
         //printf("%f\n", ballDirectionDiff);
-        radian maxDeviation = fabs(atof(animations.at(i)->GetVariable("outgoingballdirection_maxdeviation").c_str()) * pi);
-        if (maxDeviation == 0.0) {
-          maxDeviation = maxOutgoingBallDirectionDeviation;
-        }
-        if (ballDirectionAngle > maxDeviation) selectAnim = false;
+        if (ballDirectionAngle > info.outgoingBallDirectionMaxDeviation) selectAnim = false;
       }
     }
 
@@ -809,12 +1009,12 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
     // select by PROPERTIES
 
     if (selectAnim) {
-      if (query.properties.Get("incoming_special_state").compare(animations.at(i)->GetVariable("incoming_special_state")) != 0) selectAnim = false;
+      if (querySpecialState.compare(info.incomingSpecialState) != 0) selectAnim = false;
       // hax: allow switching of hands (except for deflect anims) (in future, maybe make special case for 'both hands at the same time')
-      if ((query.functionType == e_FunctionType_Deflect || ((query.properties.Get("incoming_retain_state").compare("") != 0) != (animations.at(i)->GetVariable("incoming_retain_state").compare("") != 0))) &&
-          query.properties.Get("incoming_retain_state").compare(animations.at(i)->GetVariable("incoming_retain_state")) != 0) selectAnim = false;
-      if (atof(query.properties.Get("specialvar1").c_str()) != atof(animations.at(i)->GetVariable("specialvar1").c_str())) selectAnim = false;
-      if (atof(query.properties.Get("specialvar2").c_str()) != atof(animations.at(i)->GetVariable("specialvar2").c_str())) selectAnim = false;
+      if ((query.functionType == e_FunctionType_Deflect || ((queryRetainState.compare("") != 0) != (info.incomingRetainState.compare("") != 0))) &&
+          queryRetainState.compare(info.incomingRetainState) != 0) selectAnim = false;
+      if (querySpecialVar1 != info.specialVar1) selectAnim = false;
+      if (querySpecialVar2 != info.specialVar2) selectAnim = false;
     }
 
 
@@ -822,7 +1022,7 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
 
     if (selectAnim) {
       if (query.byTripType == true) {
-        if (int(round(atof(animations.at(i)->GetVariable("triptype").c_str()))) != query.tripType) selectAnim = false;
+        if (info.tripType != query.tripType) selectAnim = false;
       }
     }
 
@@ -833,20 +1033,10 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
     if (selectAnim) {
       if (query.heedForcedFoot == true) {
 
-        std::string forcedFoot = animations.at(i)->GetVariable("forcedfoot");
-        int which = 0;
-        if (forcedFoot.compare("strong") == 0) which = 1;
-        else if (forcedFoot.compare("weak") == 0) which = 2;
+        int which = info.forcedFoot;
         if (which != 0) {
 
-          std::string touchFoot = animations.at(i)->GetVariable("touchfoot");
-          e_Foot animFoot = e_Foot_Right;
-          if (touchFoot.compare("left") == 0) animFoot = e_Foot_Left;
-
-          // for mirrored anims that, therefore, don't start with right foot
-          if (animations.at(i)->GetCurrentFoot() == e_Foot_Left) {
-            if (animFoot == e_Foot_Left) animFoot = e_Foot_Right; else animFoot = e_Foot_Left;
-          }
+          e_Foot animFoot = info.touchFoot;
 
           if (which == 1 && query.strongFoot != animFoot) selectAnim = false;
           if (which == 2 && query.strongFoot == animFoot) selectAnim = false;
@@ -861,6 +1051,109 @@ void AnimCollection::CrudeSelection(DataSet &dataSet, const CrudeSelectionQuery
   }
 }
 
+void AnimCollection::_BuildSelectionIndex() {
+
+  selectionInfo.clear();
+  selectionInfo.resize(animations.size());
+
+  for (unsigned int i = 0; i < animations.size(); i++) {
+
+    const Animation *animation = animations.at(i);
+    AnimSelectionInfo &info = selectionInfo.at(i);
+
+    info.functionType = e_FunctionType_None;
+    for (int functionType = e_FunctionType_None + 1; functionType < functionTypeCount; functionType++) {
+      if (_CheckFunctionType(animation->GetAnimType(), (e_FunctionType)functionType)) {
+        info.functionType = (e_FunctionType)functionType;
+        break;
+      }
+    }
+
+    info.incomingVelocity = FloatToEnumVelocity(animation->GetIncomingVelocity());
+    info.outgoingVelocity = FloatToEnumVelocity(animation->GetOutgoingVelocity());
+
+    // treat dribble and walk the same
+    info.linearIncomingVelocity = RangeVelocity(animation->GetIncomingVelocity());
+    info.linearOutgoingVelocity = RangeVelocity(animation->GetOutgoingVelocity());
+    if (FloatToEnumVelocity(info.linearIncomingVelocity) == e_Velocity_Dribble) info.linearIncomingVelocity = walkVelocity;
+    if (FloatToEnumVelocity(info.linearOutgoingVelocity) == e_Velocity_Dribble) info.linearOutgoingVelocity = walkVelocity;
+
+    info.incomingBodyDirection = animation->GetIncomingBodyDirection();
+    info.fixedIncomingBodyAngle = fabs(FixAngle(info.incomingBodyDirection.GetAngle2D()));
+    info.outgoingBodyDirection = Vector3(0, -1, 0).GetRotated2D(animation->GetOutgoingBodyAngle() + animation->GetOutgoingAngle());
+    info.turnOutgoingDirection = animation->GetOutgoingDirection().GetRotated2D(animation->GetOutgoingBodyAngle());
+    info.turnAngle = info.turnOutgoingDirection.GetAngle2D(info.incomingBodyDirection);
+
+    info.outgoingRetain = animation->GetVariable("outgoing_retain_state") != "";
+    info.lastDitch = animation->GetVariable("lastditch") == "true";
+
+    Vector3 incomingBallDirection = GetVectorFromString(animation->GetVariable("incomingballdirection"));
+    info.incomingBallDirectionLength = incomingBallDirection.GetLength();
+    if (info.incomingBallDirectionLength != 0.0f) {
+      // decimate height diff
+      incomingBallDirection.coords[2] *= 0.4f;
+      incomingBallDirection.Normalize();
+    }
+    info.incomingBallDirection = incomingBallDirection;
+    info.incomingBallDirectionMaxDeviation = fabs(atof(animation->GetVariable("incomingballdirection_maxdeviation").c_str()) * pi);
+    if (info.incomingBallDirectionMaxDeviation == 0.0f) {
+      info.incomingBallDirectionMaxDeviation = maxIncomingBallDirectionDeviation;//0.45f;
+      if (animation->GetAnimType().compare(defString[e_DefString_Deflect]) == 0) info.incomingBallDirectionMaxDeviation = 0.4f * pi;
+    }
+
+    info.outgoingBallDirection = GetVectorFromString(animation->GetVariable("balldirection"));
+    info.outgoingBallDirection.Normalize(Vector3(0));
+    info.outgoingBallDirectionMaxDeviation = fabs(atof(animation->GetVariable("outgoingballdirection_maxdeviation").c_str()) * pi);
+    if (info.outgoingBallDirectionMaxDeviation == 0.0) {
+      info.outgoingBallDirectionMaxDeviation = maxOutgoingBallDirectionDeviation;
+    }
+
+    info.incomingSpecialState = animation->GetVariable("incoming_special_state");
+    info.incomingRetainState = animation->GetVariable("incoming_retain_state");
+    info.specialVar1 = atof(animation->GetVariable("specialvar1").c_str());
+    info.specialVar2 = atof(animation->GetVariable("specialvar2").c_str());
+    info.tripType = int(round(atof(animation->GetVariable("triptype").c_str())));
+
+    const std::string &forcedFoot = animation->GetVariable("forcedfoot");
+    info.forcedFoot = 0;
+    if (forcedFoot.compare("strong") == 0) info.forcedFoot = 1;
+    else if (forcedFoot.compare("weak") == 0) info.forcedFoot = 2;
+
+    info.touchFoot = e_Foot_Right;
+    if (animation->GetVariable("touchfoot").compare("left") == 0) info.touchFoot = e_Foot_Left;
+
+    // for mirrored anims that, therefore, don't start with right foot
+    if (animation->GetCurrentFoot() == e_Foot_Left) {
+      if (info.touchFoot == e_Foot_Left) info.touchFoot = e_Foot_Right; else info.touchFoot = e_Foot_Left;
+    }
+
+    // anims are added in ascending order, so every bucket is sorted
+    selectionIndex[info.functionType][info.incomingVelocity][info.outgoingVelocity].push_back(i);
+  }
+}
+
+bool AnimCollection::_CheckIncomingVelocity(e_Velocity animIncomingVelocity, const CrudeSelectionQuery &query) const {
+
+  // the part of the incoming velocity selection that only depends on the anim's incoming velocity enum
+
+  if (query.incomingVelocity_Strict == true) return animIncomingVelocity == query.incomingVelocity;
+
+  if (query.incomingVelocity_NoDribbleToIdle) {
+    if (animIncomingVelocity == e_Velocity_Idle && query.incomingVelocity == e_Velocity_Dribble) return false;
+  }
+  if (animIncomingVelocity == e_Velocity_Idle && query.incomingVelocity == e_Velocity_Walk) return false;
+  if (animIncomingVelocity == e_Velocity_Idle && query.incomingVelocity == e_Velocity_Sprint) return false;
+  if (animIncomingVelocity == e_Velocity_Dribble && query.incomingVelocity == e_Velocity_Idle) return false;
+  if (animIncomingVelocity == e_Velocity_Walk && query.incomingVelocity == e_Velocity_Idle) return false;
+  if (animIncomingVelocity == e_Velocity_Sprint && query.incomingVelocity == e_Velocity_Idle) return false;
+
+  if (query.incomingVelocity_NoDribbleToSprint) {
+    if (animIncomingVelocity == e_Velocity_Sprint && query.incomingVelocity == e_Velocity_Dribble) return false;
+  }
+
+  return true;
+}
+
 int AnimCollection::GetQuadrantID(Animation *animation, const Vector3 &movement, radian angle) const {
     // assign the animation it's rightful quadrant
 
@@ -1198,9 +1491,6 @@ void AnimCollection::_PrepareAnim(Animation *animation, boost::intrusive_ptr<Nod
   animation->SetVariable("quadrant_id", int_to_str(quadrantID));
   //printf("quadrant: %i\n", quadrantID);
 
-
-  animations.push_back(animation);
-
   //animation->Save(files.at(i));
 
   //XMLLoader loader;
@@ -170,6 +170,48 @@ struct Quadrant {
   radian angle;
 };
 
+const int functionTypeCount = e_FunctionType_Special + 1;
+const int velocityCount = e_Velocity_Sprint + 1;
+
+// what CrudeSelection needs to know about an anim, calculated once at Load instead of for every query (no string parsing while selecting)
+struct AnimSelectionInfo {
+  e_FunctionType functionType; // e_FunctionType_None if the anim's type isn't selectable by function type
+  e_Velocity incomingVelocity;
+  e_Velocity outgoingVelocity;
+  float linearIncomingVelocity; // ranged, dribble counts as walk
+  float linearOutgoingVelocity;
+
+  Vector3 incomingBodyDirection;
+  radian fixedIncomingBodyAngle; // fabs(FixAngle(..))
+  Vector3 outgoingBodyDirection; // absolute
+  Vector3 turnOutgoingDirection; // outgoing direction rotated by outgoing body angle
+  radian turnAngle;
+
+  bool outgoingRetain;
+  bool lastDitch;
+
+  Vector3 incomingBallDirection; // height diff decimated, normalized
+  float incomingBallDirectionLength; // before all that
+  radian incomingBallDirectionMaxDeviation;
+  Vector3 outgoingBallDirection;
+  radian outgoingBallDirectionMaxDeviation;
+
+  std::string incomingSpecialState;
+  std::string incomingRetainState;
+  float specialVar1;
+  float specialVar2;
+  int tripType;
+
+  int forcedFoot; // 0 == none, 1 == strong, 2 == weak
+  e_Foot touchFoot; // corrected for mirroring
+};
+
+namespace blunted {
+  class StageTimer;
+}
+
+struct AnimPrepareContext;
+
 void FillNodeMap(boost::intrusive_ptr<Node> targetNode, std::map < const std::string, boost::intrusive_ptr<Node> > &nodeMap);
 
 class AnimCollection {
@@ -198,15 +240,31 @@ class AnimCollection {
 
   protected:
 
+    // loads the .anim files, generates the auto anims from the templates and prepares them all against a utility player.
+    // spread over the task manager's threads; the anims end up in the same order either way
+    void _PrepareAnims(const std::vector<std::string> &templateFiles, const std::vector<std::string> &files, StageTimer &timer);
+    void _PrepareAnimSources(AnimPrepareContext *context, int begin, int end);
     void _PrepareAnim(Animation *animation, boost::intrusive_ptr<Node> playerNode, const std::list < boost::intrusive_ptr<Object> > &bodyParts, const std::map < const std::string, boost::intrusive_ptr<Node> > &nodeMap, bool convertAngledDribbleToWalk = false);
 
+    // the prepared animations, written after preparing them and used instead of preparing them while the source hash matches
+    unsigned int _HashSources(const std::vector<std::string> &templateFiles, const std::vector<std::string> &files) const;
+    bool _LoadCache(const std::string &filename, unsigned int sourceHash);
+    void _SaveCache(const std::string &filename, unsigned int sourceHash) const;
+
     bool _CheckFunctionType(const std::string &functionType, e_FunctionType queryFunctionType) const;
+    bool _CheckIncomingVelocity(e_Velocity animIncomingVelocity, const CrudeSelectionQuery &query) const;
+    void _BuildSelectionIndex();
 
     boost::shared_ptr<Scene3D> scene3D;
 
     std::vector<Animation*> animations;
     std::vector<Quadrant> quadrants;
 
+    // per anim, same order as animations
+    std::vector<AnimSelectionInfo> selectionInfo;
+    // anim indices by function type, incoming velocity and outgoing velocity
+    std::vector<int> selectionIndex[functionTypeCount][velocityCount][velocityCount];
+
     std::string defString[e_DefString_Size];
 
     radian maxIncomingBallDirectionDeviation;
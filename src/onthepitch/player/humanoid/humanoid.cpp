@@ -71,6 +71,8 @@ Humanoid::Humanoid(Player *player, boost::intrusive_ptr<Node> humanoidSourceNode
 
   stat_GetBodyBallDistanceAdvantage_RadiusDeny = 0;
   stat_GetBodyBallDistanceAdvantage_DistanceDeny = 0;
+
+  thinkPending = false;
 }
 
 Humanoid::~Humanoid() {
@@ -89,7 +91,7 @@ bool _PassFiddlingEnabled() {
   return true;
 }
 
-void Humanoid::Process() {
+void Humanoid::PreProcess() {
 
   _cache_AgilityFactor = GetConfiguration()->GetReal("gameplay_agilityfactor", _default_AgilityFactor);
   _cache_AccelerationFactor = GetConfiguration()->GetReal("gameplay_accelerationfactor", _default_AccelerationFactor);
@@ -211,20 +213,38 @@ void Humanoid::Process() {
     interruptAnim = e_InterruptAnim_ReQueue;
   }
 
+
+  // trips bring their own commands, for anything else, ask the controller (in Think)
+
+  thinkPending = false;
+
   if (interruptAnim != e_InterruptAnim_None) {
 
     //if (CastPlayer()->GetDebug()) SetGreenDebugPilon(GetPosition() + GetMovement());
 
-    PlayerCommandQueue commandQueue;
+    commandQueue.clear();
 
     if (interruptAnim == e_InterruptAnim_Trip && tripType != 0) {
       AddTripCommandToQueue(commandQueue, tripDirection, tripType);
       tripType = 0;
       commandQueue.push_back(GetBasicMovementCommand(tripDirection, spatialState.floatVelocity)); // backup, if there's no applicable trip anim
     } else {
-      CastPlayer()->RequestCommand(commandQueue);
+      thinkPending = true;
     }
+  }
+}
 
+void Humanoid::Think() {
+  // may run on a worker thread, next to the teammates' Think: only this player's own state may be written from here
+  CastPlayer()->RequestCommand(commandQueue);
+  thinkPending = false;
+}
+
+void Humanoid::Process() {
+
+  assert(!thinkPending);
+
+  if (interruptAnim != e_InterruptAnim_None) {
 
     // iterate through the command queue and pick the first that is applicable
 
@@ -1095,7 +1115,7 @@ void Humanoid::SelectRetainAnim() {
   query.properties.Set("incoming_retain_state", "right_elbow");
   query.properties.Set("outgoing_retain_state", "right_elbow");
 
-  DataSet dataSet;
+  DataSet dataSet(TickArena::GetCurrent());
   anims->CrudeSelection(dataSet, query);
 
   assert(dataSet.size() != 0);
@@ -1353,7 +1373,7 @@ bool Humanoid::SelectAnim(const PlayerCommand &command, e_InterruptAnim localInt
 
   if (currentAnim->anim->GetVariable("outgoing_special_state").compare("") != 0) query.incomingVelocity = e_Velocity_Idle; // standing up anims always start out idle
 
-  DataSet dataSet;
+  DataSet dataSet(TickArena::GetCurrent());
   anims->CrudeSelection(dataSet, query);
   //if (command.desiredFunctionType == e_FunctionType_Special) printf("size: %i\n", dataSet.size());
   if (dataSet.size() == 0) {
@@ -1676,7 +1696,7 @@ bool Humanoid::SelectAnim(const PlayerCommand &command, e_InterruptAnim localInt
       printf("functiontype %i\n", command.desiredFunctionType);
     }
     assert(desiredMovement.coords[2] == 0.0f);
-    Vector3 physicsVector = CalculatePhysicsVector(nextAnim, command.useDesiredMovement, desiredMovement, command.useDesiredLookAt, desiredBodyDirectionRel, positions_tmp, rotationSmuggle_tmp);
+    CalculatePhysicsVector(nextAnim, command.useDesiredMovement, desiredMovement, command.useDesiredLookAt, desiredBodyDirectionRel, positions_tmp, rotationSmuggle_tmp);
   }
   else if (command.desiredFunctionType == e_FunctionType_BallControl) {
     if (NeedTouch(*dataSet.begin(), command)) {
@@ -1716,7 +1736,7 @@ bool Humanoid::SelectAnim(const PlayerCommand &command, e_InterruptAnim localInt
         Animation *nextAnim = anims->GetAnim(selectedAnimID);
         Vector3 desiredMovement = command.desiredDirection * command.desiredVelocityFloat;
         assert(desiredMovement.coords[2] == 0.0f);
-        Vector3 physicsVector = CalculatePhysicsVector(nextAnim, command.useDesiredMovement, desiredMovement, command.useDesiredLookAt, desiredBodyDirectionRel, positions_tmp, rotationSmuggle_tmp);
+        CalculatePhysicsVector(nextAnim, command.useDesiredMovement, desiredMovement, command.useDesiredLookAt, desiredBodyDirectionRel, positions_tmp, rotationSmuggle_tmp);
       }
     }
   }
@@ -2031,7 +2051,7 @@ signed int Humanoid::GetBestCheatableAnimID(const DataSet &sortedDataSet, bool u
 
     assert(desiredMovement.coords[2] == 0.0f);
 
-    Vector3 physicsVector = CalculatePhysicsVector(anim, useDesiredMovement, desiredMovement, useDesiredBodyDirection, desiredBodyDirectionRel, positions_ret, rotationSmuggle_ret_tmp);
+    CalculatePhysicsVector(anim, useDesiredMovement, desiredMovement, useDesiredBodyDirection, desiredBodyDirectionRel, positions_ret, rotationSmuggle_ret_tmp);
 
     // anim space!
     predictedAngle = anim->GetOutgoingAngle() + rotationSmuggle_ret_tmp;
@@ -22,6 +22,12 @@ class Humanoid : public HumanoidBase {
 
     Player *CastPlayer() const;
 
+    // one tick is done in three steps, so the Think step can be run for all players of a team at once (see Team::ProcessPlayers).
+    // PreProcess: advance the current anim and decide if a new one is needed; Think: have the controller fill the command queue;
+    // Process: select the anim from that queue, move and touch the ball
+    void PreProcess();
+    bool IsThinkPending() const { return thinkPending; }
+    void Think();
     virtual void Process();
 
     virtual void CalculateGeomOffsets();
@@ -48,6 +54,10 @@ class Humanoid : public HumanoidBase {
 
     Team *team;
 
+    // filled by PreProcess (trips) or Think, used by Process
+    PlayerCommandQueue commandQueue;
+    bool thinkPending;
+
     mutable int stat_GetBodyBallDistanceAdvantage_RadiusDeny;
     mutable int stat_GetBodyBallDistanceAdvantage_DistanceDeny;
 
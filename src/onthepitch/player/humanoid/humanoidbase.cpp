@@ -5,6 +5,10 @@
 #include <cmath>
 #include "humanoid.hpp"
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 #include "humanoid_utils.hpp"
 
 #include "../playerbase.hpp"
@@ -14,6 +18,8 @@
 
 #include "../../AIsupport/AIfunctions.hpp"
 
+#include "base/profiler.hpp"
+
 #include "utils/animationextensions/footballanimationextension.hpp"
 
 #include "managers/resourcemanagerpool.hpp"
@@ -136,6 +142,11 @@ HumanoidBase::HumanoidBase(PlayerBase *player, Match *match, boost::intrusive_pt
   scene3D = GetScene3D();
 
   FillNodeMap(humanoidNode, nodeMap);
+  for (int i = 0; i < e_Joint_Size; i++) {
+    NodeMap::iterator iter = nodeMap.find(GetJointName(i));
+    if (iter == nodeMap.end()) Log(e_FatalError, "HumanoidBase", "HumanoidBase", "Skeleton has no " + std::string(GetJointName(i)) + " node");
+    jointNodes[i] = iter->second.get();
+  }
   FillTemporalHumanoidNodes(humanoidNode, buf_TemporalHumanoidNodes);
 
   PrepareFullbodyModel(colorCoords);
@@ -216,7 +227,7 @@ void HumanoidBase::PrepareFullbodyModel(std::map<Vector3, Vector3> &colorCoords)
   animApplyBuffer.position = Vector3(0);
   animApplyBuffer.orientation = 0;
   animApplyBuffer.offsets.clear();
-  animApplyBuffer.anim->Apply(nodeMap, animApplyBuffer.frameNum, 0, animApplyBuffer.smooth, animApplyBuffer.smoothFactor, animApplyBuffer.position, animApplyBuffer.orientation, animApplyBuffer.offsets, 0, false, true);
+  animApplyBuffer.anim->Apply(jointNodes, animApplyBuffer.frameNum, 0, animApplyBuffer.smooth, animApplyBuffer.smoothFactor, animApplyBuffer.position, animApplyBuffer.orientation, animApplyBuffer.offsets, 0, false, true);
   std::vector < boost::intrusive_ptr<Node> > jointsVec;
   humanoidNode->GetNodes(jointsVec, true);
 
@@ -238,8 +249,7 @@ void HumanoidBase::PrepareFullbodyModel(std::map<Vector3, Vector3> &colorCoords)
 
   for (unsigned int subgeom = 0; subgeom < fullbodySubgeomCount; subgeom++) {
 
-    std::vector<WeightedVertex> weightedVertexVector;
-    weightedVerticesVec.push_back(weightedVertexVector);
+    skinningWeightsVec.push_back(SkinningWeights());
 
     FloatArray meshRef;
     meshRef.data = materializedTriangleMeshes.at(subgeom).vertices;
@@ -336,8 +346,15 @@ void HumanoidBase::PrepareFullbodyModel(std::map<Vector3, Vector3> &colorCoords)
           weightedVertex.bones.push_back(weightedBones[c]);
         }
       }
-
-      weightedVerticesVec.at(subgeom).push_back(weightedVertex);
+      // totalWeight includes the bones dropped above, so a lone bone would come out just below 1, and pull its vertex toward the origin
+      if (weightedVertex.bones.size() == 1) weightedVertex.bones[0].weight = 1.0f;
+
+      SkinningWeights &skinningWeights = skinningWeightsVec.at(subgeom);
+      for (int b = 0; b < maxBonesPerVertex; b++) {
+        bool used = b < (signed int)weightedVertex.bones.size();
+        skinningWeights.jointIDs[b].push_back(used ? weightedVertex.bones[b].jointID : 0);
+        skinningWeights.weights[b].push_back(used ? weightedVertex.bones[b].weight : 0.0f);
+      }
     }
 
     uniqueFullbodyMesh.push_back(uniqueMesh);
@@ -379,7 +396,7 @@ void HumanoidBase::PrepareFullbodyModel(std::map<Vector3, Vector3> &colorCoords)
   Animation *straightAnim = new Animation();
   straightAnim->Load("media/animations/straight.anim.util");
   animApplyBuffer.anim = straightAnim;
-  animApplyBuffer.anim->Apply(nodeMap, animApplyBuffer.frameNum, 0, animApplyBuffer.smooth, animApplyBuffer.smoothFactor, animApplyBuffer.position, animApplyBuffer.orientation, animApplyBuffer.offsets, 0, false, true);
+  animApplyBuffer.anim->Apply(jointNodes, animApplyBuffer.frameNum, 0, animApplyBuffer.smooth, animApplyBuffer.smoothFactor, animApplyBuffer.position, animApplyBuffer.orientation, animApplyBuffer.offsets, 0, false, true);
 
   for (unsigned int i = 0; i < joints.size(); i++) {
     joints.at(i).position = jointsVec[i]->GetDerivedPosition();// * zMultiplier;
@@ -402,13 +419,13 @@ void HumanoidBase::PrepareFullbodyModel(std::map<Vector3, Vector3> &colorCoords)
 
 void HumanoidBase::UpdateFullbodyNodes() {
 
-  Vector3 previousFullbodyOffset = fullbodyOffset;
   fullbodyOffset = humanoidNode->GetPosition().Get2D();
   fullbodyNode->SetPosition(fullbodyOffset);
 
+  Vector3 derivedScale;
   for (unsigned int i = 0; i < joints.size(); i++) {
-    joints[i].orientation = joints[i].node->GetDerivedRotation();
-    joints[i].position = joints[i].node->GetDerivedPosition() - fullbodyOffset;
+    joints[i].node->GetDerivedTransform(joints[i].position, joints[i].orientation, derivedScale);
+    joints[i].position -= fullbodyOffset;
   }
 
   // todo: something is wrong with the hairdo update logic, so just always update now
@@ -434,125 +451,158 @@ bool HumanoidBase::NeedsModelUpdate() {
   if (buf_LowDetailMode && buf_bodyUpdatePhase != 1 - buf_bodyUpdatePhaseOffset) return false; else return true;
 }
 
-void HumanoidBase::UpdateFullbodyModel(bool updateSrc) {
+// skinning kernel. per vertex, the (max 3) joint matrices are blended by weight, after which position, normal, tangent
+// and bitangent are all transformed by that one blended matrix. the sse version keeps a matrix column per register.
+
+static void BuildSkinningMatrix(const Quaternion &orientation, const Vector3 &origPos, const Vector3 &position, SkinningMatrix &matrix) {
+  Vector3 axes[3] = { Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(0, 0, 1) };
+  Vector3 translation = origPos;
+  translation.Rotate(orientation);
+  translation = position - translation;
+  for (int c = 0; c < 3; c++) {
+    axes[c].Rotate(orientation);
+    matrix.columns[c][0] = axes[c].coords[0];
+    matrix.columns[c][1] = axes[c].coords[1];
+    matrix.columns[c][2] = axes[c].coords[2];
+    matrix.columns[c][3] = 0.0f;
+  }
+  matrix.columns[3][0] = translation.coords[0];
+  matrix.columns[3][1] = translation.coords[1];
+  matrix.columns[3][2] = translation.coords[2];
+  matrix.columns[3][3] = 0.0f;
+}
 
-  int uploadVertices = true;
-  int uploadNormals = true;
-  int uploadTangents = true;
-  int uploadBitangents = true;
+#ifdef __SSE__
 
-  boost::intrusive_ptr < Resource<GeometryData> > fullbodyGeometryData = boost::static_pointer_cast<Geometry>(fullbodyNode->GetObject("fullbody"))->GetGeometryData();
-  fullbodyGeometryData->resourceMutex.lock();
-  std::vector < MaterializedTriangleMesh > &materializedTriangleMeshes = fullbodyGeometryData->GetResource()->GetTriangleMeshesRef();
+static inline __m128 LoadSkinningVector(const float *source) {
+  return _mm_set_ps(0.0f, source[2], source[1], source[0]);
+}
 
-  for (unsigned int subgeom = 0; subgeom < fullbodySubgeomCount; subgeom++) {
+static inline void StoreSkinningVector(float *target, __m128 value) {
+  // only 3 floats: the 4th one belongs to the next vertex (or the next element)
+  _mm_storel_pi((__m64*)target, value);
+  _mm_store_ss(target + 2, _mm_movehl_ps(value, value));
+}
 
-    FloatArray &uniqueMesh = uniqueFullbodyMesh.at(subgeom);
+static inline __m128 TransformSkinningVector(const __m128 *columns, const float *source) {
+  __m128 result = _mm_mul_ps(columns[0], _mm_set1_ps(source[0]));
+  result = _mm_add_ps(result, _mm_mul_ps(columns[1], _mm_set1_ps(source[1])));
+  result = _mm_add_ps(result, _mm_mul_ps(columns[2], _mm_set1_ps(source[2])));
+  return result;
+}
 
-    const std::vector<WeightedVertex> &weightedVertices = weightedVerticesVec.at(subgeom);
+static inline __m128 FastNormalizeSkinningVector(__m128 value) {
+  __m128 squared = _mm_mul_ps(value, value);
+  __m128 dot = _mm_add_ss(_mm_add_ss(squared, _mm_shuffle_ps(squared, squared, _MM_SHUFFLE(1, 1, 1, 1))), _mm_movehl_ps(squared, squared));
+  // approximation + newton step, same accuracy as Vector3::FastNormalize
+  __m128 x = _mm_rsqrt_ss(dot);
+  x = _mm_mul_ss(x, _mm_sub_ss(_mm_set_ss(1.5f), _mm_mul_ss(_mm_mul_ss(_mm_set_ss(0.5f), dot), _mm_mul_ss(x, x))));
+  return _mm_mul_ps(value, _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 0, 0, 0)));
+}
 
-    int uniqueVertexCount = weightedVertices.size();
+static void SkinVertices(const SkinningMatrix *matrices, const SkinningWeights &skinningWeights, const float *source, float *target, int vertexCount, int elementOffset) {
 
-    int uniqueElementOffset = uniqueMesh.size / GetTriangleMeshElementCount();
+  for (int v = 0; v < vertexCount; v++) {
 
-    Vector3 origVertex;
-    Vector3 origNormal;
-    Vector3 origTangent;
-    Vector3 origBitangent;
-    Vector3 resultVertex;
-    Vector3 resultNormal;
-    Vector3 resultTangent;
-    Vector3 resultBitangent;
-    Vector3 adaptedVertex;
-    Vector3 adaptedNormal;
-    Vector3 adaptedTangent;
-    Vector3 adaptedBitangent;
-
-    for (int v = 0; v < uniqueVertexCount; v++) {
-      if (uploadVertices)   memcpy(origVertex.coords,    &uniqueMesh.data[weightedVertices[v].vertexID * 3],                           3 * sizeof(float)); // was: uniqueFullbodyMeshSrc
-      if (uploadNormals)    memcpy(origNormal.coords,    &uniqueMesh.data[weightedVertices[v].vertexID * 3 + uniqueElementOffset],     3 * sizeof(float));
-      if (uploadTangents)   memcpy(origTangent.coords,   &uniqueMesh.data[weightedVertices[v].vertexID * 3 + uniqueElementOffset * 3], 3 * sizeof(float));
-      if (uploadBitangents) memcpy(origBitangent.coords, &uniqueMesh.data[weightedVertices[v].vertexID * 3 + uniqueElementOffset * 4], 3 * sizeof(float));
-
-      if (weightedVertices[v].bones.size() == 1) {
-
-        if (uploadVertices) {
-          resultVertex = origVertex;
-          resultVertex -= joints[weightedVertices[v].bones[0].jointID].origPos * zMultiplier;
-          resultVertex.Rotate(joints[weightedVertices[v].bones[0].jointID].orientation);
-          resultVertex += joints[weightedVertices[v].bones[0].jointID].position * zMultiplier;
-        }
+    __m128 columns[4];
+    __m128 weight = _mm_set1_ps(skinningWeights.weights[0][v]);
+    const SkinningMatrix &matrix = matrices[skinningWeights.jointIDs[0][v]];
+    for (int c = 0; c < 4; c++) columns[c] = _mm_mul_ps(_mm_loadu_ps(matrix.columns[c]), weight);
 
-        if (uploadNormals) {
-          resultNormal = origNormal;
-          resultNormal.Rotate(joints[weightedVertices[v].bones[0].jointID].orientation);
-        }
+    bool blended = skinningWeights.weights[1][v] != 0.0f;
+    if (blended) {
+      for (int b = 1; b < maxBonesPerVertex; b++) {
+        if (skinningWeights.weights[b][v] == 0.0f) break;
+        weight = _mm_set1_ps(skinningWeights.weights[b][v]);
+        const SkinningMatrix &boneMatrix = matrices[skinningWeights.jointIDs[b][v]];
+        for (int c = 0; c < 4; c++) columns[c] = _mm_add_ps(columns[c], _mm_mul_ps(_mm_loadu_ps(boneMatrix.columns[c]), weight));
+      }
+    }
 
-        if (uploadTangents) {
-          resultTangent = origTangent;
-          resultTangent.Rotate(joints[weightedVertices[v].bones[0].jointID].orientation);
-        }
+    int index = v * 3;
 
-        if (uploadBitangents) {
-          resultBitangent = origBitangent;
-          resultBitangent.Rotate(joints[weightedVertices[v].bones[0].jointID].orientation);
-        }
+    StoreSkinningVector(&target[index], _mm_add_ps(TransformSkinningVector(columns, &source[index]), columns[3]));
 
-      } else {
+    // normal, tangent, bitangent (element 2 is texcoord)
+    for (int e = 1; e < 5; e++) {
+      if (e == 2) continue;
+      __m128 result = TransformSkinningVector(columns, &source[index + elementOffset * e]);
+      if (blended) result = FastNormalizeSkinningVector(result);
+      StoreSkinningVector(&target[index + elementOffset * e], result);
+    }
+  }
 
-        if (uploadVertices)   resultVertex.Set(0);
-        if (uploadNormals)    resultNormal.Set(0);
-        if (uploadTangents)   resultTangent.Set(0);
-        if (uploadBitangents) resultBitangent.Set(0);
+}
 
-        for (unsigned int b = 0; b < weightedVertices[v].bones.size(); b++) {
+#else
 
-          if (uploadVertices) {
-            adaptedVertex = origVertex;
-            adaptedVertex -= joints[weightedVertices[v].bones[b].jointID].origPos * zMultiplier;
-            adaptedVertex.Rotate(joints[weightedVertices[v].bones[b].jointID].orientation);
-            adaptedVertex += joints[weightedVertices[v].bones[b].jointID].position * zMultiplier;
-            resultVertex += adaptedVertex * weightedVertices[v].bones[b].weight;
-          }
+static void SkinVertices(const SkinningMatrix *matrices, const SkinningWeights &skinningWeights, const float *source, float *target, int vertexCount, int elementOffset) {
 
-          if (uploadNormals) {
-            adaptedNormal = origNormal;
-            adaptedNormal.Rotate(joints[weightedVertices[v].bones[b].jointID].orientation);
-            resultNormal += adaptedNormal * weightedVertices[v].bones[b].weight;
-          }
-
-          if (uploadTangents) {
-            adaptedTangent = origTangent;
-            adaptedTangent.Rotate(joints[weightedVertices[v].bones[b].jointID].orientation);
-            resultTangent += adaptedTangent * weightedVertices[v].bones[b].weight;
-          }
+  for (int v = 0; v < vertexCount; v++) {
 
-          if (uploadBitangents) {
-            adaptedBitangent = origBitangent;
-            adaptedBitangent.Rotate(joints[weightedVertices[v].bones[b].jointID].orientation);
-            resultBitangent += adaptedBitangent * weightedVertices[v].bones[b].weight;
-          }
+    float columns[4][3];
+    float weight = skinningWeights.weights[0][v];
+    const SkinningMatrix &matrix = matrices[skinningWeights.jointIDs[0][v]];
+    for (int c = 0; c < 4; c++) {
+      for (int i = 0; i < 3; i++) columns[c][i] = matrix.columns[c][i] * weight;
+    }
 
+    bool blended = skinningWeights.weights[1][v] != 0.0f;
+    if (blended) {
+      for (int b = 1; b < maxBonesPerVertex; b++) {
+        weight = skinningWeights.weights[b][v];
+        if (weight == 0.0f) break;
+        const SkinningMatrix &boneMatrix = matrices[skinningWeights.jointIDs[b][v]];
+        for (int c = 0; c < 4; c++) {
+          for (int i = 0; i < 3; i++) columns[c][i] += boneMatrix.columns[c][i] * weight;
         }
+      }
+    }
 
-        if (uploadNormals)    resultNormal.FastNormalize();
-        if (uploadTangents)   resultTangent.FastNormalize();
-        if (uploadBitangents) resultBitangent.FastNormalize();
+    int index = v * 3;
 
+    for (int e = 0; e < 5; e++) {
+      if (e == 2) continue; // texcoord
+      const float *in = &source[index + elementOffset * e];
+      Vector3 result;
+      for (int i = 0; i < 3; i++) {
+        result.coords[i] = columns[0][i] * in[0] + columns[1][i] * in[1] + columns[2][i] * in[2];
+        if (e == 0) result.coords[i] += columns[3][i];
       }
+      if (e != 0 && blended) result.FastNormalize();
+      memcpy(&target[index + elementOffset * e], result.coords, 3 * sizeof(float));
+    }
+  }
 
-      if (updateSrc) {
-        if (uploadVertices)   memcpy(&uniqueMesh.data[weightedVertices[v].vertexID * 3],                           resultVertex.coords,    3 * sizeof(float));
-        if (uploadNormals)    memcpy(&uniqueMesh.data[weightedVertices[v].vertexID * 3 + uniqueElementOffset],     resultNormal.coords,    3 * sizeof(float));
-        if (uploadTangents)   memcpy(&uniqueMesh.data[weightedVertices[v].vertexID * 3 + uniqueElementOffset * 3], resultTangent.coords,   3 * sizeof(float));
-        if (uploadBitangents) memcpy(&uniqueMesh.data[weightedVertices[v].vertexID * 3 + uniqueElementOffset * 4], resultBitangent.coords, 3 * sizeof(float));
-      }
+}
 
-      if (uploadVertices)   memcpy(&materializedTriangleMeshes[subgeom].vertices[weightedVertices[v].vertexID * 3],                           resultVertex.coords,    3 * sizeof(float));
-      if (uploadNormals)    memcpy(&materializedTriangleMeshes[subgeom].vertices[weightedVertices[v].vertexID * 3 + uniqueElementOffset],     resultNormal.coords,    3 * sizeof(float));
-      if (uploadTangents)   memcpy(&materializedTriangleMeshes[subgeom].vertices[weightedVertices[v].vertexID * 3 + uniqueElementOffset * 3], resultTangent.coords,   3 * sizeof(float));
-      if (uploadBitangents) memcpy(&materializedTriangleMeshes[subgeom].vertices[weightedVertices[v].vertexID * 3 + uniqueElementOffset * 4], resultBitangent.coords, 3 * sizeof(float));
-    }
+#endif
+
+void HumanoidBase::UpdateFullbodyModel(bool updateSrc) {
+
+  // rotate around the original joint position, then move to the current one (all in zMultiplier'd mesh space)
+  skinningMatrices.resize(joints.size());
+  for (unsigned int j = 0; j < joints.size(); j++) {
+    BuildSkinningMatrix(joints[j].orientation, joints[j].origPos * zMultiplier, joints[j].position * zMultiplier, skinningMatrices[j]);
+  }
+
+  boost::intrusive_ptr < Resource<GeometryData> > fullbodyGeometryData = boost::static_pointer_cast<Geometry>(fullbodyNode->GetObject("fullbody"))->GetGeometryData();
+  fullbodyGeometryData->resourceMutex.lock();
+  std::vector < MaterializedTriangleMesh > &materializedTriangleMeshes = fullbodyGeometryData->GetResource()->GetTriangleMeshesRef();
+
+  for (unsigned int subgeom = 0; subgeom < fullbodySubgeomCount; subgeom++) {
+
+    FloatArray &uniqueMesh = uniqueFullbodyMesh.at(subgeom);
+    const SkinningWeights &skinningWeights = skinningWeightsVec.at(subgeom);
+
+    int uniqueVertexCount = skinningWeights.weights[0].size();
+    int uniqueElementOffset = uniqueMesh.size / GetTriangleMeshElementCount();
+
+    float *target = materializedTriangleMeshes[subgeom].vertices;
+    SkinVertices(&skinningMatrices[0], skinningWeights, uniqueMesh.data, target, uniqueVertexCount, uniqueElementOffset);
+
+    // texcoords are the same in both, so one copy of the whole lot will do
+    if (updateSrc) memcpy(uniqueMesh.data, target, uniqueMesh.size * sizeof(float));
 
   } // subgeom
 
@@ -614,7 +664,7 @@ void HumanoidBase::Process() {
 
   if (interruptAnim != e_InterruptAnim_None) {
 
-    PlayerCommandQueue commandQueue;
+    PlayerCommandQueue commandQueue(TickArena::GetCurrent());
 
     if (interruptAnim == e_InterruptAnim_Trip && tripType != 0) {
       AddTripCommandToQueue(commandQueue, tripDirection, tripType);
@@ -776,7 +826,7 @@ void HumanoidBase::Put() {
 
   //printf("anim ptr: %i\n", fetchedbuf_animApplyBuffer.anim);
   //printf("nodemap size: %i\n", nodeMap.size());
-  fetchedbuf_animApplyBuffer.anim->Apply(nodeMap, fetchedbuf_animApplyBuffer.frameNum, -1, fetchedbuf_animApplyBuffer.smooth, fetchedbuf_animApplyBuffer.smoothFactor, fetchedbuf_animApplyBuffer.position, fetchedbuf_animApplyBuffer.orientation, fetchedbuf_animApplyBuffer.offsets, &movementHistory, timeDiff_ms, fetchedbuf_animApplyBuffer.noPos, false);
+  fetchedbuf_animApplyBuffer.anim->Apply(jointNodes, fetchedbuf_animApplyBuffer.frameNum, -1, fetchedbuf_animApplyBuffer.smooth, fetchedbuf_animApplyBuffer.smoothFactor, fetchedbuf_animApplyBuffer.position, fetchedbuf_animApplyBuffer.orientation, fetchedbuf_animApplyBuffer.offsets, &movementHistory, timeDiff_ms, fetchedbuf_animApplyBuffer.noPos, false);
 
   humanoidNode->RecursiveUpdateSpatialData(e_SpatialDataType_Both);
 
@@ -881,7 +931,7 @@ int HumanoidBase::GetIdleMovementAnimID() {
   query.byOutgoingVelocity = true;
   query.outgoingVelocity = e_Velocity_Idle;
 
-  DataSet dataSet;
+  DataSet dataSet(TickArena::GetCurrent());
   anims->CrudeSelection(dataSet, query);
   if (Verbose()) if (dataSet.size() == 0) printf("no animations to begin with\n");
 
@@ -1372,6 +1422,7 @@ void HumanoidBase::GetRatedDataSet(RatedDataSet &ratedDataSet, const DataSet &da
 */
 
 bool HumanoidBase::SelectAnim(const PlayerCommand &command, e_InterruptAnim localInterruptAnim, bool preferPassAndShot) { // returns false on no applicable anim found
+  PROFILE_ZONE("HumanoidBase::SelectAnim");
   assert(command.desiredDirection.coords[2] == 0.0f);
 
   if (localInterruptAnim != e_InterruptAnim_ReQueue || currentAnim->frameNum > 12) CalculateFactualSpatialState();
@@ -1407,7 +1458,7 @@ bool HumanoidBase::SelectAnim(const PlayerCommand &command, e_InterruptAnim loca
 
   if (currentAnim->anim->GetVariable("outgoing_special_state") != "") query.incomingVelocity = e_Velocity_Idle; // standing up anims always start out idle
 
-  DataSet dataSet;
+  DataSet dataSet(TickArena::GetCurrent());
   anims->CrudeSelection(dataSet, query);
   if (dataSet.size() == 0) {
     if (command.desiredFunctionType == e_FunctionType_Movement) {
@@ -1528,7 +1579,7 @@ bool HumanoidBase::SelectAnim(const PlayerCommand &command, e_InterruptAnim loca
     assert(desiredMovement.coords[2] == 0.0f);
     Vector3 desiredBodyDirectionRel = Vector3(0, -1, 0);
     if (command.useDesiredLookAt) desiredBodyDirectionRel = ((command.desiredLookAt - spatialState.position).Get2D().GetRotated2D(-spatialState.angle) - nextAnim->GetTranslation()).GetNormalized(Vector3(0, -1, 0));
-    Vector3 physicsVector = CalculatePhysicsVector(nextAnim, command.useDesiredMovement, desiredMovement, command.useDesiredLookAt, desiredBodyDirectionRel, positions_tmp, rotationSmuggle_tmp);
+    CalculatePhysicsVector(nextAnim, command.useDesiredMovement, desiredMovement, command.useDesiredLookAt, desiredBodyDirectionRel, positions_tmp, rotationSmuggle_tmp);
   }
 
 
@@ -44,6 +44,20 @@ struct FloatArray {
   int size;
 };
 
+const int maxBonesPerVertex = 3;
+
+// per-subgeom skinning input, one array per bone slot so the kernel can walk them linearly.
+// vertex v is influenced by jointIDs[b][v] with weights[b][v]; unused slots have joint 0 and weight 0
+struct SkinningWeights {
+  std::vector<int> jointIDs[maxBonesPerVertex];
+  std::vector<float> weights[maxBonesPerVertex];
+};
+
+// joint transform as 4 columns (x, y, z rotation axes and translation, w unused), so skinned = columns * (orig, 1)
+struct SkinningMatrix {
+  float columns[4][4];
+};
+
 enum e_InterruptAnim {
   e_InterruptAnim_None,
   e_InterruptAnim_Switch,
@@ -298,7 +312,8 @@ class HumanoidBase {
 
     boost::intrusive_ptr<Node> fullbodyNode;
     std::vector<FloatArray> uniqueFullbodyMesh;
-    std::vector < std::vector<WeightedVertex> > weightedVerticesVec; // < subgeoms < vertices > >
+    std::vector<SkinningWeights> skinningWeightsVec; // < subgeoms >
+    std::vector<SkinningMatrix> skinningMatrices; // < joints >, rebuilt every UpdateFullbodyModel
     unsigned int fullbodySubgeomCount;
     std::vector<int*> uniqueIndicesVec;
     std::vector<Joint> joints;
@@ -317,6 +332,7 @@ class HumanoidBase {
 
     boost::shared_ptr<AnimCollection> anims;
     NodeMap nodeMap;
+    Node *jointNodes[e_Joint_Size]; // nodeMap's skeleton nodes by joint id, for Animation::Apply
 
     AnimApplyBuffer animApplyBuffer;
 
@@ -297,7 +297,7 @@ float Player::GetClosestOpponentDistance() const {
   return opp->GetPosition().GetDistance(GetPosition());
 }
 
-void Player::Process() {
+void Player::PreProcess() {
 
   //if (GetDebug()) SetGreenDebugPilon(GetPosition() + GetMovement());
 
@@ -318,13 +318,30 @@ void Player::Process() {
       }
     }
 
-    Vector3 posBefore = CastHumanoid()->GetPosition();
+    preProcessPosition = CastHumanoid()->GetPosition();
+
+    CastHumanoid()->PreProcess();
+
+    if (CastHumanoid()->IsThinkPending()) thinkRandomStream.Seed(int(random(0.0f, 16777216.0f)));
+  }
+
+}
+
+void Player::Think() {
+  BindRandomStream(&thinkRandomStream);
+  CastHumanoid()->Think();
+  BindRandomStream(0);
+}
+
+void Player::Process() {
+
+  if (isActive) {
 
     CastHumanoid()->Process();
 
     Vector3 posAfter = CastHumanoid()->GetPosition();
 
-    float distance = (posAfter - posBefore).GetLength();
+    float distance = (posAfter - preProcessPosition).GetLength();
     fatigueFactorInv -= distance * 0.00003f * (2.0f - GetStaminaStat()) * (1.0f / match->GetMatchDurationFactor());
     fatigueFactorInv = clamp(fatigueFactorInv, 0.01f, 1.0f);
     //if (GetDebug() && match->GetActualTime_ms() % 1000 == 0) printf("fatigue: %f\n", GetFatigueFactorInv());
@@ -78,6 +78,10 @@ class Player : public PlayerBase {
 
     const TacticalPlayerSituation &GetTacticalSituation() { return tacticalSituation; }
 
+    // see Humanoid::PreProcess
+    void PreProcess();
+    bool IsThinkPending() { return CastHumanoid()->IsThinkPending(); }
+    void Think();
     virtual void Process();
     virtual void PreparePutBuffers(unsigned long snapshotTime_ms);
     virtual void FetchPutBuffers(unsigned long putTime_ms);
@@ -116,6 +120,11 @@ class Player : public PlayerBase {
 
     TacticalPlayerSituation tacticalSituation;
 
+    Vector3 preProcessPosition;
+
+    // Think may run on a worker thread, so it draws from its own stream (reseeded from the shared generator in PreProcess)
+    RandomStream thinkRandomStream;
+
     bool buf_nameCaptionShowCondition;
     bool buf_debugCaptionShowCondition;
     std::string buf_nameCaption;
@@ -0,0 +1,95 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#include "playergrid.hpp"
+
+#include "player/player.hpp"
+
+#include "../gamedefines.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+PlayerGrid::PlayerGrid(float cellSize) : cellSize(cellSize) {
+  columns = (int)std::ceil(pitchFullHalfW * 2.0f / cellSize);
+  rows = (int)std::ceil(pitchFullHalfH * 2.0f / cellSize);
+  cellStart.resize(columns * rows + 1, 0);
+}
+
+PlayerGrid::~PlayerGrid() {
+}
+
+int PlayerGrid::GetColumn(float x) const {
+  // players outside of the rim end up in the border cells, so they are still found, only less efficiently
+  return std::min(std::max((int)std::floor((x + pitchFullHalfW) / cellSize), 0), columns - 1);
+}
+
+int PlayerGrid::GetRow(float y) const {
+  return std::min(std::max((int)std::floor((y + pitchFullHalfH) / cellSize), 0), rows - 1);
+}
+
+void PlayerGrid::Build(const TickVector<Player*> &players) {
+
+  positions.resize(players.size());
+  playerCells.resize(players.size());
+  cellEntries.resize(players.size());
+  std::fill(cellStart.begin(), cellStart.end(), 0);
+
+  // counting sort on cell index
+  for (unsigned int i = 0; i < players.size(); i++) {
+    positions[i] = players[i]->GetPosition();
+    playerCells[i] = GetRow(positions[i].coords[1]) * columns + GetColumn(positions[i].coords[0]);
+    cellStart[playerCells[i] + 1]++;
+  }
+  for (unsigned int c = 1; c < cellStart.size(); c++) {
+    cellStart[c] += cellStart[c - 1];
+  }
+  for (unsigned int i = 0; i < players.size(); i++) {
+    cellEntries[cellStart[playerCells[i]]++] = i;
+  }
+  // the increments above shifted every start one cell ahead; shift back
+  for (unsigned int c = cellStart.size() - 1; c > 0; c--) {
+    cellStart[c] = cellStart[c - 1];
+  }
+  cellStart[0] = 0;
+}
+
+void PlayerGrid::GatherNearby(const Vector3 &position, float range, int minIndex, std::vector<int> &indices) const {
+  int minColumn = GetColumn(position.coords[0] - range);
+  int maxColumn = GetColumn(position.coords[0] + range);
+  int minRow = GetRow(position.coords[1] - range);
+  int maxRow = GetRow(position.coords[1] + range);
+  float rangeSquared = range * range;
+
+  for (int row = minRow; row <= maxRow; row++) {
+    for (int column = minColumn; column <= maxColumn; column++) {
+      int cell = row * columns + column;
+      for (int e = cellStart[cell]; e < cellStart[cell + 1]; e++) {
+        int index = cellEntries[e];
+        if (index < minIndex) continue;
+        float dx = positions[index].coords[0] - position.coords[0];
+        float dy = positions[index].coords[1] - position.coords[1];
+        if (dx * dx + dy * dy < rangeSquared) indices.push_back(index);
+      }
+    }
+  }
+}
+
+void PlayerGrid::GetNearby(const Vector3 &position, float range, std::vector<int> &indices) const {
+  indices.clear();
+  GatherNearby(position, range, 0, indices);
+  std::sort(indices.begin(), indices.end());
+}
+
+void PlayerGrid::GetPairs(float range, std::vector< std::pair<int, int> > &pairs) {
+  pairs.clear();
+  for (unsigned int i1 = 0; i1 < positions.size(); i1++) {
+    nearby.clear();
+    GatherNearby(positions[i1], range, i1 + 1, nearby);
+    std::sort(nearby.begin(), nearby.end());
+    for (unsigned int n = 0; n < nearby.size(); n++) {
+      pairs.push_back(std::pair<int, int>(i1, nearby[n]));
+    }
+  }
+}
@@ -0,0 +1,52 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_PLAYERGRID
+#define _HPP_PLAYERGRID
+
+#include "defines.hpp"
+
+#include "base/math/vector3.hpp"
+#include "base/tickarena.hpp"
+
+using namespace blunted;
+
+class Player;
+
+// uniform 2d grid over the pitch (and its rim), rebuilt from the player positions whenever needed.
+// used as broadphase, so only players that are near each other (or near the ball) reach the expensive checks.
+// everything is returned as indices into the players vector given to Build, in ascending order, so results come out in
+// the same order a brute force loop over that vector would visit them.
+class PlayerGrid {
+
+  public:
+    PlayerGrid(float cellSize);
+    virtual ~PlayerGrid();
+
+    void Build(const TickVector<Player*> &players);
+
+    // players within range (2d) of position
+    void GetNearby(const Vector3 &position, float range, std::vector<int> &indices) const;
+
+    // all pairs (i1 < i2) within range of each other, sorted on i1, then i2
+    void GetPairs(float range, std::vector< std::pair<int, int> > &pairs);
+
+  protected:
+    int GetColumn(float x) const;
+    int GetRow(float y) const;
+    void GatherNearby(const Vector3 &position, float range, int minIndex, std::vector<int> &indices) const;
+
+    float cellSize;
+    int columns;
+    int rows;
+
+    std::vector<Vector3> positions; // < players >
+    std::vector<int> cellStart; // < cells + 1 >, cell c holds cellEntries[cellStart[c] .. cellStart[c + 1]>
+    std::vector<int> cellEntries; // < players >, player indices sorted by cell
+    std::vector<int> playerCells; // < players >
+    std::vector<int> nearby; // scratch for GetPairs
+
+};
+
+#endif
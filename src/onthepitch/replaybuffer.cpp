@@ -0,0 +1,256 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#include "replaybuffer.hpp"
+
+#include "base/math/bluntmath.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+  const float positionScale = 1024.0f; // about a millimeter
+  const float positionLimit = 500000.0f; // debug objects get parked far away; keep those (and their deltas) from overflowing
+  const float orientationScale = 32767.0f / 0.7071068f; // the smallest three are never over 1 / sqrt(2)
+
+  inline unsigned int ZigZag(int value) {
+    return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+  }
+
+  inline int UnZigZag(unsigned int value) {
+    return (int)(value >> 1) ^ -(int)(value & 1);
+  }
+
+  inline void WriteVarint(std::vector<unsigned char> &bytes, unsigned int value) {
+    while (value >= 0x80) {
+      bytes.push_back((unsigned char)(value | 0x80));
+      value >>= 7;
+    }
+    bytes.push_back((unsigned char)value);
+  }
+
+  inline unsigned int ReadVarint(const unsigned char *&bytes) {
+    unsigned int value = 0;
+    int shift = 0;
+    while (*bytes & 0x80) {
+      value |= (unsigned int)(*bytes & 0x7f) << shift;
+      shift += 7;
+      bytes++;
+    }
+    value |= (unsigned int)(*bytes) << shift;
+    bytes++;
+    return value;
+  }
+
+  void Quantize(const Vector3 &position, const Quaternion &orientation, int *state) {
+    for (int c = 0; c < 3; c++) {
+      state[c] = (int)lround(clamp(position.coords[c], -positionLimit, positionLimit) * positionScale);
+    }
+
+    // smallest three: leave out the largest component, made positive (q and -q are the same orientation)
+    int largest = 0;
+    for (int c = 1; c < 4; c++) {
+      if (fabs(orientation.elements[c]) > fabs(orientation.elements[largest])) largest = c;
+    }
+    float sign = orientation.elements[largest] < 0 ? -1.0f : 1.0f;
+    state[3] = largest;
+    int component = 4;
+    for (int c = 0; c < 4; c++) {
+      if (c == largest) continue;
+      state[component] = (int)lround(clamp(orientation.elements[c] * sign, -0.7071068f, 0.7071068f) * orientationScale);
+      component++;
+    }
+  }
+
+  void Dequantize(const int *state, Vector3 &position, Quaternion &orientation) {
+    for (int c = 0; c < 3; c++) position.coords[c] = state[c] / positionScale;
+
+    int largest = state[3];
+    float sumSquared = 0.0f;
+    int component = 4;
+    for (int c = 0; c < 4; c++) {
+      if (c == largest) continue;
+      orientation.elements[c] = state[component] / orientationScale;
+      sumSquared += orientation.elements[c] * orientation.elements[c];
+      component++;
+    }
+    orientation.elements[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSquared));
+  }
+
+}
+
+ReplayBuffer::ReplayBuffer() : replayLength_ms(10000), writeOffset(0), framesSinceKeyFrame(0) {
+  frames.set_capacity(1024);
+}
+
+ReplayBuffer::~ReplayBuffer() {
+}
+
+void ReplayBuffer::SetSpatials(const std::list < boost::intrusive_ptr<Spatial> > &spatials) {
+  this->spatials.assign(spatials.begin(), spatials.end());
+  frames.clear();
+  writeOffset = 0;
+  framesSinceKeyFrame = 0;
+  previousState.assign(this->spatials.size() * stateSize, 0);
+  currentState.assign(this->spatials.size() * stateSize, 0);
+  decodedState1.assign(this->spatials.size() * stateSize, 0);
+  decodedState2.assign(this->spatials.size() * stateSize, 0);
+  encoded.reserve(this->spatials.size() * stateSize * 5);
+}
+
+void ReplayBuffer::Capture(unsigned long frameTime_ms, bool ballTouchesNet) {
+  if (spatials.empty()) return;
+
+  // frame times come from the put buffers and can jitter back a bit; Apply relies on them never going down
+  if (!frames.empty() && frameTime_ms < frames.back().frameTime_ms) frameTime_ms = frames.back().frameTime_ms;
+
+  for (unsigned int i = 0; i < spatials.size(); i++) {
+    Quantize(spatials[i]->GetPosition(), spatials[i]->GetRotation(), &currentState[i * stateSize]);
+  }
+
+  bool keyFrame = frames.empty() || framesSinceKeyFrame >= keyFrameInterval;
+  Encode(keyFrame);
+
+  DropOldFrames(frameTime_ms);
+
+  ReplayFrameInfo frame;
+  frame.frameTime_ms = frameTime_ms;
+  frame.size = encoded.size();
+  frame.offset = Allocate(frame.size);
+  frame.keyFrame = keyFrame;
+  frame.ballTouchesNet = ballTouchesNet;
+  memcpy(&ring[frame.offset], &encoded[0], frame.size);
+
+  if (frames.full()) frames.set_capacity(frames.capacity() * 2);
+  frames.push_back(frame);
+
+  framesSinceKeyFrame = keyFrame ? 1 : framesSinceKeyFrame + 1;
+  previousState.swap(currentState);
+}
+
+bool ReplayBuffer::Apply(unsigned long replayTime_ms, bool &ballTouchesNet) {
+  if (frames.empty()) return false;
+
+  // first frame at or after replayTime_ms, and the one before that
+  struct FrameTimeCompare {
+    bool operator()(const ReplayFrameInfo &frame, unsigned long time_ms) const { return frame.frameTime_ms < time_ms; }
+  };
+  unsigned int index2 = std::lower_bound(frames.begin(), frames.end(), replayTime_ms, FrameTimeCompare()) - frames.begin();
+  if (index2 == frames.size()) return false;
+  unsigned int index1 = index2 > 0 ? index2 - 1 : index2;
+
+  // decode from the key frame at or before frame 1 (the oldest frame always is one)
+  unsigned int index = index1;
+  while (!frames[index].keyFrame) index--;
+  for (; index <= index2; index++) {
+    Decode(frames[index], decodedState2);
+    if (index == index1) decodedState1 = decodedState2;
+  }
+
+  const ReplayFrameInfo &frame1 = frames[index1];
+  const ReplayFrameInfo &frame2 = frames[index2];
+  int count = frame2.frameTime_ms - frame1.frameTime_ms;
+  int offset = replayTime_ms - frame1.frameTime_ms;
+  if (count == 0) count = 1; // never divide by zero, will implode universe
+  float bias = clamp((float)offset / (float)count, 0.0f, 1.0f);
+
+  Vector3 position1, position2;
+  Quaternion orientation1, orientation2;
+  for (unsigned int i = 0; i < spatials.size(); i++) {
+    Dequantize(&decodedState1[i * stateSize], position1, orientation1);
+    Dequantize(&decodedState2[i * stateSize], position2, orientation2);
+    spatials[i]->SetPosition(position1 * (1.0f - bias) + position2 * bias, false);
+    spatials[i]->SetRotation(orientation1.GetSlerped(bias, orientation2).GetNormalized(), false);
+    spatials[i]->RecursiveUpdateSpatialData(e_SpatialDataType_Both);
+  }
+
+  ballTouchesNet = frame2.ballTouchesNet;
+  return true;
+}
+
+size_t ReplayBuffer::GetMemoryUsage() const {
+  return ring.capacity() + frames.capacity() * sizeof(ReplayFrameInfo) +
+         (previousState.capacity() + currentState.capacity() + decodedState1.capacity() + decodedState2.capacity()) * sizeof(int) + encoded.capacity();
+}
+
+void ReplayBuffer::Encode(bool keyFrame) {
+  encoded.clear();
+  for (unsigned int i = 0; i < spatials.size(); i++) {
+    const int *current = &currentState[i * stateSize];
+    const int *previous = &previousState[i * stateSize];
+    for (int c = 0; c < 3; c++) WriteVarint(encoded, ZigZag(current[c] - (keyFrame ? 0 : previous[c])));
+    // the largest component's index rides along in the low bits of the first delta
+    WriteVarint(encoded, (ZigZag(current[4] - (keyFrame ? 0 : previous[4])) << 2) | current[3]);
+    for (int c = 5; c < 7; c++) WriteVarint(encoded, ZigZag(current[c] - (keyFrame ? 0 : previous[c])));
+  }
+}
+
+void ReplayBuffer::Decode(const ReplayFrameInfo &frame, std::vector<int> &state) const {
+  const unsigned char *bytes = &ring[frame.offset];
+  for (unsigned int i = 0; i < spatials.size(); i++) {
+    int *values = &state[i * stateSize];
+    if (frame.keyFrame) for (int c = 0; c < stateSize; c++) values[c] = 0;
+    for (int c = 0; c < 3; c++) values[c] += UnZigZag(ReadVarint(bytes));
+    unsigned int first = ReadVarint(bytes);
+    values[3] = first & 3;
+    values[4] += UnZigZag(first >> 2);
+    for (int c = 5; c < 7; c++) values[c] += UnZigZag(ReadVarint(bytes));
+  }
+  assert(bytes == &ring[frame.offset] + frame.size);
+}
+
+void ReplayBuffer::DropOldFrames(unsigned long frameTime_ms) {
+  if (frameTime_ms < replayLength_ms) return;
+  unsigned long cutoff_ms = frameTime_ms - replayLength_ms;
+
+  // a key frame group at a time, and only once all of it is too old. the newest group always stays: it's being added to
+  while (true) {
+    unsigned int next = 1;
+    while (next < frames.size() && !frames[next].keyFrame) next++;
+    if (next >= frames.size()) break;
+    if (frames[next - 1].frameTime_ms >= cutoff_ms) break;
+    frames.erase_begin(next);
+  }
+}
+
+unsigned int ReplayBuffer::Allocate(unsigned int size) {
+  // frames are contiguous: when one doesn't fit at the end of the ring, it goes to the start
+  if (frames.empty()) {
+    writeOffset = 0;
+    if (size > ring.size()) Grow(size);
+  } else {
+    unsigned int tail = frames.front().offset;
+    if (writeOffset >= tail) {
+      if (writeOffset + size > ring.size()) {
+        if (size < tail) writeOffset = 0; else Grow(size);
+      }
+    } else if (writeOffset + size >= tail) {
+      Grow(size);
+    }
+  }
+
+  unsigned int offset = writeOffset;
+  writeOffset += size;
+  return offset;
+}
+
+void ReplayBuffer::Grow(unsigned int minimumFree) {
+  // only happens while the replay length hasn't been filled yet (or the frame rate goes up); compacts the frames to the start
+  unsigned int used = 0;
+  for (unsigned int i = 0; i < frames.size(); i++) used += frames[i].size;
+  unsigned int capacity = std::max((unsigned int)ring.size() * 2, 65536u);
+  while (capacity < used + minimumFree + 1) capacity *= 2;
+
+  std::vector<unsigned char> grown(capacity);
+  unsigned int offset = 0;
+  for (unsigned int i = 0; i < frames.size(); i++) {
+    memcpy(&grown[offset], &ring[frames[i].offset], frames[i].size);
+    frames[i].offset = offset;
+    offset += frames[i].size;
+  }
+  ring.swap(grown);
+  writeOffset = offset;
+}
@@ -0,0 +1,77 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_REPLAYBUFFER
+#define _HPP_REPLAYBUFFER
+
+#include "defines.hpp"
+
+#include "types/spatial.hpp"
+
+#include <boost/circular_buffer.hpp>
+
+using namespace blunted;
+
+struct ReplayFrameInfo {
+  unsigned long frameTime_ms;
+  unsigned int offset; // into the ring
+  unsigned int size;
+  bool keyFrame;
+  bool ballTouchesNet;
+};
+
+// the last replayLength_ms of spatial positions and orientations, packed into one byte ring:
+// positions are quantized to millimeters, orientations to the smallest three of their components (the largest one follows
+// from those), and both are stored as varint deltas to the previous frame. every keyFrameInterval frames there's a key
+// frame, with deltas to zero, so old frames can be dropped a group at a time and decoding never has to go back far.
+// a spatial takes around 10 bytes per frame this way, instead of a 40 byte frame in a circular buffer of its own
+class ReplayBuffer {
+
+  public:
+    ReplayBuffer();
+    virtual ~ReplayBuffer();
+
+    /// the spatials to capture, in a fixed order. clears what was captured
+    void SetSpatials(const std::list < boost::intrusive_ptr<Spatial> > &spatials);
+    void SetLength_ms(unsigned long length_ms) { replayLength_ms = length_ms; }
+
+    void Capture(unsigned long frameTime_ms, bool ballTouchesNet);
+
+    /// poses all spatials as they were at replayTime_ms (interpolating between the frames around it), decoding straight from
+    /// the ring. false if nothing was captured at or after replayTime_ms; ballTouchesNet is that of the first frame after it
+    bool Apply(unsigned long replayTime_ms, bool &ballTouchesNet);
+
+    unsigned int GetFrameCount() const { return frames.size(); }
+    size_t GetMemoryUsage() const;
+
+    static const unsigned int keyFrameInterval = 32;
+
+  protected:
+    void Encode(bool keyFrame);
+    void Decode(const ReplayFrameInfo &frame, std::vector<int> &state) const;
+    void DropOldFrames(unsigned long frameTime_ms);
+    unsigned int Allocate(unsigned int size);
+    void Grow(unsigned int minimumFree);
+
+    std::vector< boost::intrusive_ptr<Spatial> > spatials;
+    unsigned long replayLength_ms;
+
+    std::vector<unsigned char> ring;
+    unsigned int writeOffset;
+    boost::circular_buffer<ReplayFrameInfo> frames;
+    unsigned int framesSinceKeyFrame;
+
+    // quantized state per spatial: position x, y, z, largest orientation component index, the other three components
+    static const int stateSize = 7;
+    std::vector<int> previousState;
+    std::vector<int> currentState;
+
+    // scratch, kept around so capturing and applying don't allocate
+    std::vector<unsigned char> encoded;
+    std::vector<int> decodedState1;
+    std::vector<int> decodedState2;
+
+};
+
+#endif
@@ -14,6 +14,9 @@
 #include "AIsupport/AIfunctions.hpp"
 
 #include "managers/resourcemanagerpool.hpp"
+#include "managers/taskmanager.hpp"
+
+#include "base/profiler.hpp"
 
 Team::Team(int id, Match *match, TeamData *teamData) : id(id), match(match), teamData(teamData) {
   assert(id == 0 || id == 1);
@@ -36,6 +39,8 @@ Team::Team(int id, Match *match, TeamData *teamData) : id(id), match(match), tea
   }
   lastTouchPlayer = 0;
   lastTouchType = e_TouchType_None;
+
+  threadedThink = GetConfiguration()->GetBool("match_threaded_think", true);
 }
 
 Team::~Team() {
@@ -154,12 +159,6 @@ void Team::SetFormationEntry(int playerID, FormationEntry entry) {
   }
 }
 
-void Team::GetActivePlayers(std::vector<Player*> &activePlayers) {
-  for (auto player : players) {
-    if (player->IsActive()) activePlayers.push_back(player);
-  }
-}
-
 void Team::AddHumanGamer(IHIDevice *hid, e_PlayerColor color) {
   HumanGamer *humanGamer = new HumanGamer(this, hid, color);
 
@@ -331,6 +330,8 @@ void Team::RelaxFatigue(float howMuch) {
 
 void Team::Process() {
 
+  PROFILE_ZONE("Team::Process");
+
   if (!match->GetPause()) {
 
     teamPossessionAmount = (float)(match->GetTeam(abs(GetID() - 1))->GetTimeNeededToGetToBall_ms() + 1500) / (float)(GetTimeNeededToGetToBall_ms() + 1500);
@@ -361,11 +362,7 @@ void Team::Process() {
       }
     }
 
-    for (unsigned int i = 0; i < players.size(); i++) {
-      if (players.at(i)->IsActive()) {
-        players.at(i)->Process();
-      }
-    }
+    ProcessPlayers();
 
     if (match->IsInPlay()) {
 
@@ -457,6 +454,56 @@ void Team::Process() {
 
 }
 
+void Team::ProcessPlayers() {
+
+  // everyone advances their anims first, so all thinking below sees the same state of the team, whatever the order or thread
+
+  for (unsigned int i = 0; i < players.size(); i++) {
+    if (players.at(i)->IsActive()) {
+      players.at(i)->PreProcess();
+    }
+  }
+
+  // human controllers also change team state (pressure, keeper rush, attacking runs), so they go one by one, before the ai
+
+  thinkingPlayers.clear();
+  for (unsigned int i = 0; i < players.size(); i++) {
+    if (players.at(i)->IsActive() && players.at(i)->IsThinkPending()) {
+      if (players.at(i)->GetExternalController()) players.at(i)->Think(); else thinkingPlayers.push_back(players.at(i));
+    }
+  }
+  ProcessThinkingPlayers();
+
+  // back in player order for anim selection, movement and ball touches
+
+  for (unsigned int i = 0; i < players.size(); i++) {
+    if (players.at(i)->IsActive()) {
+      players.at(i)->Process();
+    }
+  }
+}
+
+void Team::ProcessThinkingPlayers() {
+
+  // ai players only write their own state while thinking, and each has its own random stream, so the outcome does not depend on the thread count
+
+  // inline too when there's nobody to help, like in forked batch workers, whose task manager threads stayed in the parent
+  if (!threadedThink || !TaskManager::GetInstance().HasLiveWorkers()) {
+    ThinkPlayers(0, thinkingPlayers.size());
+    return;
+  }
+
+  TaskManager::GetInstance().ParallelFor(thinkingPlayers.size(), 1, boost::bind(&Team::ThinkPlayers, this, _1, _2));
+}
+
+void Team::ThinkPlayers(int begin, int end) {
+  // may run on a worker thread, which then uses its own arena
+  TickArenaScope tickArenaScope;
+  for (int i = begin; i < end; i++) {
+    thinkingPlayers.at(i)->Think();
+  }
+}
+
 void Team::PreparePutBuffers(unsigned long snapshotTime_ms) {
   for (unsigned int i = 0; i < players.size(); i++) {
     if (players.at(i)->IsActive()) {
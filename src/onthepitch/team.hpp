@@ -36,7 +36,11 @@ class Team {
     void SetFormationEntry(int playerID, FormationEntry entry);
     const std::vector<Player*> &GetAllPlayers() { return players; }
     void GetAllPlayers(std::vector<Player*> &allPlayers) { allPlayers.insert(allPlayers.end(), players.begin(), players.end()); }
-    void GetActivePlayers(std::vector<Player*> &activePlayers);
+    template <class PlayerVector> void GetActivePlayers(PlayerVector &activePlayers) {
+      for (auto player : players) {
+        if (player->IsActive()) activePlayers.push_back(player);
+      }
+    }
     int GetActivePlayerCount() const { return activePlayerCount; }
 
     unsigned int GetHumanGamerCount() const { return humanGamers.size(); }
@@ -87,6 +91,10 @@ class Team {
     void SetKitNumber(int num);
 
   protected:
+    void ProcessPlayers();
+    void ProcessThinkingPlayers();
+    void ThinkPlayers(int begin, int end);
+
     int id;
     Match *match;
     TeamData *teamData;
@@ -103,6 +111,10 @@ class Team {
     std::vector<Player*> players;
     int activePlayerCount;
 
+    // ai players that want a new command this tick (scratch, reused)
+    std::vector<Player*> thinkingPlayers;
+    bool threadedThink;
+
     boost::intrusive_ptr<Node> teamNode;
     boost::intrusive_ptr<Node> playerNode;
 
@@ -429,10 +429,10 @@ Vector3 TeamAIController::GetAdaptedFormationPosition(Player *player, bool useDy
 
 void TeamAIController::CalculateDynamicRoles() {
 
-  std::vector<Player*> players;
+  TickVector<Player*> players(TickArena::GetCurrent());
   team->GetActivePlayers(players);
 
-  std::vector<Player*>::iterator iter = players.begin();
+  TickVector<Player*>::iterator iter = players.begin();
   while (iter != players.end()) {
     if ((*iter)->GetFormationEntry().role == e_PlayerRole_GK) {
       players.erase(iter);
@@ -592,7 +592,7 @@ void TeamAIController::CalculateManMarking() {
 
   const std::vector<TacticalOpponentInfo> &oppInfo = GetTacticalOpponentInfo();
 
-  std::vector<Player*> players;
+  TickVector<Player*> players(TickArena::GetCurrent());
   team->GetActivePlayers(players);
 
   // reset previous man marking
@@ -606,8 +606,8 @@ void TeamAIController::CalculateManMarking() {
 
     Player *closestPlayer = 0;
     float bestMarkingQuality = -1.0f;
-    std::vector<Player*>::iterator closestPlayerIter;
-    std::vector<Player*>::iterator iter = players.begin();
+    TickVector<Player*>::iterator closestPlayerIter;
+    TickVector<Player*>::iterator iter = players.begin();
 
     Player *oppPlayer = oppInfo.at(opp).player;
 
@@ -673,9 +673,9 @@ void TeamAIController::PrepareSetPiece(e_SetPiece setPiece, int takerTeamID) {
   if (takerTeamID == -1) assert(setPieceType == e_SetPiece_None);
   if (setPieceType == e_SetPiece_None) return;
 
-  std::vector<Player*> players;
+  TickVector<Player*> players(TickArena::GetCurrent());
   team->GetActivePlayers(players);
-  std::vector<Player*>::iterator iter = players.begin();
+  TickVector<Player*>::iterator iter = players.begin();
   while (iter != players.end()) {
     if ((*iter)->GetFormationEntry().role == e_PlayerRole_GK) {
       (*iter)->ResetPosition(Vector3(pitchHalfW * team->GetSide() * 0.98, 0, 0), match->GetBall()->Predict(0).Get2D());
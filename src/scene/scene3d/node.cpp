@@ -10,6 +10,8 @@
 
 namespace blunted {
 
+  std::atomic<unsigned int> Node::structureVersion(0);
+
   Node::Node(const std::string &name) : Spatial(name) {
     aabb.data.aabb.Reset();
     aabb.data.dirty = false;
@@ -43,6 +45,7 @@ namespace blunted {
   void Node::Exit() {
     //printf("node::exit exiting node %s\n", GetName().c_str());
     objects.Lock();
+    StructureChanged();
     int objCount = objects.data.size();
     for (int i = 0; i < objCount; i++) {
       //printf("node::exit exiting object %s\n", objects.data.at(i)->GetName().c_str());
@@ -52,6 +55,7 @@ namespace blunted {
     objects.Unlock();
 
     nodes.Lock();
+    StructureChanged();
     int nodeCount = nodes.data.size();
     for (int i = 0; i < nodeCount; i++) {
       nodes.data.at(i)->Exit();
@@ -62,6 +66,7 @@ namespace blunted {
 
   void Node::AddNode(boost::intrusive_ptr<Node> node) {
     nodes.Lock();
+    StructureChanged();
     nodes.data.push_back(node);
     node->SetParent(this);
     //printf("adding node: %s\n", node->GetName().c_str());
@@ -75,6 +80,7 @@ namespace blunted {
 
   void Node::DeleteNode(boost::intrusive_ptr<Node> node) {
     nodes.Lock();
+    StructureChanged();
     std::vector < boost::intrusive_ptr<Node> >::iterator nodeIter = find(nodes.data.begin(), nodes.data.end(), node);
     if (nodeIter != nodes.data.end()) {
       (*nodeIter)->Exit();
@@ -111,6 +117,7 @@ namespace blunted {
   void Node::AddObject(boost::intrusive_ptr<Object> object) {
     assert(object.get());
     objects.Lock();
+    StructureChanged();
     objects.data.push_back(object);
     object->SetParent(this);
 
@@ -137,6 +144,7 @@ namespace blunted {
 
   void Node::DeleteObject(const std::string &name, bool exitObject) {
     objects.Lock();
+    StructureChanged();
     std::vector < boost::intrusive_ptr<Object> >::iterator objIter = objects.data.begin();
     while (objIter != objects.data.end()) {
       if ((*objIter)->GetName() == name) {
@@ -157,6 +165,7 @@ namespace blunted {
 
   void Node::DeleteObject(boost::intrusive_ptr<Object> object, bool exitObject) {
     objects.Lock();
+    StructureChanged();
     // verbose printf("deleting object %s\n", object->GetName().c_str());
     std::vector < boost::intrusive_ptr<Object> >::iterator objIter = find(objects.data.begin(), objects.data.end(), object);
     if (objIter != objects.data.end()) {
@@ -174,6 +183,7 @@ namespace blunted {
 
   void Node::DeleteAllObjects(bool exitObjects) {
     objects.Lock();
+    StructureChanged();
     std::vector < boost::intrusive_ptr<Object> >::iterator objIter = objects.data.begin();
     while (objIter != objects.data.end()) {
       if (exitObjects) (*objIter)->Exit();
@@ -313,6 +323,28 @@ namespace blunted {
     objects.Unlock();
   }
 
+  void Node::RecursiveUpdatePendingSpatialData() {
+    if (IsSpatialUpdatePending()) {
+      RecursiveUpdateSpatialData(e_SpatialDataType_Both);
+      return;
+    }
+    if (!spatialUpdatePendingBelow.exchange(false, std::memory_order_acq_rel)) return;
+
+    nodes.Lock();
+    int nodesSize = nodes.data.size();
+    for (int i = 0; i < nodesSize; i++) {
+      nodes.data.at(i)->RecursiveUpdatePendingSpatialData();
+    }
+    nodes.Unlock();
+
+    objects.Lock();
+    int objectsSize = objects.data.size();
+    for (int i = 0; i < objectsSize; i++) {
+      if (objects.data.at(i)->IsSpatialUpdatePending()) objects.data.at(i)->RecursiveUpdateSpatialData(e_SpatialDataType_Both);
+    }
+    objects.Unlock();
+  }
+
   void Node::PrintTree(int recursionDepth) {
     nodes.Lock();
     int nodesSize = nodes.data.size();
@@ -135,11 +135,22 @@ namespace blunted {
       virtual AABB GetAABB() const;
 
       virtual void RecursiveUpdateSpatialData(e_SpatialDataType spatialDataType, e_SystemType excludeSystem = e_SystemType_None);
+      /// RecursiveUpdateSpatialData, but only for what was moved without updating since, and everything below that. the rest
+      /// of the tree isn't visited
+      void RecursiveUpdatePendingSpatialData();
+
+      /// goes up when nodes or objects are added to or removed from any node. that happens with the node locked, before
+      /// anything changes, so whoever reads this before walking the hierarchy either sees the change, or a newer version later
+      static unsigned int GetStructureVersion() { return structureVersion.load(std::memory_order_acquire); }
 
     protected:
+      static void StructureChanged() { structureVersion.fetch_add(1, std::memory_order_release); }
+
       mutable Lockable < std::vector < boost::intrusive_ptr<Node> > > nodes;
       mutable Lockable < std::vector < boost::intrusive_ptr<Object> > > objects;
 
+      static std::atomic<unsigned int> structureVersion;
+
   };
 
 }
@@ -13,9 +13,20 @@
 
 #include "scene/objectfactory.hpp"
 
+#include <boost/thread/thread.hpp>
+
 namespace blunted {
 
-  Scene3D::Scene3D(std::string name) : Scene(name, e_SceneType_Scene3D) {
+  namespace {
+    inline bool IsBounded(const AABB &aabb) {
+      return aabb.minxyz.coords[0] <= aabb.maxxyz.coords[0] && aabb.minxyz.coords[1] <= aabb.maxxyz.coords[1] && aabb.minxyz.coords[2] <= aabb.maxxyz.coords[2];
+    }
+  }
+
+  Scene3D::Scene3D(std::string name) : Scene(name, e_SceneType_Scene3D), cullIndexBuilt(false), cullStructureVersion(0), cullBuildCount(0), cullPublished(-1) {
+    cullReaders[0] = 0;
+    cullReaders[1] = 0;
+
     //printf("CREATING SCENE3D\n");
     boost::intrusive_ptr<Node> root(new Node("Scene3D root node"));
     hierarchyRoot = root;
@@ -46,8 +57,21 @@ namespace blunted {
   }
 
   void Scene3D::Exit() { // ATOMIC
+    cullUpdateMutex.lock();
+    cullPublished = -1;
+    for (int i = 0; i < 2; i++) {
+      while (cullReaders[i] > 0) boost::this_thread::yield();
+      cullSnapshots[i] = CullSnapshot();
+    }
+    cullObjects.clear();
+    cullTreeObjects.clear();
+    cullUnbounded.clear();
+    cullTree.Clear();
+    cullIndexBuilt = false;
+
     hierarchyRoot->Exit();
     hierarchyRoot.reset();
+    cullUpdateMutex.unlock();
 
     subjectMutex.lock();
 
@@ -126,6 +150,139 @@ namespace blunted {
     subjectMutex.unlock();
   }
 
+  void Scene3D::UpdateCullIndex() {
+    boost::mutex::scoped_lock lock(cullUpdateMutex);
+    if (!hierarchyRoot) return;
+
+    RefitCullIndex();
+    PublishCullIndex();
+  }
+
+  void Scene3D::RefitCullIndex() {
+    if (!cullIndexBuilt || Node::GetStructureVersion() != cullStructureVersion) {
+      BuildCullIndex();
+      return;
+    }
+
+    // only objects that moved (or changed otherwise) since the last update get their box fetched again
+    for (unsigned int i = 0; i < cullObjects.size(); i++) {
+      CullObject &cullObject = cullObjects[i];
+      unsigned int version = cullObject.object->GetBoundingVolumeVersion();
+      if (version == cullObject.boundingVolumeVersion) continue;
+
+      // the hierarchy's version goes up before objects are exited (which invalidates their box), so this keeps us from asking
+      // those for a box
+      if (Node::GetStructureVersion() != cullStructureVersion) {
+        BuildCullIndex();
+        return;
+      }
+
+      cullObject.boundingVolumeVersion = version;
+      AABB aabb = cullObject.object->GetAABB();
+      if (IsBounded(aabb) != (cullObject.treeItem != -1)) {
+        // moves in or out of the tree; rare enough to just start over
+        BuildCullIndex();
+        return;
+      }
+      if (cullObject.treeItem != -1) cullTree.SetItem(cullObject.treeItem, aabb);
+    }
+
+    cullTree.Refit();
+
+    // after a lot of moving around, refit boxes overlap a lot more than freshly built ones
+    if (cullTree.GetCost() > cullTree.GetBuildCost() * 2.0f) cullTree.Rebuild();
+  }
+
+  void Scene3D::BuildCullIndex() {
+    cullObjects.clear();
+    cullTreeObjects.clear();
+    cullUnbounded.clear();
+    cullIndexBuilt = true;
+    cullBuildCount++;
+
+    // versions are read before what they're versions of, so changes made meanwhile are picked up by the next update
+    cullStructureVersion = Node::GetStructureVersion();
+    std::list < boost::intrusive_ptr<Object> > objects;
+    hierarchyRoot->GetObjects(objects, true, 0);
+
+    std::vector<AABB> boxes;
+    cullObjects.reserve(objects.size());
+    boxes.reserve(objects.size());
+    std::list < boost::intrusive_ptr<Object> >::iterator objectIter = objects.begin();
+    while (objectIter != objects.end()) {
+      CullObject cullObject;
+      cullObject.object = *objectIter;
+      cullObject.objectType = (*objectIter)->GetObjectType();
+      cullObject.boundingVolumeVersion = (*objectIter)->GetBoundingVolumeVersion();
+      AABB aabb = (*objectIter)->GetAABB();
+      if (IsBounded(aabb)) {
+        cullObject.treeItem = boxes.size();
+        cullTreeObjects.push_back(cullObjects.size());
+        boxes.push_back(aabb);
+      } else {
+        cullObject.treeItem = -1;
+        cullUnbounded.push_back(cullObjects.size());
+      }
+      cullObjects.push_back(cullObject);
+      objectIter++;
+    }
+
+    cullTree.Build(boxes);
+  }
+
+  void Scene3D::PublishCullIndex() {
+    int index = cullPublished == 0 ? 1 : 0;
+
+    // readers that got to this one before the last publish may still be at it. they're done in microseconds
+    while (cullReaders[index] > 0) boost::this_thread::yield();
+
+    CullSnapshot &snapshot = cullSnapshots[index];
+    if (snapshot.buildCount != cullBuildCount) {
+      snapshot.objects.resize(cullObjects.size());
+      snapshot.objectTypes.resize(cullObjects.size());
+      for (unsigned int i = 0; i < cullObjects.size(); i++) {
+        snapshot.objects[i] = cullObjects[i].object;
+        snapshot.objectTypes[i] = cullObjects[i].objectType;
+      }
+      snapshot.treeObjects = cullTreeObjects;
+      snapshot.unbounded = cullUnbounded;
+      snapshot.buildCount = cullBuildCount;
+    }
+    snapshot.tree = cullTree;
+    snapshot.structureVersion = cullStructureVersion;
+
+    cullPublished = index;
+  }
+
+  int Scene3D::AcquireCullSnapshot() const {
+    while (true) {
+      int index = cullPublished;
+      if (index == -1) return -1;
+
+      cullReaders[index]++;
+      // if another one got published in between, an update may be writing to this one already; it hasn't if it's still the one
+      if (cullPublished == index) {
+        if (cullSnapshots[index].structureVersion == Node::GetStructureVersion()) return index;
+        cullReaders[index]--;
+        return -1;
+      }
+      cullReaders[index]--;
+    }
+  }
+
+  void Scene3D::QueryCullSnapshot(const CullSnapshot &snapshot, const vector_Planes &bounding, std::vector<int> &visible) const {
+    std::vector<int> treeItems;
+    snapshot.tree.Query(PackedPlanes(bounding), treeItems);
+
+    // back in the order walking the hierarchy gives them in, like before there was an index. cheaper to mark and scan than to sort
+    std::vector<unsigned char> visibleFlags(snapshot.objects.size(), false);
+    for (unsigned int i = 0; i < treeItems.size(); i++) visibleFlags[snapshot.treeObjects[treeItems[i]]] = true;
+    for (unsigned int i = 0; i < snapshot.unbounded.size(); i++) visibleFlags[snapshot.unbounded[i]] = true;
+    for (unsigned int i = 0; i < visibleFlags.size(); i++) {
+      if (visibleFlags[i]) visible.push_back(i);
+    }
+  }
+
   void Scene3D::PokeObjects(e_ObjectType targetObjectType, e_SystemType targetSystemType) {
     if (!SupportedObjectType(targetObjectType)) {
       Log(e_Error, "Scene3D", "PokeObjects", "targetObjectType " + int_to_str(targetObjectType) + " is not supported by this scene");
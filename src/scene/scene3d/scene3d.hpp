@@ -16,6 +16,9 @@
 #include "base/utils.hpp"
 
 #include "base/geometry/plane.hpp"
+#include "base/geometry/aabbtree.hpp"
+
+#include <atomic>
 
 namespace blunted {
 
@@ -45,11 +48,11 @@ namespace blunted {
       }
 
       void GetObjects(std::list < boost::intrusive_ptr<Object> > &gatherObjects, const vector_Planes &bounding) const {
-        hierarchyRoot->GetObjects(gatherObjects, bounding, true, 0);
+        if (!GetCulledObjects<Object>(gatherObjects, bounding)) hierarchyRoot->GetObjects(gatherObjects, bounding, true, 0);
       }
 
       void GetObjects(std::deque < boost::intrusive_ptr<Object> > &gatherObjects, const vector_Planes &bounding) const {
-        hierarchyRoot->GetObjects(gatherObjects, bounding, true, 0);
+        if (!GetCulledObjects<Object>(gatherObjects, bounding)) hierarchyRoot->GetObjects(gatherObjects, bounding, true, 0);
       }
 
       template <class T>
@@ -69,7 +72,7 @@ namespace blunted {
           return;
         }
 
-        hierarchyRoot->GetObjects<T>(targetObjectType, gatherObjects, bounding, true, 0);
+        if (!GetCulledObjects<T>(gatherObjects, bounding, &targetObjectType)) hierarchyRoot->GetObjects<T>(targetObjectType, gatherObjects, bounding, true, 0);
       }
 
       template <class T>
@@ -89,14 +92,81 @@ namespace blunted {
           return;
         }
 
-        hierarchyRoot->GetObjects<T>(targetObjectType, gatherObjects, bounding, true, 0);
+        if (!GetCulledObjects<T>(gatherObjects, bounding, &targetObjectType)) hierarchyRoot->GetObjects<T>(targetObjectType, gatherObjects, bounding, true, 0);
       }
 
       void PokeObjects(e_ObjectType targetObjectType, e_SystemType targetSystemType);
 
+      /// brings the cull index up to date with where everything is now, and publishes it to the bounded GetObjects variants.
+      /// belongs on the update side, after things have moved (GameTask::PutPhase calls it once per put); culling sees the boxes
+      /// as they were at the last call. one caller at a time
+      void UpdateCullIndex();
+
     protected:
+      // a flat copy of the hierarchy's objects and their boxes, with a bounding volume tree over them, so culling doesn't need
+      // to walk (and lock) every node. built again when the hierarchy changes anywhere, refit when objects move.
+      // objects without a proper box (skyboxes, cameras) aren't in the tree, but always pass, like they do in AABB::Intersects
+
+      // what the culling queries read. there are two: UpdateCullIndex writes the one that isn't published, once nobody reads it
+      // anymore, and then publishes it. readers only count themselves in and out, so they never wait on each other or on updates
+      struct CullSnapshot {
+        CullSnapshot() : structureVersion(0), buildCount(0) {}
+        std::vector < boost::intrusive_ptr<Object> > objects; // in hierarchy order
+        std::vector<e_ObjectType> objectTypes;
+        std::vector<int> treeObjects; // tree item -> object
+        std::vector<int> unbounded;
+        AABBTree tree;
+        unsigned int structureVersion;
+        unsigned int buildCount; // of the index this is a copy of; the object lists only need copying when that changed
+      };
+
+      /// the objects whose boxes intersect bounding (of one type, if targetObjectType is set), in hierarchy order. false when
+      /// there's no (up to date) snapshot; walk the hierarchy instead then
+      template <class T, class C>
+      bool GetCulledObjects(C &gatherObjects, const vector_Planes &bounding, const e_ObjectType *targetObjectType = 0) const {
+        int snapshotIndex = AcquireCullSnapshot();
+        if (snapshotIndex == -1) return false;
+        const CullSnapshot &snapshot = cullSnapshots[snapshotIndex];
+        std::vector<int> visible;
+        QueryCullSnapshot(snapshot, bounding, visible);
+        for (unsigned int i = 0; i < visible.size(); i++) {
+          if (!targetObjectType || snapshot.objectTypes[visible[i]] == *targetObjectType) gatherObjects.push_back(static_pointer_cast<T>(snapshot.objects[visible[i]]));
+        }
+        cullReaders[snapshotIndex]--;
+        return true;
+      }
+
+      /// index of the published snapshot, counted in as a reader. -1 if there is none, or if the hierarchy changed since it was made
+      int AcquireCullSnapshot() const;
+      void QueryCullSnapshot(const CullSnapshot &snapshot, const vector_Planes &bounding, std::vector<int> &visible) const;
+
+      void RefitCullIndex();
+      void BuildCullIndex();
+      void PublishCullIndex();
+
       boost::intrusive_ptr<Node> hierarchyRoot;
 
+      // the index itself, only touched by UpdateCullIndex
+      struct CullObject {
+        boost::intrusive_ptr<Object> object;
+        e_ObjectType objectType;
+        unsigned int boundingVolumeVersion;
+        int treeItem; // -1: unbounded
+      };
+
+      boost::mutex cullUpdateMutex;
+      std::vector<CullObject> cullObjects; // in hierarchy order
+      std::vector<int> cullTreeObjects; // tree item -> cull object
+      std::vector<int> cullUnbounded;
+      AABBTree cullTree;
+      bool cullIndexBuilt;
+      unsigned int cullStructureVersion;
+      unsigned int cullBuildCount;
+
+      CullSnapshot cullSnapshots[2];
+      std::atomic<int> cullPublished; // -1: none yet
+      mutable std::atomic<int> cullReaders[2];
+
   };
 
   class IScene3DInterpreter : public ISceneInterpreter {
@@ -12,12 +12,14 @@
 #include "managers/resourcemanagerpool.hpp"
 
 #include "rendering/r3d_messages.hpp"
+#include "rendering/null_renderer3d.hpp"
 
 namespace blunted {
 
   GraphicsSystem::GraphicsSystem() : systemType(e_SystemType_Graphics) {
     renderer3DTask = NULL;
     task = NULL;
+    sortRenderQueues = true;
   }
 
   GraphicsSystem::~GraphicsSystem() {
@@ -30,12 +32,16 @@ namespace blunted {
     ResourceManagerPool::GetInstance().RegisterManager(e_ResourceType_Texture, textureResourceManager);
     ResourceManagerPool::GetInstance().RegisterManager(e_ResourceType_VertexBuffer, vertexBufferResourceManager);
 
-    // start renderer object
-    if (config.Get("graphics3d_renderer", "opengl") == "opengl") renderer3DTask = new OpenGLRenderer3D();
+    // start renderer object. null draws nothing, for timing the rest of the pipeline without a gl context
+    std::string rendererName = config.Get("graphics3d_renderer", "opengl");
+    if (rendererName == "opengl") renderer3DTask = new OpenGLRenderer3D();
+    else if (rendererName == "null") renderer3DTask = new NullRenderer3D(config.Get("graphics3d_null_record", ""));
+    else Log(e_FatalError, "GraphicsSystem", "Initialize", "Unknown renderer: " + rendererName);
     width = config.GetInt("context_x", 1280);
     height = config.GetInt("context_y", 720);
     bpp = config.GetInt("context_bpp", 32);
     bool fullscreen = config.GetBool("context_fullscreen", false);
+    sortRenderQueues = config.GetBool("graphics3d_sort_queues", true);
 
     // Create the GL context on the main thread (macOS requirement)
     bool ctxOk = renderer3DTask->CreateContext(width, height, bpp, fullscreen);
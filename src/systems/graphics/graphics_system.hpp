@@ -52,6 +52,8 @@ namespace blunted {
       unsigned long GetLastSwapTime_ms() const { assert(task); return task->GetLastSwapTime_ms(); }
       int GetTimeSinceLastSwap_ms() const { assert(task); return task->GetTimeSinceLastSwap_ms(); }
 
+      bool GetSortRenderQueues() const { return sortRenderQueues; }
+
       virtual std::string GetName() const { return "graphics"; }
 
       boost::mutex getPhaseMutex;
@@ -70,6 +72,8 @@ namespace blunted {
 
       int width, height, bpp;
 
+      bool sortRenderQueues;
+
   };
 
 }
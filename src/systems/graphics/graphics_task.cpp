@@ -6,6 +6,7 @@
 
 #include "base/log.hpp"
 #include "base/utils.hpp"
+#include "base/profiler.hpp"
 
 #include "managers/taskmanager.hpp"
 #include "managers/scenemanager.hpp"
@@ -88,6 +89,7 @@ namespace blunted {
 
 
   void GraphicsTask::GetPhase() {
+    PROFILE_ZONE("GraphicsTask::GetPhase");
 
     boost::mutex::scoped_lock getPhaseLock(graphicsSystem->getPhaseMutex);
 
@@ -95,15 +97,15 @@ namespace blunted {
     Renderer3D *renderer3D = graphicsSystem->GetRenderer3D();
 
 
-    // poke all image2D objects
+    // poke all image2D objects. the camera views are its children, so waiting on this one waits on all of them
 
     boost::intrusive_ptr<GraphicsTaskCommand_RenderImage2D> renderImage2D(new GraphicsTaskCommand_RenderImage2D());
-    taskManager->EnqueueWork(renderImage2D, true);
-    //taskManager->NotifyWorkers();
 
 
     // collect visibles
 
+    std::vector < boost::intrusive_ptr<GraphicsTaskCommand_EnqueueView> > enqueueView; // [cameras.size()]
+
     bool success;
     boost::shared_ptr<IScene> scene = SceneManager::GetInstance().GetScene("scene3D", success);
     if (success) {
@@ -111,33 +113,30 @@ namespace blunted {
       boost::static_pointer_cast<Scene3D>(scene)->GetObjects<Camera>(e_ObjectType_Camera, cameras);
       //printf("cameras.size: %i\n", (signed int)cameras.size());
 
-      std::vector < boost::intrusive_ptr<GraphicsTaskCommand_EnqueueView> > enqueueView; // [cameras.size()]
       std::list < boost::intrusive_ptr<Camera> >::iterator cameraIter = cameras.begin();
-      int i = 0;
-      // enqueue all camera views
       while (cameraIter != cameras.end()) {
 
         if ((*cameraIter)->IsEnabled()) {
           enqueueView.push_back(boost::intrusive_ptr<GraphicsTaskCommand_EnqueueView>(new GraphicsTaskCommand_EnqueueView((*cameraIter), shadowSkipFrameCounter)));
-          taskManager->EnqueueWork(enqueueView.back(), false);
+          renderImage2D->AddChild(enqueueView.back());
         }
 
         cameraIter++;
       }
+    }
 
-      taskManager->NotifyWorkers();
-
-      for (unsigned int i = 0; i < enqueueView.size(); i++) {
-        // wait on camera views
-        enqueueView[i]->Wait();
-      }
-
+    // enqueue all camera views
+    taskManager->EnqueueWork(renderImage2D, false);
+    for (unsigned int i = 0; i < enqueueView.size(); i++) {
+      taskManager->EnqueueWork(enqueueView[i], false);
     }
+    taskManager->NotifyWorkers();
 
     renderImage2D->Wait();
   }
 
   void GraphicsTask::ProcessPhase() {
+    PROFILE_ZONE("GraphicsTask::ProcessPhase");
 
     TaskManager *taskManager = TaskManager::GetInstancePtr();
     Renderer3D *renderer3D = graphicsSystem->GetRenderer3D();
@@ -165,6 +164,7 @@ namespace blunted {
   }
 
   void GraphicsTask::PutPhase() {
+    PROFILE_ZONE("GraphicsTask::PutPhase");
     TaskManager *taskManager = TaskManager::GetInstancePtr();
     Renderer3D *renderer3D = graphicsSystem->GetRenderer3D();
 
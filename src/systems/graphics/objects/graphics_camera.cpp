@@ -5,6 +5,7 @@
 #include "graphics_camera.hpp"
 
 #include "systems/graphics/rendering/r3d_messages.hpp"
+#include "systems/graphics/rendering/r3d_renderqueue.hpp"
 
 #include "../graphics_scene.hpp"
 #include "../graphics_system.hpp"
@@ -118,6 +119,8 @@ namespace blunted {
       visibleGeometryIter++;
     }
 
+    if (caller->GetGraphicsScene()->GetGraphicsSystem()->GetSortRenderQueues()) SortRenderQueue(buffer->visibleGeometry, caller->GetPosition());
+
 
     // lights
 
@@ -5,6 +5,7 @@
 #include "graphics_light.hpp"
 
 #include "systems/graphics/rendering/r3d_messages.hpp"
+#include "systems/graphics/rendering/r3d_renderqueue.hpp"
 #include "managers/resourcemanagerpool.hpp"
 
 #include "../graphics_scene.hpp"
@@ -139,10 +140,6 @@ namespace blunted {
     //caller->SetRotation(rotation);
   }
 
-  bool GLLI_SortVertexBufferQueueEntries(const VertexBufferQueueEntry &vb1, const VertexBufferQueueEntry &vb2) {
-    return vb1.vertexBuffer->GetResource()->GetID() < vb2.vertexBuffer->GetResource()->GetID();
-  }
-
   void GraphicsLight_LightInterpreter::EnqueueShadowMap(boost::intrusive_ptr<Camera> camera, std::deque < boost::intrusive_ptr<Geometry> > visibleGeometry) {
     if (!caller->GetShadow()) return;
 
@@ -205,7 +202,8 @@ namespace blunted {
       visibleGeometryIter++;
     }
 
-    //std::sort(caller->shadowMaps.at(index).visibleGeometry.begin(), caller->shadowMaps.at(index).visibleGeometry.end(), GLLI_SortVertexBufferQueueEntries);
+    // same order as the views use; only the vertex array part of the key saves anything when drawing depth only
+    if (caller->GetGraphicsScene()->GetGraphicsSystem()->GetSortRenderQueues()) SortRenderQueue(caller->shadowMaps.at(index).visibleGeometry, caller->GetPosition());
 
 
     // all this is way too hardcoded and should somehow heed the camera bounding box better
@@ -199,6 +199,7 @@ namespace blunted {
     unsigned int programID;
     unsigned int vertexShaderID;
     unsigned int fragmentShaderID;
+    std::map<std::string, int> uniformHandles; // by uniform name, see GetUniformHandle
   };
 
   class Renderer3D : public Thread {
@@ -298,6 +299,16 @@ namespace blunted {
       virtual void SetUniformFloat3Array(const std::string &shaderName, const std::string &varName, int count, float *values) = 0;
       virtual void SetUniformMatrix4(const std::string &shaderName, const std::string &varName, const Matrix4 &mat) = 0;
 
+      /// resolves a shader's uniform once (-1 if there's no such shader), so setting it per draw or per light doesn't need
+      /// any lookups. handles stay valid for as long as the renderer lives
+      virtual int GetUniformHandle(const std::string &shaderName, const std::string &varName) = 0;
+      virtual void SetUniformInt(int uniformHandle, int value) = 0;
+      virtual void SetUniformFloat(int uniformHandle, float value) = 0;
+      virtual void SetUniformFloat2(int uniformHandle, float value1, float value2) = 0;
+      virtual void SetUniformFloat3(int uniformHandle, float value1, float value2, float value3) = 0;
+      virtual void SetUniformFloat3Array(int uniformHandle, int count, float *values) = 0;
+      virtual void SetUniformMatrix4(int uniformHandle, const Matrix4 &mat) = 0;
+
       virtual void HDRCaptureOverallBrightness() = 0;
       virtual float HDRGetOverallBrightness() = 0;
 
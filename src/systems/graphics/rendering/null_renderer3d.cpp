@@ -0,0 +1,711 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#include "null_renderer3d.hpp"
+
+#include <cmath>
+#include <cstdarg>
+
+#include "base/log.hpp"
+#include "base/utils.hpp"
+#include "base/profiler.hpp"
+#include "types/command.hpp"
+
+#include "../resources/texture.hpp"
+
+namespace blunted {
+
+  NullRenderer3D::NullRenderer3D(const std::string &recordFilename) : recordFilename(recordFilename), recordFile(0) {
+    context_width = 0;
+    context_height = 0;
+    context_bpp = 0;
+    cameraNear = 30.0;
+    cameraFar = 270.0;
+    FOV = 45;
+
+    nextID = 1;
+
+    frameCount = 0;
+    drawCallCount = 0;
+    triangleIndexCount = 0;
+    stateChangeCount = 0;
+    textureBindCount = 0;
+    uniformCount = 0;
+    uniformByNameCount = 0;
+    uniformNameAllocationCount = 0;
+    bufferUploadCount = 0;
+    bufferUploadBytes = 0;
+    textureUploadCount = 0;
+    textureUploadBytes = 0;
+
+    currentShader = shaders.end();
+  }
+
+  NullRenderer3D::~NullRenderer3D() {
+    if (recordFile) fclose(recordFile);
+  }
+
+  void NullRenderer3D::SwapBuffers() {
+    frameCount++;
+    Record("swap %lu\n", frameCount);
+  }
+
+  void NullRenderer3D::SetMatrix(const std::string &shaderUniformName, const Matrix4 &matrix) {
+    if (currentShader == shaders.end()) return;
+    SetUniformMatrix4(currentShader->first, shaderUniformName, matrix);
+  }
+
+  void NullRenderer3D::RenderOverlay2D(const std::vector<Overlay2DQueueEntry> &overlay2DQueue) {
+    if (overlay2DQueue.empty()) return;
+
+    // same calls as the opengl version, so the counts compare
+    StateChange("blendingfunction", 0);
+    SetBlendingMode(e_BlendingMode_On);
+    SetDepthTesting(false);
+    SetDepthMask(false);
+    SetCullingMode(e_CullingMode_Off);
+
+    UseShader("overlay");
+    SetMatrix("projection", CreateOrthoMatrix(0, context_width, context_height, 0, 0.1, 10));
+    StateChange("vertexarray", 0);
+    SetTextureUnit(0);
+
+    int modelHandle = GetUniformHandle("overlay", "model");
+
+    for (unsigned int i = 0; i < overlay2DQueue.size(); i++) {
+      SetUniformMatrix4(modelHandle, Matrix4(MATRIX4_IDENTITY));
+      BindTexture(overlay2DQueue[i].texture->GetResource()->GetID());
+      Draw(0, 6);
+    }
+
+    StateChange("vertexarray", 0);
+    SetDepthTesting(true);
+    SetCullingMode(e_CullingMode_Back);
+    SetDepthMask(true);
+    SetBlendingMode(e_BlendingMode_Off);
+  }
+
+  void NullRenderer3D::RenderOverlay2D() {
+    SetMatrix("orthoProjectionMatrix", CreateOrthoMatrix(-1, 1, -1, 1, 0.0f, 1.0f));
+    SetMatrix("orthoViewMatrix", Matrix4(MATRIX4_IDENTITY));
+    SetCullingMode(e_CullingMode_Off);
+    SetTextureUnit(4);
+    BindTexture(0);
+    SetTextureUnit(0);
+    Draw(0, 6);
+    SetTextureUnit(4);
+    BindTexture(0);
+    SetCullingMode(e_CullingMode_Back);
+  }
+
+  void NullRenderer3D::RenderLights(std::deque<LightQueueEntry> &lightQueue, const Matrix4 &projectionMatrix, const Matrix4 &viewMatrix) {
+    if (currentShader == shaders.end()) return;
+    const std::string &shaderName = currentShader->first;
+
+    int hasShadowHandle = GetUniformHandle(shaderName, "has_shadow");
+    int lightViewProjectionMatrixHandle = GetUniformHandle(shaderName, "lightViewProjectionMatrix");
+    int lightColorHandle = GetUniformHandle(shaderName, "lightColor");
+    int lightRadiusHandle = GetUniformHandle(shaderName, "lightRadius");
+    int lightPositionHandle = GetUniformHandle(shaderName, "lightPosition");
+    int projectionMatrixHandle = GetUniformHandle(shaderName, "projectionMatrix");
+    int viewMatrixHandle = GetUniformHandle(shaderName, "viewMatrix");
+    int modelMatrixHandle = GetUniformHandle(shaderName, "modelMatrix");
+
+    UniformByName(shaderName, "cameraPosition");
+
+    // the opengl renderer only ever draws lights as fullscreen quads (light types other than directional don't exist yet)
+    std::deque<LightQueueEntry>::iterator lightIter = lightQueue.begin();
+    while (lightIter != lightQueue.end()) {
+      Uniform(hasShadowHandle);
+      if ((*lightIter).hasShadow) {
+        SetTextureUnit(7);
+        BindTexture((*lightIter).shadowMapTexture->GetResource()->GetID());
+        Uniform(lightViewProjectionMatrixHandle);
+      }
+      Uniform(lightColorHandle);
+      Uniform(lightRadiusHandle);
+      Uniform(lightPositionHandle);
+
+      SetCullingMode(e_CullingMode_Off);
+      SetDepthFunction(e_DepthFunction_Always);
+      Uniform(projectionMatrixHandle);
+      Uniform(viewMatrixHandle);
+      Uniform(modelMatrixHandle);
+      Draw(0, 6);
+
+      if ((*lightIter).hasShadow) {
+        BindTexture(0);
+        SetTextureUnit(0);
+      }
+
+      lightIter++;
+    }
+  }
+
+
+  // init & exit
+
+  bool NullRenderer3D::CreateContext(int width, int height, int bpp, bool fullscreen) {
+    context_width = width;
+    context_height = height;
+    context_bpp = bpp;
+
+    if (!recordFilename.empty()) {
+      recordFile = fopen(recordFilename.c_str(), "w");
+      if (!recordFile) Log(e_Error, "NullRenderer3D", "CreateContext", "Could not open " + recordFilename + " for recording");
+    }
+    Record("context %i %i %i %i\n", width, height, bpp, (int)fullscreen);
+
+    // the ones the opengl renderer loads, so UseShader switches like it would
+    LoadShader("simple", "media/shaders/simple");
+    LoadShader("lighting", "media/shaders/lighting");
+    LoadShader("ambient", "media/shaders/ambient");
+    LoadShader("zphase", "media/shaders/zphase");
+    LoadShader("postprocess", "media/shaders/postprocess");
+    LoadShader("overlay", "media/shaders/overlay");
+
+    return true;
+  }
+
+  void NullRenderer3D::Exit() {
+    shaders.clear();
+    currentShader = shaders.end();
+    Record("exit\n");
+    if (recordFile) fflush(recordFile);
+  }
+
+  int NullRenderer3D::CreateView(float x_percent, float y_percent, float width_percent, float height_percent) {
+
+    Log(e_Notice, "NullRenderer3D", "CreateView", "Creating new view, id " + int_to_str(views.size()));
+
+    View view;
+
+    view.target = e_ViewRenderTarget_Context;
+    view.targetTexID = 0;
+    view.x = int(floor(x_percent * 0.01 * context_width));
+    view.y = int(floor(y_percent * 0.01 * context_height));
+    view.width = int(floor(width_percent * 0.01 * context_width));
+    view.height = int(floor(height_percent * 0.01 * context_height));
+
+    // no buffers to back these, but the ids need to be distinct
+    view.gBufferID = CreateFrameBuffer();
+    view.gBuffer_DepthTexID = CreateTexture(e_InternalPixelFormat_DepthComponent16, e_PixelFormat_DepthComponent, view.width, view.height, false, false, false, false, false);
+    view.gBuffer_AlbedoTexID = CreateTexture(e_InternalPixelFormat_RGBA16F, e_PixelFormat_RGBA, view.width, view.height, false, false, false, false, false);
+    view.gBuffer_NormalTexID = CreateTexture(e_InternalPixelFormat_RGBA16F, e_PixelFormat_RGBA, view.width, view.height, false, false, false, false, false);
+    view.gBuffer_AuxTexID = CreateTexture(e_InternalPixelFormat_RGBA16F, e_PixelFormat_RGBA, view.width, view.height, false, false, false, false, false);
+
+    view.accumBufferID = CreateFrameBuffer();
+    view.accumBuffer_AccumTexID = CreateTexture(e_InternalPixelFormat_RGBA16F, e_PixelFormat_RGBA, view.width, view.height, false, false, false, false, false);
+    view.accumBuffer_ModifierTexID = CreateTexture(e_InternalPixelFormat_RGBA16F, e_PixelFormat_RGBA, view.width, view.height, false, false, false, false, false);
+
+    views.push_back(view);
+
+    return views.size() - 1;
+  }
+
+  View &NullRenderer3D::GetView(int viewID) {
+    return views.at(viewID);
+  }
+
+  void NullRenderer3D::DeleteView(int viewID) {
+    Log(e_Notice, "NullRenderer3D", "DeleteView", "Deleting view, id " + int_to_str(viewID));
+    Record("deleteview %i\n", viewID);
+  }
+
+
+  // general
+
+  void NullRenderer3D::SetCullingMode(e_CullingMode cullingMode) {
+    StateChange("cullingmode", cullingMode);
+  }
+
+  void NullRenderer3D::SetBlendingMode(e_BlendingMode blendingMode) {
+    StateChange("blendingmode", blendingMode);
+  }
+
+  void NullRenderer3D::SetDepthFunction(e_DepthFunction depthFunction) {
+    StateChange("depthfunction", depthFunction);
+  }
+
+  void NullRenderer3D::SetDepthTesting(bool OnOff) {
+    StateChange("depthtesting", OnOff);
+  }
+
+  void NullRenderer3D::SetDepthMask(bool OnOff) {
+    StateChange("depthmask", OnOff);
+  }
+
+  void NullRenderer3D::SetBlendingFunction(e_BlendingFunction blendingFunction1, e_BlendingFunction blendingFunction2) {
+    StateChange("blendingfunction", blendingFunction1 * 2 + blendingFunction2);
+  }
+
+  void NullRenderer3D::SetTextureMode(e_TextureMode textureMode) {
+    StateChange("texturemode", textureMode);
+  }
+
+  void NullRenderer3D::SetColor(const Vector3 &color, float alpha) {
+    StateChange("color", 0);
+  }
+
+  void NullRenderer3D::SetColorMask(bool r, bool g, bool b, bool alpha) {
+    StateChange("colormask", r * 8 + g * 4 + b * 2 + alpha);
+  }
+
+  void NullRenderer3D::ClearBuffer(const Vector3 &color, bool clearDepth, bool clearColor) {
+    Record("clear %i %i\n", (int)clearDepth, (int)clearColor);
+  }
+
+  Matrix4 NullRenderer3D::CreatePerspectiveMatrix(float aspectRatio, float nearCap, float farCap) {
+    Matrix4 projectionMatrix;
+    projectionMatrix.ConstructProjection(FOV, aspectRatio, nearCap == -1 ? cameraNear : nearCap, farCap == -1 ? cameraFar : farCap);
+    return projectionMatrix;
+  }
+
+  Matrix4 NullRenderer3D::CreateOrthoMatrix(float left, float right, float bottom, float top, float nearCap, float farCap) {
+    Matrix4 orthoMatrix;
+    orthoMatrix.ConstructOrtho(left, right, bottom, top, nearCap == -1 ? cameraNear : nearCap, farCap == -1 ? cameraFar : farCap);
+    return orthoMatrix;
+  }
+
+
+  // vertex buffers
+
+  VertexBufferID NullRenderer3D::CreateVertexBuffer(float *vertices, unsigned int verticesDataSize, std::vector<unsigned int> indices, e_VertexBufferUsage usage) {
+    VertexBufferID vertexBufferID;
+    vertexBufferID.bufferID = nextID++;
+    vertexBufferID.vertexArrayID = nextID++;
+    vertexBufferID.elementArrayID = nextID++;
+
+    // without indices, the opengl renderer makes one per vertex
+    unsigned int indexCount = indices.size();
+    if (indexCount == 0) indexCount = verticesDataSize / GetTriangleMeshElementCount() / 3;
+    unsigned long long bytes = verticesDataSize * sizeof(float) + indexCount * sizeof(unsigned int);
+
+    bufferUploadCount++;
+    bufferUploadBytes += bytes;
+    Record("createvertexbuffer %i %llu\n", vertexBufferID.bufferID, bytes);
+
+    return vertexBufferID;
+  }
+
+  void NullRenderer3D::UpdateVertexBuffer(VertexBufferID vertexBufferID, float *vertices, unsigned int verticesDataSize) {
+    unsigned long long bytes = verticesDataSize * sizeof(float);
+    bufferUploadCount++;
+    bufferUploadBytes += bytes;
+    Record("updatevertexbuffer %i %llu\n", vertexBufferID.bufferID, bytes);
+  }
+
+  void NullRenderer3D::DeleteVertexBuffer(VertexBufferID vertexBufferID) {
+    Record("deletevertexbuffer %i\n", vertexBufferID.bufferID);
+  }
+
+  void NullRenderer3D::RenderVertexBuffer(const std::deque<VertexBufferQueueEntry> &vertexBufferQueue, e_RenderMode renderMode) {
+
+    // the opengl renderer's state tracking: a vertex array bind when the buffer changes, texture binds when the material
+    // does, and one draw per run of adjacent indices with the same material
+
+    int currentBoundBuffer = -1;
+    int currentTextureIDs[4] = { -1, -1, -1, -1 };
+    Matrix4 transform;
+
+    int modelMatrixHandle = currentShader != shaders.end() ? GetUniformHandle(currentShader->first, "modelMatrix") : -1;
+    int materialParamsHandle = -1;
+    int materialBoolsHandle = -1;
+    if (renderMode == e_RenderMode_Full) {
+      materialParamsHandle = GetUniformHandle("simple", "materialparams");
+      materialBoolsHandle = GetUniformHandle("simple", "materialbools");
+    }
+
+    std::deque<VertexBufferQueueEntry>::const_iterator vertexBufferQueueIter = vertexBufferQueue.begin();
+    while (vertexBufferQueueIter != vertexBufferQueue.end()) {
+      const VertexBufferQueueEntry &queueEntry = *vertexBufferQueueIter;
+
+      int vaoID = queueEntry.vertexBuffer->GetResource()->GetVaoID();
+      if (vaoID != currentBoundBuffer) {
+        StateChange("vertexarray", vaoID);
+        currentBoundBuffer = vaoID;
+      }
+      transform.Construct(queueEntry.position, Vector3(1, 1, 1), queueEntry.rotation);
+      SetUniformMatrix4(modelMatrixHandle, transform);
+
+      int chunkStart = 0;
+      int chunkCount = 0;
+
+      std::deque<VertexBufferIndex>::const_iterator vertexBufferIter = queueEntry.vertexBufferIndices.begin();
+      while (vertexBufferIter != queueEntry.vertexBufferIndices.end()) {
+        const VertexBufferIndex &vbIndex = *vertexBufferIter;
+
+        if (renderMode != e_RenderMode_GeometryOnly) {
+          int textureIDs[4] = { 0, 0, 0, 0 };
+          if (vbIndex.material.diffuseTexture) textureIDs[0] = vbIndex.material.diffuseTexture->GetResource()->GetID();
+          if (renderMode == e_RenderMode_Full) {
+            if (vbIndex.material.normalTexture) textureIDs[1] = vbIndex.material.normalTexture->GetResource()->GetID();
+            if (vbIndex.material.specularTexture) textureIDs[2] = vbIndex.material.specularTexture->GetResource()->GetID();
+            if (vbIndex.material.illuminationTexture) textureIDs[3] = vbIndex.material.illuminationTexture->GetResource()->GetID();
+          }
+
+          if (textureIDs[0] != currentTextureIDs[0] || textureIDs[1] != currentTextureIDs[1] ||
+              textureIDs[2] != currentTextureIDs[2] || textureIDs[3] != currentTextureIDs[3]) {
+            Draw(chunkStart, chunkCount);
+            chunkCount = 0;
+
+            if (renderMode == e_RenderMode_Full) {
+              for (int unit = 1; unit < 4; unit++) {
+                if (textureIDs[unit] != 0 && textureIDs[unit] != currentTextureIDs[unit]) {
+                  SetTextureUnit(unit);
+                  BindTexture(textureIDs[unit]);
+                }
+              }
+            }
+            if (textureIDs[0] != currentTextureIDs[0]) {
+              SetTextureUnit(0);
+              BindTexture(textureIDs[0]);
+            }
+
+            if (renderMode == e_RenderMode_Full) {
+              Uniform(materialParamsHandle);
+              Uniform(materialBoolsHandle);
+            }
+
+            for (int unit = 0; unit < 4; unit++) currentTextureIDs[unit] = textureIDs[unit];
+          }
+        }
+
+        if (chunkCount > 0 && chunkStart + chunkCount != vbIndex.startIndex) {
+          Draw(chunkStart, chunkCount);
+          chunkCount = 0;
+        }
+        if (chunkCount == 0) chunkStart = vbIndex.startIndex;
+        chunkCount += vbIndex.size;
+
+        vertexBufferIter++;
+      }
+
+      Draw(chunkStart, chunkCount);
+
+      vertexBufferQueueIter++;
+    }
+
+    if (renderMode != e_RenderMode_GeometryOnly) {
+      if (renderMode == e_RenderMode_Full) {
+        for (int unit = 1; unit < 4; unit++) {
+          SetTextureUnit(unit);
+          BindTexture(0);
+        }
+      }
+      SetTextureUnit(0);
+      BindTexture(0);
+    }
+
+    StateChange("vertexarray", 0);
+  }
+
+  void NullRenderer3D::RenderAABB(std::list<VertexBufferQueueEntry> &vertexBufferQueue) {
+  }
+
+  void NullRenderer3D::RenderAABB(std::list<LightQueueEntry> &lightQueue) {
+  }
+
+
+  // lights
+
+  void NullRenderer3D::SetLight(const Vector3 &position, const Vector3 &color, float radius) {
+  }
+
+
+  // textures
+
+  int NullRenderer3D::CreateTexture(e_InternalPixelFormat internalPixelFormat, e_PixelFormat pixelFormat, int width, int height, bool alpha, bool repeat, bool mipmaps, bool filter, bool multisample, bool compareDepth) {
+    int textureID = nextID++;
+    Record("createtexture %i %i %i\n", textureID, width, height);
+    return textureID;
+  }
+
+  void NullRenderer3D::ResizeTexture(int textureID, SDL_Surface *source, e_InternalPixelFormat internalPixelFormat, e_PixelFormat pixelFormat, bool alpha, bool mipmaps) {
+    UpdateTexture(textureID, source, alpha, mipmaps);
+  }
+
+  void NullRenderer3D::UpdateTexture(int textureID, SDL_Surface *source, bool alpha, bool mipmaps) {
+    unsigned long long bytes = (unsigned long long)source->pitch * source->h;
+    textureUploadCount++;
+    textureUploadBytes += bytes;
+    Record("updatetexture %i %llu\n", textureID, bytes);
+  }
+
+  void NullRenderer3D::DeleteTexture(int textureID) {
+    Record("deletetexture %i\n", textureID);
+  }
+
+  void NullRenderer3D::CopyFrameBufferToTexture(int textureID, int width, int height) {
+    BindTexture(textureID);
+    Record("copyframebuffer %i %i %i\n", textureID, width, height);
+  }
+
+  void NullRenderer3D::BindTexture(int textureID) {
+    textureBindCount++;
+    Record("bindtexture %i\n", textureID);
+  }
+
+  void NullRenderer3D::SetTextureUnit(int textureUnit) {
+    StateChange("textureunit", textureUnit);
+  }
+
+  void NullRenderer3D::SetClientTextureUnit(int textureUnit) {
+    StateChange("clienttextureunit", textureUnit);
+  }
+
+
+  // frame buffers
+
+  int NullRenderer3D::CreateFrameBuffer() {
+    int fbID = nextID++;
+    Record("createframebuffer %i\n", fbID);
+    return fbID;
+  }
+
+  void NullRenderer3D::DeleteFrameBuffer(int fbID) {
+    Record("deleteframebuffer %i\n", fbID);
+  }
+
+  void NullRenderer3D::BindFrameBuffer(int fbID) {
+    StateChange("framebuffer", fbID);
+  }
+
+  void NullRenderer3D::SetFrameBufferRenderBuffer(e_TargetAttachment targetAttachment, int rbID) {
+    StateChange("framebufferrenderbuffer", rbID);
+  }
+
+  void NullRenderer3D::SetFrameBufferTexture2D(e_TargetAttachment targetAttachment, int texID) {
+    StateChange("framebuffertexture", texID);
+  }
+
+  bool NullRenderer3D::CheckFrameBufferStatus() {
+    return true;
+  }
+
+  void NullRenderer3D::SetFramebufferGammaCorrection(bool onOff) {
+    StateChange("gammacorrection", onOff);
+  }
+
+
+  // render buffers
+
+  int NullRenderer3D::CreateRenderBuffer() {
+    int rbID = nextID++;
+    Record("createrenderbuffer %i\n", rbID);
+    return rbID;
+  }
+
+  void NullRenderer3D::DeleteRenderBuffer(int rbID) {
+    Record("deleterenderbuffer %i\n", rbID);
+  }
+
+  void NullRenderer3D::BindRenderBuffer(int rbID) {
+    StateChange("renderbuffer", rbID);
+  }
+
+  void NullRenderer3D::SetRenderBufferStorage(e_InternalPixelFormat internalPixelFormat, int width, int height) {
+    Record("renderbufferstorage %i %i\n", width, height);
+  }
+
+
+  // render targets
+
+  void NullRenderer3D::SetRenderTargets(std::vector<e_TargetAttachment> targetAttachments) {
+    StateChange("rendertargets", targetAttachments.size());
+  }
+
+
+  // utility
+
+  void NullRenderer3D::SetFOV(float angle) {
+    FOV = angle;
+  }
+
+  void NullRenderer3D::PushAttribute(int attr) {
+  }
+
+  void NullRenderer3D::PopAttribute() {
+  }
+
+  void NullRenderer3D::SetViewport(int x, int y, int width, int height) {
+    StateChange("viewport", width * height);
+  }
+
+  void NullRenderer3D::GetContextSize(int &width, int &height, int &bpp) {
+    width = context_width;
+    height = context_height;
+    bpp = context_bpp;
+  }
+
+  void NullRenderer3D::SetPolygonOffset(float scale, float bias) {
+    StateChange("polygonoffset", 0);
+  }
+
+
+  // shaders
+
+  void NullRenderer3D::LoadShader(const std::string &name, const std::string &filename) {
+    Shader shader;
+    shader.name = filename;
+    shader.programID = nextID++;
+    shader.vertexShaderID = nextID++;
+    shader.fragmentShaderID = nextID++;
+    shaders.insert(std::pair<std::string, Shader>(name, shader));
+    Record("loadshader %s %i\n", name.c_str(), shader.programID);
+  }
+
+  void NullRenderer3D::UseShader(const std::string &name) {
+    std::map<std::string, Shader>::iterator shaderIter = shaders.find(name);
+    if (shaderIter != shaders.end()) {
+      currentShader = shaderIter;
+      StateChange("program", shaderIter->second.programID);
+    } else {
+      StateChange("program", 0);
+    }
+  }
+
+  void NullRenderer3D::SetUniformInt(const std::string &shaderName, const std::string &varName, int value) {
+    UniformByName(shaderName, varName);
+  }
+
+  void NullRenderer3D::SetUniformFloat(const std::string &shaderName, const std::string &varName, float value) {
+    UniformByName(shaderName, varName);
+  }
+
+  void NullRenderer3D::SetUniformFloat2(const std::string &shaderName, const std::string &varName, float value1, float value2) {
+    UniformByName(shaderName, varName);
+  }
+
+  void NullRenderer3D::SetUniformFloat3(const std::string &shaderName, const std::string &varName, float value1, float value2, float value3) {
+    UniformByName(shaderName, varName);
+  }
+
+  void NullRenderer3D::SetUniformFloat3Array(const std::string &shaderName, const std::string &varName, int count, float *values) {
+    UniformByName(shaderName, varName);
+  }
+
+  void NullRenderer3D::SetUniformMatrix4(const std::string &shaderName, const std::string &varName, const Matrix4 &mat) {
+    UniformByName(shaderName, varName);
+  }
+
+  int NullRenderer3D::GetUniformHandle(const std::string &shaderName, const std::string &varName) {
+    std::map<std::string, Shader>::iterator shaderIter = shaders.find(shaderName);
+    if (shaderIter == shaders.end()) return -1;
+
+    std::map<std::string, int> &uniformHandles = shaderIter->second.uniformHandles;
+    std::map<std::string, int>::iterator iter = uniformHandles.find(varName);
+    if (iter != uniformHandles.end()) return iter->second;
+
+    int uniformHandle = uniformNames.size();
+    uniformNames.push_back(shaderName + " " + varName);
+    uniformHandles.insert(std::pair<std::string, int>(varName, uniformHandle));
+    uniformNameAllocationCount++;
+    return uniformHandle;
+  }
+
+  void NullRenderer3D::SetUniformInt(int uniformHandle, int value) {
+    Uniform(uniformHandle);
+  }
+
+  void NullRenderer3D::SetUniformFloat(int uniformHandle, float value) {
+    Uniform(uniformHandle);
+  }
+
+  void NullRenderer3D::SetUniformFloat2(int uniformHandle, float value1, float value2) {
+    Uniform(uniformHandle);
+  }
+
+  void NullRenderer3D::SetUniformFloat3(int uniformHandle, float value1, float value2, float value3) {
+    Uniform(uniformHandle);
+  }
+
+  void NullRenderer3D::SetUniformFloat3Array(int uniformHandle, int count, float *values) {
+    Uniform(uniformHandle);
+  }
+
+  void NullRenderer3D::SetUniformMatrix4(int uniformHandle, const Matrix4 &mat) {
+    Uniform(uniformHandle);
+  }
+
+  void NullRenderer3D::HDRCaptureOverallBrightness() {
+  }
+
+  float NullRenderer3D::HDRGetOverallBrightness() {
+    return 128;
+  }
+
+
+  // bookkeeping
+
+  void NullRenderer3D::Record(const char *format, ...) {
+    if (!recordFile) return;
+    va_list args;
+    va_start(args, format);
+    vfprintf(recordFile, format, args);
+    va_end(args);
+  }
+
+  void NullRenderer3D::Draw(int startIndex, int count) {
+    if (count <= 0) return;
+    drawCallCount++;
+    triangleIndexCount += count;
+    Record("draw %i %i\n", startIndex, count);
+  }
+
+  void NullRenderer3D::StateChange(const char *name, int value) {
+    stateChangeCount++;
+    Record("%s %i\n", name, value);
+  }
+
+  void NullRenderer3D::Uniform(int uniformHandle) {
+    if (uniformHandle < 0) return;
+    uniformCount++;
+    Record("uniform %s\n", uniformNames[uniformHandle].c_str());
+  }
+
+  void NullRenderer3D::UniformByName(const std::string &shaderName, const std::string &varName) {
+    uniformByNameCount++;
+    Uniform(GetUniformHandle(shaderName, varName));
+  }
+
+  void NullRenderer3D::LogCounters() {
+    float frames = frameCount > 0 ? frameCount : 1;
+    char counters[512];
+    sprintf(counters, "%lu frames; per frame: %.1f draw calls (%.0f indices), %.1f state changes, %.1f texture binds, "
+                      "%.1f uniforms (%.1f by name, %.2f uniform names allocated), %.1f buffer uploads (%.0f bytes), %.1f texture uploads (%.0f bytes)",
+            frameCount, drawCallCount / frames, triangleIndexCount / frames, stateChangeCount / frames, textureBindCount / frames,
+            uniformCount / frames, uniformByNameCount / frames, uniformNameAllocationCount / frames,
+            bufferUploadCount / frames, bufferUploadBytes / frames, textureUploadCount / frames, textureUploadBytes / frames);
+    Log(e_Notice, "NullRenderer3D", "LogCounters", counters);
+  }
+
+
+  // thread main loop
+
+  void NullRenderer3D::operator()() {
+    Log(e_Notice, "NullRenderer3D", "operator()()", "Starting NullRenderer3D thread");
+    PROFILE_THREAD_NAME("NullRenderer3D");
+
+    bool quit = false;
+    while (!quit) {
+      bool isMessage;
+      boost::intrusive_ptr<Command> message = messageQueue.WaitForMessage(isMessage, 1);
+      if (isMessage) {
+        PROFILE_ZONE(message->GetProfileName());
+        if (!message->Handle(this)) quit = true;
+        message.reset();
+      }
+    }
+
+    Exit();
+
+    LogCounters();
+
+    Log(e_Notice, "NullRenderer3D", "operator()()", "Shutting down NullRenderer3D thread");
+
+    if (messageQueue.GetPending() > 0) Log(e_Error, "NullRenderer3D", "operator()()", int_to_str(messageQueue.GetPending()) + " messages left on quit!");
+  }
+
+}
@@ -0,0 +1,162 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_GRAPHICS3D_NULL
+#define _HPP_GRAPHICS3D_NULL
+
+#include "interface_renderer3d.hpp"
+
+#include <cstdio>
+
+namespace blunted {
+
+  // accepts everything and draws nothing, so the cpu side of the graphics system can run (and be timed) without a gl
+  // context. counts what the opengl renderer would have sent to the driver, and optionally writes every call to a text file
+  class NullRenderer3D : public Renderer3D {
+
+    public:
+      /// recordFilename may be empty, for no recording
+      NullRenderer3D(const std::string &recordFilename = "");
+      virtual ~NullRenderer3D();
+
+      virtual void SwapBuffers();
+
+      virtual void SetMatrix(const std::string &shaderUniformName, const Matrix4 &matrix);
+
+      virtual void RenderOverlay2D(const std::vector<Overlay2DQueueEntry> &overlay2DQueue);
+      virtual void RenderOverlay2D();
+      virtual void RenderLights(std::deque<LightQueueEntry> &lightQueue, const Matrix4 &projectionMatrix, const Matrix4 &viewMatrix);
+
+      // init & exit
+      virtual bool CreateContext(int width, int height, int bpp, bool fullscreen);
+      virtual void Exit();
+
+      virtual int CreateView(float x_percent, float y_percent, float width_percent, float height_percent);
+      virtual View &GetView(int viewID);
+      virtual void DeleteView(int viewID);
+
+      // general
+      virtual void SetCullingMode(e_CullingMode cullingMode);
+      virtual void SetBlendingMode(e_BlendingMode blendingMode);
+      virtual void SetDepthFunction(e_DepthFunction depthFunction);
+      virtual void SetDepthTesting(bool OnOff);
+      virtual void SetDepthMask(bool OnOff);
+      virtual void SetBlendingFunction(e_BlendingFunction blendingFunction1, e_BlendingFunction blendingFunction2);
+      virtual void SetTextureMode(e_TextureMode textureMode);
+      virtual void SetColor(const Vector3 &color, float alpha);
+      virtual void SetColorMask(bool r, bool g, bool b, bool alpha);
+
+      virtual void ClearBuffer(const Vector3 &color, bool clearDepth, bool clearColor);
+
+      virtual Matrix4 CreatePerspectiveMatrix(float aspectRatio, float nearCap = -1, float farCap = -1);
+      virtual Matrix4 CreateOrthoMatrix(float left, float right, float bottom, float top, float nearCap = -1, float farCap = -1);
+
+      // vertex buffers
+      virtual VertexBufferID CreateVertexBuffer(float *vertices, unsigned int verticesDataSize, std::vector<unsigned int> indices, e_VertexBufferUsage usage);
+      virtual void UpdateVertexBuffer(VertexBufferID vertexBufferID, float *vertices, unsigned int verticesDataSize);
+      virtual void DeleteVertexBuffer(VertexBufferID vertexBufferID);
+      virtual void RenderVertexBuffer(const std::deque<VertexBufferQueueEntry> &vertexBufferQueue, e_RenderMode renderMode = e_RenderMode_Full);
+      virtual void RenderAABB(std::list<VertexBufferQueueEntry> &vertexBufferQueue);
+      virtual void RenderAABB(std::list<LightQueueEntry> &lightQueue);
+
+      // lights
+      virtual void SetLight(const Vector3 &position, const Vector3 &color, float radius);
+
+      // textures
+      virtual int CreateTexture(e_InternalPixelFormat internalPixelFormat, e_PixelFormat pixelFormat, int width, int height, bool alpha = false, bool repeat = true, bool mipmaps = true, bool filter = true, bool multisample = false, bool compareDepth = false);
+      virtual void ResizeTexture(int textureID, SDL_Surface *source, e_InternalPixelFormat internalPixelFormat, e_PixelFormat pixelFormat, bool alpha = false, bool mipmaps = true);
+      virtual void UpdateTexture(int textureID, SDL_Surface *source, bool alpha = false, bool mipmaps = true);
+      virtual void DeleteTexture(int textureID);
+      virtual void CopyFrameBufferToTexture(int textureID, int width, int height);
+      virtual void BindTexture(int textureID);
+      virtual void SetTextureUnit(int textureUnit);
+      virtual void SetClientTextureUnit(int textureUnit);
+
+      // frame buffers
+      virtual int CreateFrameBuffer();
+      virtual void DeleteFrameBuffer(int fbID);
+      virtual void BindFrameBuffer(int fbID);
+      virtual void SetFrameBufferRenderBuffer(e_TargetAttachment targetAttachment, int rbID);
+      virtual void SetFrameBufferTexture2D(e_TargetAttachment targetAttachment, int texID);
+      virtual bool CheckFrameBufferStatus();
+      virtual void SetFramebufferGammaCorrection(bool onOff);
+
+      // render buffers
+      virtual int CreateRenderBuffer();
+      virtual void DeleteRenderBuffer(int rbID);
+      virtual void BindRenderBuffer(int rbID);
+      virtual void SetRenderBufferStorage(e_InternalPixelFormat internalPixelFormat, int width, int height);
+
+      // render targets
+      virtual void SetRenderTargets(std::vector<e_TargetAttachment> targetAttachments);
+
+      // utility
+      virtual void SetFOV(float angle);
+      virtual void PushAttribute(int attr);
+      virtual void PopAttribute();
+      virtual void SetViewport(int x, int y, int width, int height);
+      virtual void GetContextSize(int &width, int &height, int &bpp);
+      virtual void SetPolygonOffset(float scale, float bias);
+
+      // shaders
+      virtual void LoadShader(const std::string &name, const std::string &filename);
+      virtual void UseShader(const std::string &name);
+      virtual void SetUniformInt(const std::string &shaderName, const std::string &varName, int value);
+      virtual void SetUniformFloat(const std::string &shaderName, const std::string &varName, float value);
+      virtual void SetUniformFloat2(const std::string &shaderName, const std::string &varName, float value1, float value2);
+      virtual void SetUniformFloat3(const std::string &shaderName, const std::string &varName, float value1, float value2, float value3);
+      virtual void SetUniformFloat3Array(const std::string &shaderName, const std::string &varName, int count, float *values);
+      virtual void SetUniformMatrix4(const std::string &shaderName, const std::string &varName, const Matrix4 &mat);
+
+      virtual int GetUniformHandle(const std::string &shaderName, const std::string &varName);
+      virtual void SetUniformInt(int uniformHandle, int value);
+      virtual void SetUniformFloat(int uniformHandle, float value);
+      virtual void SetUniformFloat2(int uniformHandle, float value1, float value2);
+      virtual void SetUniformFloat3(int uniformHandle, float value1, float value2, float value3);
+      virtual void SetUniformFloat3Array(int uniformHandle, int count, float *values);
+      virtual void SetUniformMatrix4(int uniformHandle, const Matrix4 &mat);
+
+      virtual void HDRCaptureOverallBrightness();
+      virtual float HDRGetOverallBrightness();
+
+      void operator()();
+
+    protected:
+      void Record(const char *format, ...);
+      void Draw(int startIndex, int count);
+      void StateChange(const char *name, int value);
+      void Uniform(int uniformHandle);
+      void UniformByName(const std::string &shaderName, const std::string &varName);
+      void LogCounters();
+
+      std::string recordFilename;
+      FILE *recordFile;
+
+      int context_width, context_height, context_bpp;
+      float cameraNear;
+      float cameraFar;
+      float FOV;
+
+      int nextID; // shared by all kinds of handles, none of them are ever 0
+      std::vector<std::string> uniformNames; // by uniform handle, for the recording
+
+      // what the opengl renderer would have done, since CreateContext
+      unsigned long frameCount;
+      unsigned long drawCallCount;
+      unsigned long long triangleIndexCount;
+      unsigned long stateChangeCount;
+      unsigned long textureBindCount;
+      unsigned long uniformCount;
+      unsigned long uniformByNameCount;
+      unsigned long uniformNameAllocationCount;
+      unsigned long bufferUploadCount;
+      unsigned long long bufferUploadBytes;
+      unsigned long textureUploadCount;
+      unsigned long long textureUploadBytes;
+
+  };
+
+}
+
+#endif
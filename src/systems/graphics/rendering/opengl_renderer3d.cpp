@@ -35,6 +35,7 @@
 #include "types/command.hpp"
 #include "base/sdl_surface.hpp"
 #include "base/utils.hpp"
+#include "base/profiler.hpp"
 #include "base/math/bluntmath.hpp"
 
 #include "base/geometry/aabb.hpp"
@@ -64,6 +65,14 @@ struct GLfunctions {
 
     currentShader = shaders.end();
 
+    frameCount = 0;
+    uniformSetCount = 0;
+    uniformSetByNameCount = 0;
+    uniformNameAllocationCount = 0;
+    drawCallCount = 0;
+    vertexArrayBindCount = 0;
+    textureBindCount = 0;
+
     //SetPriorityClass(thread.native_handle(), HIGH_PRIORITY_CLASS);
   };
 
@@ -72,6 +81,7 @@ struct GLfunctions {
 
   void OpenGLRenderer3D::SwapBuffers() {
     SDL_GL_SwapWindow(window);
+    frameCount++;
   }
 
   void OpenGLRenderer3D::SetMatrix(const std::string &shaderUniformName, const Matrix4 &matrix) {
@@ -102,13 +112,15 @@ struct GLfunctions {
     mapping.glBindVertexArray(overlayBuffer.vertexArrayID);
     SetTextureUnit(0);
 
+    int modelHandle = GetUniformHandle("overlay", "model");
+
     for (unsigned int i = 0; i < overlay2DQueue.size(); i++) {
       const Overlay2DQueueEntry &queueEntry = overlay2DQueue[i];
 
       Matrix4 modelMatrix(MATRIX4_IDENTITY);
       modelMatrix.SetTranslation(Vector3(queueEntry.position[0], queueEntry.position[1], -1.0f));
       modelMatrix.SetScale(Vector3(queueEntry.size[0], queueEntry.size[1], 1.0f));
-      SetMatrix("model", modelMatrix);
+      SetUniformMatrix4(modelHandle, modelMatrix);
 
       BindTexture(queueEntry.texture->GetResource()->GetID());
       mapping.glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -160,7 +172,18 @@ struct GLfunctions {
   void OpenGLRenderer3D::RenderLights(std::deque<LightQueueEntry> &lightQueue, const Matrix4 &projectionMatrix, const Matrix4 &viewMatrix) {
     Vector3 cameraPos = viewMatrix.GetInverse().GetTranslation();
 
-    SetUniformFloat3(currentShader->first, "cameraPosition", cameraPos.coords[0], cameraPos.coords[1], cameraPos.coords[2]);
+    // resolved once, instead of once per light
+    const std::string &shaderName = currentShader->first;
+    int hasShadowHandle = GetUniformHandle(shaderName, "has_shadow");
+    int lightViewProjectionMatrixHandle = GetUniformHandle(shaderName, "lightViewProjectionMatrix");
+    int lightColorHandle = GetUniformHandle(shaderName, "lightColor");
+    int lightRadiusHandle = GetUniformHandle(shaderName, "lightRadius");
+    int lightPositionHandle = GetUniformHandle(shaderName, "lightPosition");
+    int projectionMatrixHandle = GetUniformHandle(shaderName, "projectionMatrix");
+    int viewMatrixHandle = GetUniformHandle(shaderName, "viewMatrix");
+    int modelMatrixHandle = GetUniformHandle(shaderName, "modelMatrix");
+
+    SetUniformFloat3(shaderName, "cameraPosition", cameraPos.coords[0], cameraPos.coords[1], cameraPos.coords[2]);
 
     std::deque<LightQueueEntry>::iterator lightIter = lightQueue.begin();
 
@@ -170,7 +193,7 @@ struct GLfunctions {
       // todo: add light types SetUniformInt("lighting", "lightType", (int)light.type);
 
       // bind shadow map
-      SetUniformInt(currentShader->first, "has_shadow", (int)light.hasShadow);
+      SetUniformInt(hasShadowHandle, (int)light.hasShadow);
       if (light.hasShadow) {
         SetTextureUnit(7);
         mapping.glBindTexture(GL_TEXTURE_2D, light.shadowMapTexture->GetResource()->GetID());
@@ -178,13 +201,13 @@ struct GLfunctions {
         Matrix4 toTexCoords(MATRIX4_IDENTITY);
         toTexCoords.SetTranslation(Vector3(0.5f, 0.5f, 0.5f));
         toTexCoords.SetScale(Vector3(0.5f, 0.5f, 0.5f));
-        SetUniformMatrix4(currentShader->first, "lightViewProjectionMatrix", toTexCoords * (*lightIter).lightProjectionMatrix * (*lightIter).lightViewMatrix);
+        SetUniformMatrix4(lightViewProjectionMatrixHandle, toTexCoords * (*lightIter).lightProjectionMatrix * (*lightIter).lightViewMatrix);
 
       }
 
-      SetUniformFloat3(currentShader->first, "lightColor", light.color.coords[0], light.color.coords[1], light.color.coords[2]);
-      SetUniformFloat(currentShader->first, "lightRadius", light.radius);
-      SetUniformFloat3(currentShader->first, "lightPosition", light.position.coords[0], light.position.coords[1], light.position.coords[2]);
+      SetUniformFloat3(lightColorHandle, light.color.coords[0], light.color.coords[1], light.color.coords[2]);
+      SetUniformFloat(lightRadiusHandle, light.radius);
+      SetUniformFloat3(lightPositionHandle, light.position.coords[0], light.position.coords[1], light.position.coords[2]);
 
       int quad_or_sphere = 1;
       if (light.type == 0) {
@@ -214,12 +237,12 @@ struct GLfunctions {
         SetDepthFunction(e_DepthFunction_Always);
 
         Matrix4 orthoMatrix = CreateOrthoMatrix(-1, 1, -1, 1, 0.0f, 1.0f);
-        SetMatrix("projectionMatrix", orthoMatrix);
+        SetUniformMatrix4(projectionMatrixHandle, orthoMatrix);
         Matrix4 xviewMatrix(MATRIX4_IDENTITY);
         xviewMatrix.SetTranslation(Vector3(0, 0, -0.5f));
-        SetMatrix("viewMatrix", xviewMatrix);
+        SetUniformMatrix4(viewMatrixHandle, xviewMatrix);
         Matrix4 modelMatrix(MATRIX4_IDENTITY);
-        SetMatrix("modelMatrix", modelMatrix);
+        SetUniformMatrix4(modelMatrixHandle, modelMatrix);
 
       mapping.glBindVertexArray(quadBuffer.vertexArrayID);
       mapping.glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -232,11 +255,11 @@ struct GLfunctions {
 
         AABB aabb = light.aabb;
 
-        SetMatrix("projectionMatrix", projectionMatrix);
-        SetMatrix("viewMatrix", viewMatrix);
+        SetUniformMatrix4(projectionMatrixHandle, projectionMatrix);
+        SetUniformMatrix4(viewMatrixHandle, viewMatrix);
         Matrix4 modelMatrix(MATRIX4_IDENTITY);
         modelMatrix.SetTranslation(light.position);
-        SetMatrix("modelMatrix", modelMatrix);
+        SetUniformMatrix4(modelMatrixHandle, modelMatrix);
         drawSphere(aabb.GetRadius() * 0.52f, 6, 6);
       }
 
@@ -919,6 +942,8 @@ struct GLfunctions {
           VAOReadIndex.insert(std::pair<int, int>(firstArray_id, 0));
           VBOPingPongMap.insert(std::pair<int, int>(firstBuffer_id, buffer_id));
           VAOPingPongMap.insert(std::pair<int, int>(firstArray_id, vertexArrayID));
+          if ((signed int)VAOReadIDs.size() <= firstArray_id) VAOReadIDs.resize(firstArray_id + 1, 0);
+          VAOReadIDs[firstArray_id] = firstArray_id;
         }
       }
 
@@ -949,6 +974,11 @@ struct GLfunctions {
 
         pingPongIter->second++;
         if (pingPongIter->second == 2) pingPongIter->second = 0;
+
+        std::map<int, int>::iterator pingPongVAOIter = VAOPingPongMap.find(vertexBufferID.vertexArrayID);
+        if (pingPongVAOIter != VAOPingPongMap.end()) {
+          VAOReadIDs[vertexBufferID.vertexArrayID] = pingPongIter->second == 1 ? pingPongVAOIter->second : vertexBufferID.vertexArrayID;
+        }
       }
 
       if (pingPongReadSwitch == 0) {
@@ -1038,6 +1068,8 @@ struct GLfunctions {
       VAOReadIndex.erase(pingPongIter);
     }
 
+    if (vertexBufferID.vertexArrayID < VAOReadIDs.size()) VAOReadIDs[vertexBufferID.vertexArrayID] = 0;
+
 /*fenceoff
     // delete sync object
     std::map<int, GLsync>::iterator syncIter = VAOfence.find(vertexBufferID.vertexArrayID);
@@ -1048,12 +1080,15 @@ struct GLfunctions {
 */
   }
 
-  void DrawBufferChunk(int startIndex, int count) {
+  // returns the number of draw calls made
+  int DrawBufferChunk(int startIndex, int count) {
     // draw buffer
     if (count > 0) {
       #define BUFFER_OFFSET( i ) ((char *)NULL + (i))
       mapping.glDrawRangeElements(GL_TRIANGLES, startIndex, startIndex + count, count, GL_UNSIGNED_INT, BUFFER_OFFSET(startIndex * sizeof(unsigned int)));
+      return 1;
     }
+    return 0;
   }
 
   void OpenGLRenderer3D::RenderVertexBuffer(const std::deque<VertexBufferQueueEntry> &vertexBufferQueue, e_RenderMode renderMode) {
@@ -1094,6 +1129,15 @@ struct GLfunctions {
 
    	Matrix4 transform;
 
+    // resolved once per queue instead of per entry. the material is only set in the geometry phase, which uses 'simple'
+    int modelMatrixHandle = GetUniformHandle(currentShader->first, "modelMatrix");
+    int materialParamsHandle = -1;
+    int materialBoolsHandle = -1;
+    if (renderMode == e_RenderMode_Full) {
+      materialParamsHandle = GetUniformHandle("simple", "materialparams");
+      materialBoolsHandle = GetUniformHandle("simple", "materialbools");
+    }
+
     std::deque<VertexBufferQueueEntry>::const_iterator vertexBufferQueueIter = vertexBufferQueue.begin();
     while (vertexBufferQueueIter != vertexBufferQueue.end()) {
       const VertexBufferQueueEntry *queueEntry = &(*vertexBufferQueueIter);
@@ -1102,19 +1146,9 @@ struct GLfunctions {
       if (currentBoundBuffer != vertexBuffer->GetVaoID()) {
         bufferSwitches++;
 
+        // ping-ponged buffers draw from whichever of the pair was written last
         int vaoID = vertexBuffer->GetVaoID();
-        int pingPongReadSwitch = 0;
-        std::map<int, int>::iterator pingPongIter = VAOReadIndex.find(vaoID);
-        if (pingPongIter != VAOReadIndex.end()) {
-          pingPongReadSwitch = pingPongIter->second;
-        }
-
-        if (pingPongReadSwitch == 1) {
-          std::map<int, int>::iterator pingPongIter = VAOPingPongMap.find(vaoID);
-          if (pingPongIter != VAOPingPongMap.end()) {
-            vaoID = pingPongIter->second;
-          }
-        }
+        if (vaoID < (signed int)VAOReadIDs.size() && VAOReadIDs[vaoID] != 0) vaoID = VAOReadIDs[vaoID];
 
 /*
         // block on VAO update
@@ -1134,6 +1168,7 @@ struct GLfunctions {
 
         currentBoundBuffer = vaoID;
         mapping.glBindVertexArray(vaoID);
+        vertexArrayBindCount++;
         //glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vertexBuffer->GetElementID());
 /*
         if (renderMode != e_RenderMode_GeometryOnly) {
@@ -1150,7 +1185,7 @@ struct GLfunctions {
       transform.Construct(queueEntry->position, Vector3(1, 1, 1), queueEntry->rotation);
       //transform.Transpose();
       //glMultMatrixf((float*)transform.elements);
-      SetMatrix("modelMatrix", transform);
+      SetUniformMatrix4(modelMatrixHandle, transform);
 
       bool sequential = true; // buffer vertexbuffer chunks until a change happens (in texture or index, for example)
       struct BufferChunk {
@@ -1196,7 +1231,7 @@ struct GLfunctions {
               illuminationTextureID != currentIlluminationTextureID) {
 
             if (sequential) {
-              DrawBufferChunk(bufferChunk.startIndex, bufferChunk.count);
+              drawCallCount += DrawBufferChunk(bufferChunk.startIndex, bufferChunk.count);
               sequential = false;
             }
 
@@ -1211,31 +1246,37 @@ struct GLfunctions {
               if (has_normal && normalTextureID != currentNormalTextureID) {
                 SetTextureUnit(1);
                 mapping.glBindTexture(GL_TEXTURE_2D, normalTextureID);
+                textureBindCount++;
               }
               if (has_specular && specularTextureID != currentSpecularTextureID) {
                 SetTextureUnit(2);
                 mapping.glBindTexture(GL_TEXTURE_2D, specularTextureID);
+                textureBindCount++;
               }
               if (has_illumination && illuminationTextureID != currentIlluminationTextureID) {
                 SetTextureUnit(3);
                 mapping.glBindTexture(GL_TEXTURE_2D, illuminationTextureID);
+                textureBindCount++;
               }
             }
 
-            SetTextureUnit(0);
-            mapping.glBindTexture(GL_TEXTURE_2D, diffuseTextureID);
+            if (diffuseTextureID != currentDiffuseTextureID) {
+              SetTextureUnit(0);
+              mapping.glBindTexture(GL_TEXTURE_2D, diffuseTextureID);
+              textureBindCount++;
+            }
 
             if (renderMode == e_RenderMode_Full) {
               //SetUniformFloat("simple", "shininess", vbIndex->material.shininess * 60 + 1);
               //SetUniformFloat("simple", "specular", vbIndex->material.specular_amount);
               //SetUniformFloat("simple", "self_illumination", vbIndex->material.self_illumination.coords[0]);
               //SetUniformFloat3("simple", "materialparams", vbIndex->material.shininess * 60 + 1, vbIndex->material.specular_amount, vbIndex->material.self_illumination.coords[0]);
-              SetUniformFloat3("simple", "materialparams", vbIndex->material.shininess, vbIndex->material.specular_amount, vbIndex->material.self_illumination.coords[0]);
+              SetUniformFloat3(materialParamsHandle, vbIndex->material.shininess, vbIndex->material.specular_amount, vbIndex->material.self_illumination.coords[0]);
 
               //SetUniformInt("simple", "has_normal", (int)has_normal);
               //SetUniformInt("simple", "has_specular", (int)has_specular);
               //SetUniformInt("simple", "has_illumination", (int)has_illumination);
-              SetUniformFloat3("simple", "materialbools", (int)has_normal, (int)has_specular, (int)has_illumination);
+              SetUniformFloat3(materialBoolsHandle, (int)has_normal, (int)has_specular, (int)has_illumination);
             }
 
             currentDiffuseTextureID = diffuseTextureID;
@@ -1251,7 +1292,7 @@ struct GLfunctions {
         //if (currentShader->first.compare("zphase") == 0) printf("drawing %i elements in zphase mode\n", count);
 
         if (sequential) if (bufferChunk.startIndex + bufferChunk.count != start) {
-          DrawBufferChunk(bufferChunk.startIndex, bufferChunk.count);
+          drawCallCount += DrawBufferChunk(bufferChunk.startIndex, bufferChunk.count);
           sequential = false;
         }
 
@@ -1269,7 +1310,7 @@ struct GLfunctions {
         vertexBufferIter++;
 
         if (sequential) if (vertexBufferIter == queueEntry->vertexBufferIndices.end()) {
-          DrawBufferChunk(bufferChunk.startIndex, bufferChunk.count);
+          drawCallCount += DrawBufferChunk(bufferChunk.startIndex, bufferChunk.count);
           sequential = false;
         }
 
@@ -2087,116 +2128,97 @@ struct GLfunctions {
   }
 
   void OpenGLRenderer3D::SetUniformInt(const std::string &shaderName, const std::string &varName, int value) {
-    std::map<std::string, Shader>::iterator shaderIter = shaders.find(shaderName);
-    assert(shaderIter != shaders.end());
-
-    std::map<std::string, GLint>::iterator iter = uniformCache.find(shaderName + "_var_" + varName);
-    GLint location;
-    if (iter != uniformCache.end()) {
-      location = iter->second;
-    } else {
-      location = mapping.glGetUniformLocation((*shaderIter).second.programID, varName.c_str());
-      if (location == -1) Log(e_Error, "OpenGLRenderer3D", "SetUniformInt", "Uniform location for shader '" + shaderName + "' not found: " + varName);
-      uniformCache.insert(std::pair<std::string, GLint>(shaderName + "_var_" + varName, location));
-    }
-    mapping.glUniform1i(location, value);
+    uniformSetByNameCount++;
+    SetUniformInt(GetUniformHandle(shaderName, varName), value);
   }
 
   void OpenGLRenderer3D::SetUniformInt3(const std::string &shaderName, const std::string &varName, int value1, int value2, int value3) {
-    std::map<std::string, Shader>::iterator shaderIter = shaders.find(shaderName);
-    assert(shaderIter != shaders.end());
-
-    std::map<std::string, GLint>::iterator iter = uniformCache.find(shaderName + "_var_" + varName);
-    GLint location;
-    if (iter != uniformCache.end()) {
-      location = iter->second;
-    } else {
-      location = mapping.glGetUniformLocation((*shaderIter).second.programID, varName.c_str());
-      if (location == -1) Log(e_Error, "OpenGLRenderer3D", "SetUniformInt3", "Uniform location for shader '" + shaderName + "' not found: " + varName);
-      uniformCache.insert(std::pair<std::string, GLint>(shaderName + "_var_" + varName, location));
-    }
-    mapping.glUniform3i(location, value1, value2, value3);
+    uniformSetByNameCount++;
+    int uniformHandle = GetUniformHandle(shaderName, varName);
+    if (uniformHandle < 0) return;
+    uniformSetCount++;
+    mapping.glUniform3i(uniformLocations[uniformHandle], value1, value2, value3);
   }
 
   void OpenGLRenderer3D::SetUniformFloat(const std::string &shaderName, const std::string &varName, float value) {
-    std::map<std::string, Shader>::iterator shaderIter = shaders.find(shaderName);
-    assert(shaderIter != shaders.end());
-
-    std::map<std::string, GLint>::iterator iter = uniformCache.find(shaderName + "_var_" + varName);
-    GLint location;
-    if (iter != uniformCache.end()) {
-      location = iter->second;
-    } else {
-      location = mapping.glGetUniformLocation((*shaderIter).second.programID, varName.c_str());
-      if (location == -1) Log(e_Error, "OpenGLRenderer3D", "SetUniformFloat", "Uniform location for shader '" + shaderName + "' not found: " + varName);
-      uniformCache.insert(std::pair<std::string, GLint>(shaderName + "_var_" + varName, location));
-    }
-    mapping.glUniform1f(location, value);
+    uniformSetByNameCount++;
+    SetUniformFloat(GetUniformHandle(shaderName, varName), value);
   }
 
   void OpenGLRenderer3D::SetUniformFloat2(const std::string &shaderName, const std::string &varName, float value1, float value2) {
-    std::map<std::string, Shader>::iterator shaderIter = shaders.find(shaderName);
-    assert(shaderIter != shaders.end());
-
-    std::map<std::string, GLint>::iterator iter = uniformCache.find(shaderName + "_var_" + varName);
-    GLint location;
-    if (iter != uniformCache.end()) {
-      location = iter->second;
-    } else {
-      location = mapping.glGetUniformLocation((*shaderIter).second.programID, varName.c_str());
-      if (location == -1) Log(e_Error, "OpenGLRenderer3D", "SetUniformFloat2", "Uniform location for shader '" + shaderName + "' not found: " + varName);
-      uniformCache.insert(std::pair<std::string, GLint>(shaderName + "_var_" + varName, location));
-    }
-    mapping.glUniform2f(location, value1, value2);
+    uniformSetByNameCount++;
+    SetUniformFloat2(GetUniformHandle(shaderName, varName), value1, value2);
   }
 
   void OpenGLRenderer3D::SetUniformFloat3(const std::string &shaderName, const std::string &varName, float value1, float value2, float value3) {
-    std::map<std::string, Shader>::iterator shaderIter = shaders.find(shaderName);
-    assert(shaderIter != shaders.end());
-
-    std::map<std::string, GLint>::iterator iter = uniformCache.find(shaderName + "_var_" + varName);
-    GLint location;
-    if (iter != uniformCache.end()) {
-      location = iter->second;
-    } else {
-      location = mapping.glGetUniformLocation((*shaderIter).second.programID, varName.c_str());
-      if (location == -1) Log(e_Error, "OpenGLRenderer3D", "SetUniformFloat3", "Uniform location for shader '" + shaderName + "' not found: " + varName);
-      uniformCache.insert(std::pair<std::string, GLint>(shaderName + "_var_" + varName, location));
-    }
-    mapping.glUniform3f(location, value1, value2, value3);
+    uniformSetByNameCount++;
+    SetUniformFloat3(GetUniformHandle(shaderName, varName), value1, value2, value3);
   }
 
   void OpenGLRenderer3D::SetUniformFloat3Array(const std::string &shaderName, const std::string &varName, int count, float *values) {
-    std::map<std::string, Shader>::iterator shaderIter = shaders.find(shaderName);
-    assert(shaderIter != shaders.end());
-
-    std::map<std::string, GLint>::iterator iter = uniformCache.find(shaderName + "_var_" + varName);
-    GLint location;
-    if (iter != uniformCache.end()) {
-      location = iter->second;
-    } else {
-      location = mapping.glGetUniformLocation((*shaderIter).second.programID, varName.c_str());
-      if (location == -1) Log(e_Error, "OpenGLRenderer3D", "SetUniformFloat3Array", "Uniform location for shader '" + shaderName + "' not found: " + varName);
-      uniformCache.insert(std::pair<std::string, GLint>(shaderName + "_var_" + varName, location));
-    }
-    mapping.glUniform3fv(location, count, values);
+    uniformSetByNameCount++;
+    SetUniformFloat3Array(GetUniformHandle(shaderName, varName), count, values);
   }
 
   void OpenGLRenderer3D::SetUniformMatrix4(const std::string &shaderName, const std::string &varName, const Matrix4 &mat) {
+    uniformSetByNameCount++;
+    SetUniformMatrix4(GetUniformHandle(shaderName, varName), mat);
+  }
+
+  int OpenGLRenderer3D::GetUniformHandle(const std::string &shaderName, const std::string &varName) {
     std::map<std::string, Shader>::iterator shaderIter = shaders.find(shaderName);
     assert(shaderIter != shaders.end());
+    if (shaderIter == shaders.end()) return -1;
 
-    std::map<std::string, GLint>::iterator iter = uniformCache.find(shaderName + "_var_" + varName);
-    GLint location;
-    if (iter != uniformCache.end()) {
-      location = iter->second;
-    } else {
-      location = mapping.glGetUniformLocation((*shaderIter).second.programID, varName.c_str());
-      if (location == -1) Log(e_Error, "OpenGLRenderer3D", "SetUniformMatrix4", "Uniform location for shader '" + shaderName + "' not found: " + varName);
-      uniformCache.insert(std::pair<std::string, GLint>(shaderName + "_var_" + varName, location));
-    }
-    //mapping.glUniformMatrix4fv(location, 1, false, (float*)mat.GetTransposed().elements);
-    mapping.glUniformMatrix4fv(location, 1, true, (float*)mat.elements); // true == transposed
+    std::map<std::string, int> &uniformHandles = shaderIter->second.uniformHandles;
+    std::map<std::string, int>::iterator iter = uniformHandles.find(varName);
+    if (iter != uniformHandles.end()) return iter->second;
+
+    // a uniform that isn't there resolves to location -1 all the same, which gl ignores
+    GLint location = mapping.glGetUniformLocation(shaderIter->second.programID, varName.c_str());
+    if (location == -1) Log(e_Error, "OpenGLRenderer3D", "GetUniformHandle", "Uniform location for shader '" + shaderName + "' not found: " + varName);
+    int uniformHandle = uniformLocations.size();
+    uniformLocations.push_back(location);
+    uniformHandles.insert(std::pair<std::string, int>(varName, uniformHandle));
+    uniformNameAllocationCount++;
+    return uniformHandle;
+  }
+
+  void OpenGLRenderer3D::SetUniformInt(int uniformHandle, int value) {
+    if (uniformHandle < 0) return;
+    uniformSetCount++;
+    mapping.glUniform1i(uniformLocations[uniformHandle], value);
+  }
+
+  void OpenGLRenderer3D::SetUniformFloat(int uniformHandle, float value) {
+    if (uniformHandle < 0) return;
+    uniformSetCount++;
+    mapping.glUniform1f(uniformLocations[uniformHandle], value);
+  }
+
+  void OpenGLRenderer3D::SetUniformFloat2(int uniformHandle, float value1, float value2) {
+    if (uniformHandle < 0) return;
+    uniformSetCount++;
+    mapping.glUniform2f(uniformLocations[uniformHandle], value1, value2);
+  }
+
+  void OpenGLRenderer3D::SetUniformFloat3(int uniformHandle, float value1, float value2, float value3) {
+    if (uniformHandle < 0) return;
+    uniformSetCount++;
+    mapping.glUniform3f(uniformLocations[uniformHandle], value1, value2, value3);
+  }
+
+  void OpenGLRenderer3D::SetUniformFloat3Array(int uniformHandle, int count, float *values) {
+    if (uniformHandle < 0) return;
+    uniformSetCount++;
+    mapping.glUniform3fv(uniformLocations[uniformHandle], count, values);
+  }
+
+  void OpenGLRenderer3D::SetUniformMatrix4(int uniformHandle, const Matrix4 &mat) {
+    if (uniformHandle < 0) return;
+    uniformSetCount++;
+    //mapping.glUniformMatrix4fv(uniformLocations[uniformHandle], 1, false, (float*)mat.GetTransposed().elements);
+    mapping.glUniformMatrix4fv(uniformLocations[uniformHandle], 1, true, (float*)mat.elements); // true == transposed
   }
 
   void OpenGLRenderer3D::HDRCaptureOverallBrightness() {
@@ -2229,6 +2251,7 @@ struct GLfunctions {
 
   void OpenGLRenderer3D::operator()() {
     Log(e_Notice, "OpenGLRenderer3D", "operator()()", "Starting OpenGLRenderer3D thread");
+    PROFILE_THREAD_NAME("OpenGLRenderer3D");
 
     if ((SDL_WasInit(SDL_INIT_VIDEO) & SDL_INIT_VIDEO) == 0) {
       SDL_Init(SDL_INIT_VIDEO);
@@ -2293,6 +2316,7 @@ struct GLfunctions {
       bool isMessage;
       boost::intrusive_ptr<Command> message = messageQueue.WaitForMessage(isMessage, 1);
       if (isMessage) {
+        PROFILE_ZONE(message->GetProfileName());
         if (!message->Handle(this)) quit = true;
         message.reset();
       }
@@ -2301,6 +2325,17 @@ struct GLfunctions {
 
     Exit();
 
+    if (frameCount > 0) {
+      char uniformStats[256];
+      sprintf(uniformStats, "%lu frames; per frame: %.1f uniform sets, %.1f of them by name, %.2f uniform names allocated (%lu uniforms resolved in total)",
+              frameCount, uniformSetCount / (float)frameCount, uniformSetByNameCount / (float)frameCount, uniformNameAllocationCount / (float)frameCount, (unsigned long)uniformLocations.size());
+      Log(e_Notice, "OpenGLRenderer3D", "operator()()", uniformStats);
+      char bindStats[256];
+      sprintf(bindStats, "per frame, drawing vertex buffers: %.1f draw calls, %.1f vertex array binds, %.1f texture binds",
+              drawCallCount / (float)frameCount, vertexArrayBindCount / (float)frameCount, textureBindCount / (float)frameCount);
+      Log(e_Notice, "OpenGLRenderer3D", "operator()()", bindStats);
+    }
+
     // IMG_Quit handled on main thread if needed
     // Do not uninitialize video here to avoid tearing down main-thread init on macOS
 
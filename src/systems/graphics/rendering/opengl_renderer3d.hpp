@@ -125,6 +125,14 @@ namespace blunted {
       virtual void SetUniformFloat3Array(const std::string &shaderName, const std::string &varName, int count, float *values);
       virtual void SetUniformMatrix4(const std::string &shaderName, const std::string &varName, const Matrix4 &mat);
 
+      virtual int GetUniformHandle(const std::string &shaderName, const std::string &varName);
+      virtual void SetUniformInt(int uniformHandle, int value);
+      virtual void SetUniformFloat(int uniformHandle, float value);
+      virtual void SetUniformFloat2(int uniformHandle, float value1, float value2);
+      virtual void SetUniformFloat3(int uniformHandle, float value1, float value2, float value3);
+      virtual void SetUniformFloat3Array(int uniformHandle, int count, float *values);
+      virtual void SetUniformMatrix4(int uniformHandle, const Matrix4 &mat);
+
       virtual void HDRCaptureOverallBrightness();
       virtual float HDRGetOverallBrightness();
 
@@ -148,11 +156,21 @@ namespace blunted {
       float largest_supported_anisotropy;
       void SetMaxAnisotropy();
 
-      std::map<std::string, int> uniformCache;
+      std::vector<int> uniformLocations; // by uniform handle
+
+      // per frame averages get logged on exit
+      unsigned long frameCount;
+      unsigned long uniformSetCount;
+      unsigned long uniformSetByNameCount; // the ones that had to look up their handle first
+      unsigned long uniformNameAllocationCount; // names copied into the handle maps, once per uniform
+      unsigned long drawCallCount; // these three only in RenderVertexBuffer
+      unsigned long vertexArrayBindCount;
+      unsigned long textureBindCount;
 
       std::map<int, int> VBOPingPongMap;
       std::map<int, int> VAOPingPongMap;
       std::map<int, int> VAOReadIndex;
+      std::vector<int> VAOReadIDs; // by vertex array id: the one of a ping-ponged pair to draw from, 0 if not ping-ponged
       //std::map<int, GLsync> VAOfence;
 
       signed int _cache_activeTextureUnit;
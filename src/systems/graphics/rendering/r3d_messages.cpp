@@ -8,10 +8,6 @@
 
 namespace blunted {
 
-  bool R3DM_SortVertexBufferQueueEntries(const VertexBufferQueueEntry &vb1, const VertexBufferQueueEntry &vb2) {
-    return vb1.vertexBuffer->GetResource()->GetID() < vb2.vertexBuffer->GetResource()->GetID();
-  }
-
   bool Renderer3DMessage_RenderView::Execute(void *caller) {
 
     Renderer3D *renderer = static_cast<Renderer3D*>(caller);
@@ -24,10 +20,8 @@ namespace blunted {
     Matrix4 viewMatrix = buffer.cameraMatrix;
 
 
-    // not sorting actually seems to be fastest atm. (the sorting being slower than the performance win by reducing state changes)
-    //std::sort(buffer.visibleGeometry.begin(), buffer.visibleGeometry.end(), R3DM_SortVertexBufferQueueEntries);
-    //printf("%i entries\n", buffer.visibleGeometry.size());
-    //buffer.visibleGeometry.sort(SortVertexBufferQueueEntries);
+    // visibleGeometry has been sorted already, on the worker thread that enqueued it (see SortRenderQueue). sorting it
+    // here used to cost more than the state changes it saved
 
     int width;
     int height;
@@ -292,14 +286,7 @@ namespace blunted {
   bool Renderer3DMessage_RenderShadowMap::Execute(void *caller) {
     Renderer3D *renderer = static_cast<Renderer3D*>(caller);
 
-    // SORTING update: because we pass a const reference, we need to sort vertexbuffers in graphics_light (or wherever we invoke this)
-
-    // disabled because it's slower to sort (vector) than to switch vertexbuffers
-    //std::sort(map.visibleGeometry.begin(), map.visibleGeometry.end(), R3DM_SortVertexBufferQueueEntries);
-    //std::sort(map.visibleGeometry.begin(), map.visibleGeometry.end(), SortVertexBufferQueueEntries);
-
-    // sorting a list however might be ok. needs to be tested in a situation with lots of different id's
-    //map.visibleGeometry.sort(R3DM_SortVertexBufferQueueEntries);
+    // map.visibleGeometry is sorted in graphics_light, on the worker thread that enqueued it
 
     renderer->UseShader("zphase");
 
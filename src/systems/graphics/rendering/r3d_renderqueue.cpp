@@ -0,0 +1,98 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#include "r3d_renderqueue.hpp"
+
+#include "../resources/texture.hpp"
+#include "../resources/vertexbuffer.hpp"
+
+#include <cstring>
+
+namespace blunted {
+
+  unsigned long long GetRenderQueueKey(const VertexBufferQueueEntry &entry, const Vector3 &eye) {
+
+    // the first material is the one that decides whether the textures need binding when moving on to this entry
+    unsigned long long diffuseTextureID = 0;
+    unsigned long long normalTextureID = 0;
+    if (!entry.vertexBufferIndices.empty()) {
+      const Renderer3DMaterial &material = entry.vertexBufferIndices.front().material;
+      if (material.diffuseTexture) diffuseTextureID = material.diffuseTexture->GetResource()->GetID();
+      if (material.normalTexture) normalTextureID = material.normalTexture->GetResource()->GetID();
+    }
+    unsigned long long vaoID = entry.vertexBuffer->GetResource()->GetVaoID();
+
+    // positive floats sort the same as their bits do, so the top 24 bits of the squared distance will do
+    float distance = (entry.position - eye).GetLength();
+    distance *= distance;
+    unsigned int distanceBits;
+    memcpy(&distanceBits, &distance, sizeof(float));
+
+    return ((diffuseTextureID & 0xfff) << 52) |
+           ((normalTextureID & 0xfff) << 40) |
+           ((vaoID & 0xffff) << 24) |
+           (distanceBits >> 8);
+  }
+
+  void RadixSortRenderQueue(std::vector<RenderQueueItem> &items, std::vector<RenderQueueItem> &scratch) {
+    unsigned int count = items.size();
+    if (count < 2) return;
+    scratch.resize(count);
+
+    // all 8 histograms in one go
+    unsigned int histograms[8][256];
+    memset(histograms, 0, sizeof(histograms));
+    for (unsigned int i = 0; i < count; i++) {
+      unsigned long long key = items[i].key;
+      for (int pass = 0; pass < 8; pass++) {
+        histograms[pass][(key >> (pass * 8)) & 0xff]++;
+      }
+    }
+
+    std::vector<RenderQueueItem> *source = &items;
+    std::vector<RenderQueueItem> *target = &scratch;
+    for (int pass = 0; pass < 8; pass++) {
+      unsigned int *histogram = histograms[pass];
+      int shift = pass * 8;
+
+      // all keys have the same byte here, nothing to do
+      if (histogram[((*source)[0].key >> shift) & 0xff] == count) continue;
+
+      unsigned int offset = 0;
+      for (int bucket = 0; bucket < 256; bucket++) {
+        unsigned int bucketSize = histogram[bucket];
+        histogram[bucket] = offset;
+        offset += bucketSize;
+      }
+
+      for (unsigned int i = 0; i < count; i++) {
+        const RenderQueueItem &item = (*source)[i];
+        (*target)[histogram[(item.key >> shift) & 0xff]++] = item;
+      }
+      std::swap(source, target);
+    }
+
+    if (source != &items) items.swap(scratch);
+  }
+
+  void SortRenderQueue(std::deque<VertexBufferQueueEntry> &queue, const Vector3 &eye) {
+    if (queue.size() < 2) return;
+
+    std::vector<RenderQueueItem> items(queue.size());
+    for (unsigned int i = 0; i < queue.size(); i++) {
+      items[i].key = GetRenderQueueKey(queue[i], eye);
+      items[i].index = i;
+    }
+
+    std::vector<RenderQueueItem> scratch;
+    RadixSortRenderQueue(items, scratch);
+
+    std::deque<VertexBufferQueueEntry> sortedQueue;
+    for (unsigned int i = 0; i < items.size(); i++) {
+      sortedQueue.push_back(std::move(queue[items[i].index]));
+    }
+    queue.swap(sortedQueue);
+  }
+
+}
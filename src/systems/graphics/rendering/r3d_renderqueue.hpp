@@ -0,0 +1,32 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_RENDERER3D_RENDERQUEUE
+#define _HPP_RENDERER3D_RENDERQUEUE
+
+#include "interface_renderer3d.hpp"
+
+namespace blunted {
+
+  // orders a vertex buffer queue so RenderVertexBuffer has to change as little state as possible. meant to be called on the
+  // worker thread that filled the queue, so the render thread only has to walk it
+
+  struct RenderQueueItem {
+    unsigned long long key;
+    unsigned int index;
+  };
+
+  /// from high to low bits: diffuse texture (12), normal texture (12), vertex array (16), distance to eye (24). all queues
+  /// are drawn with one shader per RenderVertexBuffer call, so there's no shader field. ids that don't fit only cost grouping
+  unsigned long long GetRenderQueueKey(const VertexBufferQueueEntry &entry, const Vector3 &eye);
+
+  /// lsd radix sort on the keys, 8 bits a pass; passes over bytes that are the same for all keys are skipped. stable
+  void RadixSortRenderQueue(std::vector<RenderQueueItem> &items, std::vector<RenderQueueItem> &scratch);
+
+  /// sorts the queue by GetRenderQueueKey, nearest first within the same state
+  void SortRenderQueue(std::deque<VertexBufferQueueEntry> &queue, const Vector3 &eye);
+
+}
+
+#endif
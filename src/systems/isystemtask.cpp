@@ -9,24 +9,24 @@
 
 namespace blunted {
 
-  bool SystemTaskMessage_GetPhase::Execute(void *caller) {
-    task->GetPhase();
+  void ISystemTaskMessage::OnReady() {
+    // only now, with the message marked as handled: the scheduler could otherwise wake, find it not ready yet, and go back to sleep
     boost::mutex::scoped_lock lock(GetScheduler()->somethingIsDoneMutex);
     GetScheduler()->somethingIsDone.notify_one();
+  }
+
+  bool SystemTaskMessage_GetPhase::Execute(void *caller) {
+    task->GetPhase();
     return true;
   }
 
   bool SystemTaskMessage_ProcessPhase::Execute(void *caller) {
     task->ProcessPhase();
-    boost::mutex::scoped_lock lock(GetScheduler()->somethingIsDoneMutex);
-    GetScheduler()->somethingIsDone.notify_one();
     return true;
   }
 
   bool SystemTaskMessage_PutPhase::Execute(void *caller) {
     task->PutPhase();
-    boost::mutex::scoped_lock lock(GetScheduler()->somethingIsDoneMutex);
-    GetScheduler()->somethingIsDone.notify_one();
     return true;
   }
 
@@ -43,6 +43,8 @@ namespace blunted {
       }
 
     protected:
+      virtual void OnReady();
+
       ISystemTask *task;
 
   };
@@ -4,9 +4,11 @@
 
 #include "command.hpp"
 
+#include "base/profiler.hpp"
+
 namespace blunted {
 
-  Command::Command(const std::string &name) : handled(false) {
+  Command::Command(const std::string &name) : handled(false), unfinishedCount(1), profileName(PROFILE_NAME(name)) {
     this->name.SetData(name);
   }
 
@@ -21,25 +23,43 @@ namespace blunted {
   void Command::Reset() {
     boost::mutex::scoped_lock lock(mutex);
     handled = false;
+    unfinishedCount = 1;
   }
 
   bool Command::Handle(void *caller) {
     bool result = Execute(caller);
-
-    boost::mutex::scoped_lock lock(mutex);
-    handled = true;
-    //lock.unlock(); // http://www.justsoftwaresolutions.co.uk/threading/implementing-a-thread-safe-queue-using-condition-variables.html
-    // edit: disabled, just to be sure no obscure bugs occur.
-    processed.notify_one();
-
+    Finish();
     return result;
   }
 
   void Command::Wait() {
     boost::mutex::scoped_lock lock(mutex);
-    if (!handled) {
+    while (!handled) {
       processed.wait(lock);
     }
   }
 
+  void Command::AddChild(boost::intrusive_ptr<Command> child) {
+    assert(!child->parent);
+    unfinishedCount++;
+    child->parent = this;
+  }
+
+  void Command::Finish() {
+    // whoever finishes last (this one or one of the children) marks us as handled, and passes it on to our own parent
+    if (unfinishedCount.fetch_sub(1) != 1) return;
+
+    boost::intrusive_ptr<Command> finishedParent;
+    finishedParent.swap(parent);
+
+    boost::mutex::scoped_lock lock(mutex);
+    handled = true;
+    processed.notify_all();
+    lock.unlock();
+
+    OnReady();
+
+    if (finishedParent) finishedParent->Finish();
+  }
+
 }
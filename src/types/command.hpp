@@ -10,6 +10,8 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/condition.hpp>
 
+#include <atomic>
+
 #include "types/refcounted.hpp"
 #include "types/lockable.hpp"
 
@@ -26,16 +28,30 @@ namespace blunted {
       bool Handle(void *caller = NULL);
       void Wait();
 
+      /// child commands: this command only becomes ready once it has been handled itself and all its children have been, too.
+      /// add them before this command is handled (and before the child is enqueued)
+      void AddChild(boost::intrusive_ptr<Command> child);
+
       std::string GetName() const { return name.GetData(); }
+      /// the name, interned for PROFILE_ZONE when it was constructed (0 without ENABLE_PROFILER)
+      const char *GetProfileName() const { return profileName; }
 
     protected:
       virtual bool Execute(void *caller = NULL) = 0;
 
+      void Finish();
+      /// called once this command has become ready, by whichever thread finished it (or its last child). IsReady() is true by then
+      virtual void OnReady() {}
+
       boost::mutex mutex; // locks 'handled & processed'
       bool handled;
       boost::condition processed;
 
+      std::atomic<int> unfinishedCount; // this command + unfinished children
+      boost::intrusive_ptr<Command> parent;
+
       Lockable<std::string> name;
+      const char *profileName;
 
   };
 }
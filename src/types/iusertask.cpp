@@ -9,24 +9,24 @@
 
 namespace blunted {
 
-  bool UserTaskMessage_GetPhase::Execute(void *caller) {
-    task->GetPhase();
+  void IUserTaskMessage::OnReady() {
+    // same as ISystemTaskMessage::OnReady
     boost::mutex::scoped_lock lock(GetScheduler()->somethingIsDoneMutex);
     GetScheduler()->somethingIsDone.notify_one();
+  }
+
+  bool UserTaskMessage_GetPhase::Execute(void *caller) {
+    task->GetPhase();
     return true;
   }
 
   bool UserTaskMessage_ProcessPhase::Execute(void *caller) {
     task->ProcessPhase();
-    boost::mutex::scoped_lock lock(GetScheduler()->somethingIsDoneMutex);
-    GetScheduler()->somethingIsDone.notify_one();
     return true;
   }
 
   bool UserTaskMessage_PutPhase::Execute(void *caller) {
     task->PutPhase();
-    boost::mutex::scoped_lock lock(GetScheduler()->somethingIsDoneMutex);
-    GetScheduler()->somethingIsDone.notify_one();
     return true;
   }
 
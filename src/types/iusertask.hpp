@@ -33,6 +33,8 @@ namespace blunted {
       IUserTaskMessage(const std::string &name, boost::shared_ptr<IUserTask> task) : Command(name), task(task) {};
 
     protected:
+      virtual void OnReady();
+
       boost::shared_ptr<IUserTask> task;
 
   };
@@ -20,37 +20,22 @@ namespace blunted {
   }
 
   unsigned long RefCounted::GetRefCount() {
-    int i = refCount;
-    return i;
+    return refCount.load(std::memory_order_relaxed);
   }
 
   void intrusive_ptr_add_ref(RefCounted *p) {
     assert(p);
-#ifdef WIN32
-    InterlockedIncrement(&(p->refCount));
-#else
-    p->refCountMutex.lock();
-    ++(p->refCount);
-    p->refCountMutex.unlock();
-#endif
-
+    // increments need no ordering: nobody can be deleting an object we are taking a reference to
+    p->refCount.fetch_add(1, std::memory_order_relaxed);
   }
 
   void intrusive_ptr_release(RefCounted *p) {
     assert(p);
-
-#ifdef WIN32
-    if (InterlockedDecrement(&(p->refCount)) == 0) delete p;
-#else
-    p->refCountMutex.lock();
-    if (--(p->refCount) == 0) {
-      p->refCountMutex.unlock();
+    // release: our writes to *p happen before the delete. acquire (on the last one): the delete sees everyone else's writes
+    if (p->refCount.fetch_sub(1, std::memory_order_release) == 1) {
+      std::atomic_thread_fence(std::memory_order_acquire);
       delete p;
-    } else {
-      p->refCountMutex.unlock();
     }
-#endif
-
   }
 
 }
@@ -6,7 +6,9 @@
 
 namespace blunted {
 
-  Spatial::Spatial(const std::string &name) : name(name), parent(0), localMode(e_LocalMode_Relative) {
+  std::atomic<unsigned long> Spatial::derivedTransformUpdateCount(0);
+
+  Spatial::Spatial(const std::string &name) : name(name), parent(0), localMode(e_LocalMode_Relative), boundingVolumeVersion(0), spatialUpdatePending(false), spatialUpdatePendingBelow(false) {
     scale.Set(1, 1, 1);
     Vector axis(0, 0, -1);
     rotation.SetAngleAxis(0, axis);
@@ -20,7 +22,7 @@ namespace blunted {
     parent = 0;
   }
 
-  Spatial::Spatial(const Spatial &src) {
+  Spatial::Spatial(const Spatial &src) : boundingVolumeVersion(0), spatialUpdatePending(false), spatialUpdatePendingBelow(false) {
     name = src.GetName();
     position = src.position;
     rotation = src.rotation;
@@ -65,7 +67,7 @@ namespace blunted {
     spatialMutex.lock();
     position = newPosition;
     spatialMutex.unlock();
-    if (updateSpatialData) RecursiveUpdateSpatialData(e_SpatialDataType_Position);
+    if (updateSpatialData) RecursiveUpdateSpatialData(e_SpatialDataType_Position); else MarkSpatialUpdatePending();
   }
 
   Vector3 Spatial::GetPosition() const {
@@ -79,7 +81,7 @@ namespace blunted {
     spatialMutex.lock();
     rotation = newRotation;
     spatialMutex.unlock();
-    if (updateSpatialData) RecursiveUpdateSpatialData(e_SpatialDataType_Both);
+    if (updateSpatialData) RecursiveUpdateSpatialData(e_SpatialDataType_Both); else MarkSpatialUpdatePending();
   }
 
   Quaternion Spatial::GetRotation() const {
@@ -105,66 +107,65 @@ namespace blunted {
 
   Vector3 Spatial::GetDerivedPosition() const {
     boost::mutex::scoped_lock cachelock(cacheMutex);
-    if (_dirty_DerivedPosition) {
-      if (localMode == e_LocalMode_Relative) {
-        if (parent) {
-          const Quaternion parentDerivedRotation = parent->GetDerivedRotation();
-          const Vector3 parentDerivedScale = parent->GetDerivedScale();
-          const Vector3 parentDerivedPosition = parent->GetDerivedPosition();
-
-          _cache_DerivedPosition.Set(parentDerivedRotation * (parentDerivedScale * GetPosition()));
-          _cache_DerivedPosition += parentDerivedPosition;
-        } else {
-          _cache_DerivedPosition = GetPosition();
-        }
-      } else {
-        _cache_DerivedPosition = GetPosition();
-      }
-      _dirty_DerivedPosition = false;
-    }
+    if (_dirty_DerivedTransform) UpdateDerivedTransform();
     return _cache_DerivedPosition;
   }
 
   Quaternion Spatial::GetDerivedRotation() const {
     boost::mutex::scoped_lock cachelock(cacheMutex);
-    if (_dirty_DerivedRotation) {
-      if (localMode == e_LocalMode_Relative) {
-        if (parent) {
-          _cache_DerivedRotation = (parent->GetDerivedRotation() * GetRotation()).GetNormalized();
-        } else {
-          _cache_DerivedRotation = GetRotation();
-        }
-      } else {
-        _cache_DerivedRotation = GetRotation();
-      }
-      _dirty_DerivedRotation = false;
-    }
+    if (_dirty_DerivedTransform) UpdateDerivedTransform();
     return _cache_DerivedRotation;
   }
 
   Vector3 Spatial::GetDerivedScale() const {
     boost::mutex::scoped_lock cachelock(cacheMutex);
-    if (_dirty_DerivedScale) {
-      if (localMode == e_LocalMode_Relative) {
-        if (parent) {
-          _cache_DerivedScale = parent->GetDerivedScale() * GetScale();
-        } else {
-          _cache_DerivedScale = GetScale();
-        }
-      } else {
-        _cache_DerivedScale = GetScale();
-      }
-      _dirty_DerivedScale = false;
-    }
+    if (_dirty_DerivedTransform) UpdateDerivedTransform();
     return _cache_DerivedScale;
   }
 
+  void Spatial::GetDerivedTransform(Vector3 &derivedPosition, Quaternion &derivedRotation, Vector3 &derivedScale) const {
+    boost::mutex::scoped_lock cachelock(cacheMutex);
+    if (_dirty_DerivedTransform) UpdateDerivedTransform();
+    derivedPosition = _cache_DerivedPosition;
+    derivedRotation = _cache_DerivedRotation;
+    derivedScale = _cache_DerivedScale;
+  }
+
+  void Spatial::UpdateDerivedTransform() const {
+    // cacheMutex is locked. parents are only ever locked after their children, so this can't deadlock
+    spatialMutex.lock();
+    const Vector3 localPosition = position;
+    const Quaternion localRotation = rotation;
+    const Vector3 localScale = scale;
+    spatialMutex.unlock();
+
+    if (localMode == e_LocalMode_Relative && parent) {
+      Vector3 parentDerivedPosition;
+      Quaternion parentDerivedRotation;
+      Vector3 parentDerivedScale;
+      parent->GetDerivedTransform(parentDerivedPosition, parentDerivedRotation, parentDerivedScale);
+
+      _cache_DerivedPosition.Set(parentDerivedRotation * (parentDerivedScale * localPosition));
+      _cache_DerivedPosition += parentDerivedPosition;
+      _cache_DerivedRotation = (parentDerivedRotation * localRotation).GetNormalized();
+      _cache_DerivedScale = parentDerivedScale * localScale;
+    } else {
+      _cache_DerivedPosition = localPosition;
+      _cache_DerivedRotation = localRotation;
+      _cache_DerivedScale = localScale;
+    }
+    _dirty_DerivedTransform = false;
+
+    derivedTransformUpdateCount.fetch_add(1, std::memory_order_relaxed);
+  }
+
   void Spatial::InvalidateBoundingVolume() {
     bool changed = false;
     aabb.Lock();
     if (aabb.data.dirty == false) {
       aabb.data.dirty = true;
       aabb.data.aabb.Reset();
+      boundingVolumeVersion.fetch_add(1, std::memory_order_release);
       changed = true;
     }
     aabb.Unlock();
@@ -174,10 +175,20 @@ namespace blunted {
 
   void Spatial::InvalidateSpatialData() {
     cacheMutex.lock();
-    _dirty_DerivedPosition = true;
-    _dirty_DerivedRotation = true;
-    _dirty_DerivedScale = true;
+    _dirty_DerivedTransform = true;
     cacheMutex.unlock();
+
+    // being updated now, along with everything below (for spatials that have anything below them)
+    spatialUpdatePending.store(false, std::memory_order_release);
+    spatialUpdatePendingBelow.store(false, std::memory_order_release);
+  }
+
+  void Spatial::MarkSpatialUpdatePending() {
+    spatialUpdatePending.store(true, std::memory_order_release);
+    // up to the first parent that already knows
+    for (Spatial *ancestor = parent; ancestor; ancestor = ancestor->parent) {
+      if (ancestor->spatialUpdatePendingBelow.exchange(true, std::memory_order_acq_rel)) break;
+    }
   }
 
 
@@ -73,15 +73,31 @@ namespace blunted {
       virtual Vector3 GetDerivedPosition() const;
       virtual Quaternion GetDerivedRotation() const;
       virtual Vector3 GetDerivedScale() const;
+      /// all three at once, for one lock instead of three
+      void GetDerivedTransform(Vector3 &derivedPosition, Quaternion &derivedRotation, Vector3 &derivedScale) const;
+
+      /// derived transforms computed so far (all spatials, all threads)
+      static unsigned long GetDerivedTransformUpdateCount() { return derivedTransformUpdateCount.load(std::memory_order_relaxed); }
+
+      /// set when position or rotation were set without updating the spatial data, until RecursiveUpdateSpatialData has been
+      /// called on this or one of its parents. see Node::RecursiveUpdatePendingSpatialData
+      bool IsSpatialUpdatePending() const { return spatialUpdatePending.load(std::memory_order_acquire); }
 
       virtual void RecursiveUpdateSpatialData(e_SpatialDataType spatialDataType, e_SystemType excludeSystem = e_SystemType_None) = 0;
 
       virtual void InvalidateBoundingVolume();
+      /// RecursiveUpdateSpatialData implementations start with this, so it also clears the pending update flags
       virtual void InvalidateSpatialData();
 
       virtual AABB GetAABB() const;
 
+      /// goes up whenever a clean bounding volume gets invalidated, so whoever keeps copies of it knows when to ask again
+      unsigned int GetBoundingVolumeVersion() const { return boundingVolumeVersion.load(std::memory_order_acquire); }
+
     protected:
+      void MarkSpatialUpdatePending();
+      void UpdateDerivedTransform() const;
+
       std::string name;
 
       Spatial *parent;
@@ -92,11 +108,9 @@ namespace blunted {
       Quaternion rotation;
       Vector3 scale;
 
-      // cache
+      // cache. position, rotation and scale are derived together, from one look at the parent's
       mutable boost::mutex cacheMutex;
-      mutable bool _dirty_DerivedPosition;
-      mutable bool _dirty_DerivedRotation;
-      mutable bool _dirty_DerivedScale;
+      mutable bool _dirty_DerivedTransform;
       mutable Vector3 _cache_DerivedPosition;
       mutable Quaternion _cache_DerivedRotation;
       mutable Vector3 _cache_DerivedScale;
@@ -104,6 +118,12 @@ namespace blunted {
       e_LocalMode localMode;
 
       mutable Lockable < AABBCache > aabb;
+      std::atomic<unsigned int> boundingVolumeVersion;
+
+      std::atomic<bool> spatialUpdatePending;
+      std::atomic<bool> spatialUpdatePendingBelow; // on one of the children, or further down
+
+      static std::atomic<unsigned long> derivedTransformUpdateCount;
 
   };
 
@@ -0,0 +1,117 @@
+// written by bastiaan konings schuiling 2008 - 2014
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_WORKSTEALINGDEQUE
+#define _HPP_WORKSTEALINGDEQUE
+
+#include "defines.hpp"
+
+#include <atomic>
+
+#include "types/command.hpp"
+
+namespace blunted {
+
+  // chase-lev deque (with the memory orderings from le, pop, cohen & zappa nardelli, 'correct and efficient work-stealing for weak memory models', 2013).
+  // one owner thread pushes and pops at the bottom (lifo, so it keeps working on what it just split off, while that's still in cache),
+  // any thread may steal from the top (fifo, so thieves take the oldest, usually biggest, jobs). no locks, no allocations, except when growing.
+  // holds one reference per command: Push adds one, whoever gets a command out owns that reference.
+  class WorkStealingDeque {
+
+    public:
+      WorkStealingDeque(int initialSize = 64) : top(0), bottom(0) {
+        array.store(new Array(initialSize), std::memory_order_relaxed);
+      }
+
+      virtual ~WorkStealingDeque() {
+        boost::intrusive_ptr<Command> command;
+        while ((command = Pop())) {}
+        delete array.load(std::memory_order_relaxed);
+        for (unsigned int i = 0; i < retiredArrays.size(); i++) delete retiredArrays.at(i);
+      }
+
+      // owner only
+      inline void Push(boost::intrusive_ptr<Command> command) {
+        long b = bottom.load(std::memory_order_relaxed);
+        long t = top.load(std::memory_order_acquire);
+        Array *a = array.load(std::memory_order_relaxed);
+        if (b - t > a->size - 1) a = Grow(a, t, b);
+        intrusive_ptr_add_ref(command.get());
+        a->Put(b, command.get());
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+      }
+
+      // owner only
+      inline boost::intrusive_ptr<Command> Pop() {
+        long b = bottom.load(std::memory_order_relaxed) - 1;
+        Array *a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long t = top.load(std::memory_order_relaxed);
+
+        Command *command = 0;
+        if (t <= b) {
+          command = a->Get(b);
+          if (t == b) {
+            // last one: race the thieves for it
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) command = 0;
+            bottom.store(b + 1, std::memory_order_relaxed);
+          }
+        } else {
+          bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return boost::intrusive_ptr<Command>(command, false);
+      }
+
+      // any thread. also returns 0 when it lost a race, so 0 does not necessarily mean empty
+      inline boost::intrusive_ptr<Command> Steal() {
+        long t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long b = bottom.load(std::memory_order_acquire);
+
+        Command *command = 0;
+        if (t < b) {
+          Array *a = array.load(std::memory_order_acquire);
+          command = a->Get(t);
+          if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) command = 0;
+        }
+        return boost::intrusive_ptr<Command>(command, false);
+      }
+
+      // approximation, when called from other threads than the owner
+      inline int GetPending() const {
+        long pending = bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed);
+        return pending > 0 ? pending : 0;
+      }
+
+    protected:
+      struct Array {
+        Array(long size) : size(size) { slots = new std::atomic<Command*>[size]; }
+        ~Array() { delete [] slots; }
+        inline Command *Get(long index) const { return slots[index & (size - 1)].load(std::memory_order_relaxed); }
+        inline void Put(long index, Command *command) { slots[index & (size - 1)].store(command, std::memory_order_relaxed); }
+        long size; // power of two
+        std::atomic<Command*> *slots;
+      };
+
+      Array *Grow(Array *a, long t, long b) {
+        Array *grown = new Array(a->size * 2);
+        for (long i = t; i < b; i++) grown->Put(i, a->Get(i));
+        // thieves may still be reading the old one, so it stays around until we're destroyed
+        retiredArrays.push_back(a);
+        array.store(grown, std::memory_order_release);
+        return grown;
+      }
+
+      std::atomic<long> top;
+      std::atomic<long> bottom;
+      std::atomic<Array*> array;
+      std::vector<Array*> retiredArrays; // owner only
+
+  };
+
+}
+
+#endif
@@ -9,6 +9,7 @@
 #include <stdio.h>
 
 #include "animationextensions/footballanimationextension.hpp"
+#include "animationcache.hpp"
 
 std::string emptyString = "";
 
@@ -23,6 +24,39 @@ namespace blunted {
     return newAngle;
   }
 
+  const char *jointNames[e_Joint_Size] = {
+    "player", "body", "middle", "neck",
+    "left_shoulder", "left_elbow", "right_shoulder", "right_elbow",
+    "left_thigh", "left_knee", "left_ankle", "right_thigh", "right_knee", "right_ankle"
+  };
+
+  const char *GetJointName(int jointID) {
+    assert(jointID >= 0 && jointID < e_Joint_Size);
+    return jointNames[jointID];
+  }
+
+  int GetJointID(const std::string &nodeName) {
+    for (int i = 0; i < e_Joint_Size; i++) {
+      if (nodeName.compare(jointNames[i]) == 0) return i;
+    }
+    return -1;
+  }
+
+  float GetMaxAngleFactor(int jointID) {
+    switch (jointID) {
+      case e_Joint_LeftElbow:
+      case e_Joint_RightElbow:
+      case e_Joint_LeftKnee:
+      case e_Joint_RightKnee:
+        return 1.2f;
+      case e_Joint_LeftAnkle:
+      case e_Joint_RightAnkle:
+        return 1.6f;
+      default:
+        return 1.0f;
+    }
+  }
+
   Animation::Animation() {
     frameCount = 0;
     // all humanoid movies are supposed to have a moving right foot at first (unless mirrored)
@@ -37,6 +71,7 @@ namespace blunted {
       nodeAnimations.push_back(new NodeAnimation(*src.nodeAnimations.at(i)));
     }
 
+    bakedNodeAnimations = src.bakedNodeAnimations;
     frameCount = src.frameCount;
     name = src.name;
 
@@ -102,6 +137,9 @@ namespace blunted {
     cache_outgoingBodyAngle_dirty = true;
     cache_incomingBodyDirection_dirty = true;
     cache_outgoingBodyDirection_dirty = true;
+
+    // keyframes may have changed
+    bakedNodeAnimations.clear();
   }
 
   int Animation::GetFrameCount() const {
@@ -112,7 +150,15 @@ namespace blunted {
     int animSize = nodeAnimations.size();
     for (int i = 0; i < animSize; i++) {
       if (nodeAnimations.at(i)->nodeName == nodeName) {
-        GetInterpolatedValues(nodeAnimations.at(i)->animation, frame, orientation, position, getOrientation, getPosition);
+        if (IsBaked()) {
+          Quaternion bakedOrientation;
+          Vector3 bakedPosition;
+          GetBakedValues(i, frame, bakedOrientation, bakedPosition);
+          orientation = getOrientation ? bakedOrientation : QUATERNION_IDENTITY;
+          position = getPosition ? bakedPosition : Vector3(0);
+        } else {
+          GetInterpolatedValues(nodeAnimations.at(i)->animation, frame, orientation, position, getOrientation, getPosition);
+        }
         return nodeAnimations.at(i)->animation.find(frame) != nodeAnimations.at(i)->animation.end();
       }
     }
@@ -367,11 +413,36 @@ namespace blunted {
     }
   }
 
-  void Animation::Apply(const std::map < const std::string, boost::intrusive_ptr<Node> > nodeMap, int frame, int timeOffset_ms, bool smooth, float smoothFactor, /*const boost::shared_ptr<Animation> previousAnimation, int smoothFrames, */const Vector3 &basePos, radian baseRot, std::map < std::string, BiasedOffset > &offsets, MovementHistory *movementHistory, int timeDiff_ms, bool noPos, bool updateSpatial) {
+  void Animation::Bake() {
+    bakedNodeAnimations.clear();
+    if (frameCount == 0) return;
+
+    bakedNodeAnimations.resize(nodeAnimations.size());
+    for (unsigned int i = 0; i < nodeAnimations.size(); i++) {
+      BakedNodeAnimation &baked = bakedNodeAnimations.at(i);
+      baked.jointID = GetJointID(nodeAnimations.at(i)->nodeName);
+      baked.maxAngleFactor = GetMaxAngleFactor(baked.jointID);
+      baked.keys.resize(frameCount + 1);
+      for (int frame = 0; frame <= frameCount; frame++) {
+        GetInterpolatedValues(nodeAnimations.at(i)->animation, frame, baked.keys.at(frame).orientation, baked.keys.at(frame).position);
+      }
+    }
+  }
+
+  void Animation::Apply(const std::map < const std::string, boost::intrusive_ptr<Node> > &nodeMap, int frame, int timeOffset_ms, bool smooth, float smoothFactor, /*const boost::shared_ptr<Animation> previousAnimation, int smoothFrames, */const Vector3 &basePos, radian baseRot, std::map < std::string, BiasedOffset > &offsets, MovementHistory *movementHistory, int timeDiff_ms, bool noPos, bool updateSpatial) {
+    _Apply(&nodeMap, 0, frame, timeOffset_ms, smooth, smoothFactor, basePos, baseRot, offsets, movementHistory, timeDiff_ms, noPos, updateSpatial);
+  }
+
+  void Animation::Apply(Node * const *joints, int frame, int timeOffset_ms, bool smooth, float smoothFactor, const Vector3 &basePos, radian baseRot, std::map < std::string, BiasedOffset > &offsets, MovementHistory *movementHistory, int timeDiff_ms, bool noPos, bool updateSpatial) {
+    _Apply(0, joints, frame, timeOffset_ms, smooth, smoothFactor, basePos, baseRot, offsets, movementHistory, timeDiff_ms, noPos, updateSpatial);
+  }
+
+  void Animation::_Apply(const std::map < const std::string, boost::intrusive_ptr<Node> > *nodeMap, Node * const *joints, int frame, int timeOffset_ms, bool smooth, float smoothFactor, const Vector3 &basePos, radian baseRot, std::map < std::string, BiasedOffset > &offsets, MovementHistory *movementHistory, int timeDiff_ms, bool noPos, bool updateSpatial) {
 
     // simple keyframe-to-keyframe version
 
     NodeAnimation *nodeAnimation = 0;
+    Node *rootNode = 0;
 
     //int futureFrameOffset = 1;
 
@@ -380,6 +451,27 @@ namespace blunted {
 
       nodeAnimation = nodeAnimations.at(i);
 
+      int jointID = -1;
+      float maxAngleFactor = 1.0f;
+      if (IsBaked()) {
+        jointID = bakedNodeAnimations[i].jointID;
+        maxAngleFactor = bakedNodeAnimations[i].maxAngleFactor;
+      } else {
+        jointID = GetJointID(nodeAnimation->nodeName);
+        maxAngleFactor = GetMaxAngleFactor(jointID);
+      }
+      bool isPlayer = (jointID == e_Joint_Player);
+
+      Node *node = 0;
+      if (joints) {
+        assert(jointID != -1);
+        node = joints[jointID];
+      } else {
+        assert(nodeMap->find(nodeAnimation->nodeName) != nodeMap->end());
+        node = nodeMap->find(nodeAnimation->nodeName)->second.get();
+      }
+      if (i == 0) rootNode = node;
+
       Quaternion orientation;
       Vector3 position;
 
@@ -398,15 +490,13 @@ namespace blunted {
         bias /= factor;
         bias += 0.5f - ((1.0f / factor) * 0.5f); // center, then subtract half of new size
       }
-      GetInterpolatedValues(nodeAnimation->animation, frame     - smoothFrames, orientation_pre , position_pre);
-      GetInterpolatedValues(nodeAnimation->animation, frame + 1 + smoothFrames, orientation_post, position_post);
+      GetBakedValues(i, frame     - smoothFrames, orientation_pre , position_pre);
+      GetBakedValues(i, frame + 1 + smoothFrames, orientation_post, position_post);
       orientation_pre.MakeSameNeighborhood(orientation_post);
       orientation = orientation_pre.GetLerped(bias, orientation_post).GetNormalized();
       position = position_pre * (1.0f - bias) + position_post * bias;
 
-      assert(nodeMap.find(nodeAnimation->nodeName) != nodeMap.end());
-
-      if (nodeAnimation->nodeName.compare("player") == 0) {
+      if (isPlayer) {
         if (noPos) {
           position.coords[0] = 0;
           position.coords[1] = 0;
@@ -414,7 +504,7 @@ namespace blunted {
           position.Rotate2D(baseRot);
         }
       }
-      if (nodeAnimation->nodeName.compare("body") == 0) {
+      if (jointID == e_Joint_Body) {
         Quaternion rotZ;
         rotZ.SetAngleAxis(baseRot, Vector3(0, 0, 1));
         orientation = rotZ * orientation;
@@ -442,9 +532,17 @@ namespace blunted {
         assert(movementHistory);
         MovementHistoryEntry *movementHistoryEntry = 0;
 
-        for (unsigned int node = 0; node < movementHistory->size(); node++) {
-          if (movementHistory->at(node).nodeName.compare(nodeAnimation->nodeName) == 0) {
-            movementHistoryEntry = &movementHistory->at(node);
+        // skeleton joints have a fixed slot (by joint id), anything else is looked up by name after those
+        if (movementHistory->size() < e_Joint_Size) movementHistory->resize(e_Joint_Size);
+        if (jointID != -1) {
+          if (movementHistory->at(jointID).nodeName.compare(nodeAnimation->nodeName) == 0) {
+            movementHistoryEntry = &movementHistory->at(jointID);
+          }
+        } else {
+          for (unsigned int entry = e_Joint_Size; entry < movementHistory->size(); entry++) {
+            if (movementHistory->at(entry).nodeName.compare(nodeAnimation->nodeName) == 0) {
+              movementHistoryEntry = &movementHistory->at(entry);
+            }
           }
         }
         if (movementHistoryEntry == 0) { // not in movementhistory yet; add
@@ -453,17 +551,22 @@ namespace blunted {
           newEntry.position = position;
           newEntry.orientation = orientation;
           newEntry.timeDiff_ms = 10;
-          movementHistory->push_back(newEntry);
-          movementHistoryEntry = &movementHistory->back();
+          if (jointID != -1) {
+            movementHistory->at(jointID) = newEntry;
+            movementHistoryEntry = &movementHistory->at(jointID);
+          } else {
+            movementHistory->push_back(newEntry);
+            movementHistoryEntry = &movementHistory->back();
+          }
         }
 
         float beginBias = pow(curve(1.0f - NormalizedClamp(frame, 0, 8), 1.0f), 0.5f);
         float currentBias = 0.0f + beginBias * smoothFactor * 0.5f;
 
-        if (nodeAnimation->nodeName.compare("player") != 0) {
+        if (!isPlayer) {
 
           const Quaternion &previousOrientation = movementHistoryEntry->orientation;
-          Quaternion currentOrientation = nodeMap.find(nodeAnimation->nodeName)->second->GetRotation();
+          Quaternion currentOrientation = node->GetRotation();
           currentOrientation.MakeSameNeighborhood(previousOrientation);
 
           if (timeDiff_ms > 0) {
@@ -584,12 +687,7 @@ namespace blunted {
               radian angle_per_second = 2.0f * acos(clamp(dot, -1.0f, 1.0f)) / ((float)timeDiff_ms * 0.001f);
               radian maxAngle_per_second = 7.5f * pi;//5.5f * pi;
               //if (nodeAnimation->nodeName.compare("body") == 0) maxAngle_per_second *= 0.8f;
-              if (nodeAnimation->nodeName.compare("left_elbow") == 0) maxAngle_per_second *= 1.2f;
-              else if (nodeAnimation->nodeName.compare("right_elbow") == 0) maxAngle_per_second *= 1.2f;
-              else if (nodeAnimation->nodeName.compare("left_knee") == 0) maxAngle_per_second *= 1.2f;
-              else if (nodeAnimation->nodeName.compare("right_knee") == 0) maxAngle_per_second *= 1.2f;
-              else if (nodeAnimation->nodeName.compare("left_ankle") == 0) maxAngle_per_second *= 1.6f;
-              else if (nodeAnimation->nodeName.compare("right_ankle") == 0) maxAngle_per_second *= 1.6f;
+              maxAngle_per_second *= maxAngleFactor; // elbows, knees and ankles are a bit faster
               maxAngle_per_second = (0.3f + 0.7f * (1.0f - beginBias)) * maxAngle_per_second;
               //if (nodeAnimation->nodeName.compare("body") == 0) maxAngle_per_second = 3.0f * pi;
               if (angle_per_second > maxAngle_per_second) {
@@ -638,15 +736,16 @@ namespace blunted {
 
         }
 
-        else if (nodeAnimation->nodeName.compare("player") == 0) {
+        else if (isPlayer) {
 
-          const Vector3 &previousPosition = movementHistoryEntry->position;
-          Vector3 currentPosition = nodeMap.find(nodeAnimation->nodeName)->second->GetPosition();
+          Vector3 currentPosition = node->GetPosition();
 
           if (timeDiff_ms > 0 && beginBias > 0.01f) {
 
-            Vector3 currentMovement = (currentPosition - previousPosition) / (movementHistoryEntry->timeDiff_ms * 0.001f);
   /*
+            const Vector3 &previousPosition = movementHistoryEntry->position;
+            Vector3 currentMovement = (currentPosition - previousPosition) / (movementHistoryEntry->timeDiff_ms * 0.001f);
+
             // damping (maybe useful: http://www.freebasic.net/forum/viewtopic.php?t=9769 )
             Vector3 desiredMovement = ((basePos + position) - currentPosition) / (timeDiff_ms * 0.001f);
             Vector3 dampingMovement = (desiredMovement - currentMovement);
@@ -707,17 +806,17 @@ namespace blunted {
       } // smoothing
 
 
-      if (nodeAnimation->nodeName.compare("player") != 0) {
-        Quaternion currentOrientation = nodeMap.find(nodeAnimation->nodeName)->second->GetRotation();
+      if (!isPlayer) {
+        Quaternion currentOrientation = node->GetRotation();
         orientation.MakeSameNeighborhood(currentOrientation);
-        nodeMap.find(nodeAnimation->nodeName)->second->SetRotation(orientation, false);
-      } else if (nodeAnimation->nodeName.compare("player") == 0) {
-        nodeMap.find(nodeAnimation->nodeName)->second->SetPosition(position + basePos, false);
+        node->SetRotation(orientation, false);
+      } else {
+        node->SetPosition(position + basePos, false);
       }
 
     }
 
-    if (updateSpatial) (*nodeMap.find(nodeAnimations.at(0)->nodeName)).second->RecursiveUpdateSpatialData(e_SpatialDataType_Both);
+    if (updateSpatial && rootNode) rootNode->RecursiveUpdateSpatialData(e_SpatialDataType_Both);
   }
 
   void Animation::Shift(int fromFrame, int offset) { // todo: offset does not yet work
@@ -1243,6 +1342,126 @@ namespace blunted {
     fclose(file);
   }
 
+  namespace {
+
+    void SaveCacheTree(AnimationCacheWriter &writer, const XMLTree &tree) {
+      writer.WriteString(tree.value);
+      writer.Write((unsigned int)tree.children.size());
+      map_XMLTree::const_iterator iter = tree.children.begin();
+      while (iter != tree.children.end()) {
+        writer.WriteString(iter->first);
+        SaveCacheTree(writer, iter->second);
+        iter++;
+      }
+    }
+
+    void LoadCacheTree(AnimationCacheReader &reader, XMLTree &tree) {
+      reader.ReadString(tree.value);
+      unsigned int count = 0;
+      reader.ReadCount(count, 3 * sizeof(unsigned int)); // name, value, child count
+      for (unsigned int i = 0; i < count && !reader.Failed(); i++) {
+        std::string name;
+        reader.ReadString(name);
+        map_XMLTree::iterator iter = tree.children.insert(tree.children.end(), std::pair<std::string, XMLTree>(name, XMLTree()));
+        LoadCacheTree(reader, iter->second);
+      }
+    }
+
+  }
+
+  void Animation::SaveCache(AnimationCacheWriter &writer) const {
+    writer.WriteString(name);
+    writer.Write(frameCount);
+    writer.Write((int)currentFoot);
+
+    writer.Write((unsigned int)nodeAnimations.size());
+    for (unsigned int i = 0; i < nodeAnimations.size(); i++) {
+      writer.WriteString(nodeAnimations.at(i)->nodeName);
+      writer.Write((unsigned int)nodeAnimations.at(i)->animation.size());
+      std::map<int, KeyFrame>::const_iterator keyIter = nodeAnimations.at(i)->animation.begin();
+      while (keyIter != nodeAnimations.at(i)->animation.end()) {
+        writer.Write(keyIter->first);
+        writer.Write(keyIter->second);
+        keyIter++;
+      }
+    }
+
+    SaveCacheTree(writer, *customData);
+
+    // not the same as the custom data: mirroring and SetVariable only change (or add) these
+    writer.Write((unsigned int)variableCache.size());
+    std::map<const char*, std::string>::const_iterator varIter = variableCache.begin();
+    while (varIter != variableCache.end()) {
+      writer.WriteString(varIter->first);
+      writer.WriteString(varIter->second);
+      varIter++;
+    }
+
+    writer.Write((unsigned int)extensions.size());
+    std::map < std::string, boost::shared_ptr<AnimationExtension> >::const_iterator extensionIter = extensions.begin();
+    while (extensionIter != extensions.end()) {
+      writer.WriteString(extensionIter->first);
+      extensionIter->second->SaveCache(writer);
+      extensionIter++;
+    }
+  }
+
+  bool Animation::LoadCache(AnimationCacheReader &reader) {
+    assert(nodeAnimations.empty());
+
+    int foot = 0;
+    reader.ReadString(name);
+    reader.Read(frameCount);
+    reader.Read(foot);
+    currentFoot = (foot == e_Foot_Left) ? e_Foot_Left : e_Foot_Right;
+
+    unsigned int count = 0;
+    reader.ReadCount(count, 2 * sizeof(unsigned int));
+    for (unsigned int i = 0; i < count && !reader.Failed(); i++) {
+      NodeAnimation *nodeAnimation = new NodeAnimation();
+      nodeAnimations.push_back(nodeAnimation);
+      reader.ReadString(nodeAnimation->nodeName);
+      unsigned int keyCount = 0;
+      reader.ReadCount(keyCount, sizeof(int) + sizeof(KeyFrame));
+      for (unsigned int k = 0; k < keyCount && !reader.Failed(); k++) {
+        int frame = 0;
+        KeyFrame keyFrame;
+        reader.Read(frame);
+        reader.Read(keyFrame);
+        nodeAnimation->animation.insert(nodeAnimation->animation.end(), std::pair<int, KeyFrame>(frame, keyFrame));
+      }
+    }
+
+    customData = boost::shared_ptr<XMLTree>(new XMLTree());
+    LoadCacheTree(reader, *customData);
+
+    reader.ReadCount(count, 2 * sizeof(unsigned int));
+    for (unsigned int i = 0; i < count && !reader.Failed(); i++) {
+      std::string varName, varData;
+      reader.ReadString(varName);
+      reader.ReadString(varData);
+      if (varName.size() >= 256) reader.Fail();
+      if (reader.Failed()) break;
+      char *varNameCopy = new char[256];
+      strcpy(varNameCopy, varName.c_str());
+      variableCache.insert(std::pair<const char*, std::string>(varNameCopy, varData));
+    }
+
+    reader.ReadCount(count, sizeof(unsigned int));
+    for (unsigned int i = 0; i < count && !reader.Failed(); i++) {
+      std::string extensionName;
+      reader.ReadString(extensionName);
+      std::map < std::string, boost::shared_ptr<AnimationExtension> >::iterator extensionIter = extensions.find(extensionName);
+      if (extensionIter == extensions.end()) { reader.Fail(); break; } // don't know how big its data is
+      extensionIter->second->LoadCache(reader);
+    }
+
+    cache_AnimType = GetVariable("type");
+    DirtyCache();
+
+    return !reader.Failed();
+  }
+
   void Animation::Mirror() {
     name.append("_mirror");
     (currentFoot == e_Foot_Right) ? currentFoot = e_Foot_Left : currentFoot = e_Foot_Right;
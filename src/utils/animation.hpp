@@ -15,6 +15,9 @@
 
 namespace blunted {
 
+  class AnimationCacheWriter;
+  class AnimationCacheReader;
+
   struct CompareCharacterStrings
   {
     bool operator()(const char *a, const char *b) const {
@@ -38,6 +41,35 @@ namespace blunted {
     std::map<int, KeyFrame> animation; // frame, angles
   };
 
+  // the humanoid skeleton, as animated by the .anim files. baked animations refer to nodes by these ids
+  enum e_Joint {
+    e_Joint_Player, // root; position only
+    e_Joint_Body,
+    e_Joint_Middle,
+    e_Joint_Neck,
+    e_Joint_LeftShoulder,
+    e_Joint_LeftElbow,
+    e_Joint_RightShoulder,
+    e_Joint_RightElbow,
+    e_Joint_LeftThigh,
+    e_Joint_LeftKnee,
+    e_Joint_LeftAnkle,
+    e_Joint_RightThigh,
+    e_Joint_RightKnee,
+    e_Joint_RightAnkle,
+    e_Joint_Size
+  };
+
+  const char *GetJointName(int jointID);
+  int GetJointID(const std::string &nodeName); // -1 if not part of the skeleton
+
+  // a NodeAnimation, resampled to one key per frame so Apply can just index into it
+  struct BakedNodeAnimation {
+    int jointID; // -1 if the node is not part of the skeleton
+    float maxAngleFactor; // smoothing: some joints are allowed to rotate faster than others
+    std::vector<KeyFrame> keys; // frame 0 .. frameCount, inclusive (last one is extrapolated)
+  };
+
   enum e_Foot {
     e_Foot_Left,
     e_Foot_Right
@@ -86,9 +118,25 @@ namespace blunted {
       void SetKeyFrame(std::string nodeName, int frame, const Quaternion &orientation, const Vector3 &position = Vector3(0, 0, 0));
       void DeleteKeyFrame(std::string nodeName, int frame);
       void GetInterpolatedValues(const std::map<int, KeyFrame> &animation, int frame, Quaternion &orientation, Vector3 &position, bool getOrientation = true, bool getPosition = true) const;
+
+      // resample all keyframes into per-frame arrays and resolve node names to joint ids. any later edit (which dirties the cache) unbakes
+      void Bake();
+      bool IsBaked() const { return !bakedNodeAnimations.empty(); }
+      inline void GetBakedValues(int nodeAnimationIndex, int frame, Quaternion &orientation, Vector3 &position) const {
+        if (frame < 0) frame = 0;
+        if (frame <= frameCount && !bakedNodeAnimations.empty()) {
+          const KeyFrame &key = bakedNodeAnimations[nodeAnimationIndex].keys[frame];
+          orientation = key.orientation;
+          position = key.position;
+        } else {
+          GetInterpolatedValues(nodeAnimations[nodeAnimationIndex]->animation, frame, orientation, position);
+        }
+      }
       void ConvertToStartFacingForwardIfIdle();
       void Invert();
-      void Apply(const std::map < const std::string, boost::intrusive_ptr<Node> > nodeMap, int frame, int timeOffset_ms = 0, bool smooth = true, float smoothFactor = 1.0f, /*const boost::shared_ptr<Animation> previousAnimation, int smoothFrames, */const Vector3 &basePos = Vector3(0), radian baseRot = 0, std::map < std::string, BiasedOffset > &offsets = emptyOffsets, MovementHistory *movementHistory = 0, int timeDiff_ms = 10, bool noPos = false, bool updateSpatial = true);
+      void Apply(const std::map < const std::string, boost::intrusive_ptr<Node> > &nodeMap, int frame, int timeOffset_ms = 0, bool smooth = true, float smoothFactor = 1.0f, /*const boost::shared_ptr<Animation> previousAnimation, int smoothFrames, */const Vector3 &basePos = Vector3(0), radian baseRot = 0, std::map < std::string, BiasedOffset > &offsets = emptyOffsets, MovementHistory *movementHistory = 0, int timeDiff_ms = 10, bool noPos = false, bool updateSpatial = true);
+      // same, with the skeleton's nodes resolved beforehand: joints[e_Joint_Size], indexed by e_Joint. all animated nodes need to be skeleton joints
+      void Apply(Node * const *joints, int frame, int timeOffset_ms = 0, bool smooth = true, float smoothFactor = 1.0f, const Vector3 &basePos = Vector3(0), radian baseRot = 0, std::map < std::string, BiasedOffset > &offsets = emptyOffsets, MovementHistory *movementHistory = 0, int timeDiff_ms = 10, bool noPos = false, bool updateSpatial = true);
       void Shift(int fromFrame, int offset);
 
       // returns end position - start position
@@ -111,6 +159,10 @@ namespace blunted {
       void LoadData(std::vector < std::vector<std::string> > &file);
       void Load(const std::string &filename);
       void Save(const std::string &filename);
+      // everything (keyframes, custom data, variables, extension data) but the bake. LoadCache is for new animations that
+      // already have the same extensions added as the saved one had; false if the data doesn't fit that
+      void SaveCache(AnimationCacheWriter &writer) const;
+      bool LoadCache(AnimationCacheReader &reader);
       void Mirror();
       std::string GetName() const;
       void SetName(const std::string &name) { this->name = name; }
@@ -130,7 +182,10 @@ namespace blunted {
       std::map < std::string, boost::shared_ptr<AnimationExtension> > &GetExtensions() { return extensions; }
 
     protected:
+      void _Apply(const std::map < const std::string, boost::intrusive_ptr<Node> > *nodeMap, Node * const *joints, int frame, int timeOffset_ms, bool smooth, float smoothFactor, const Vector3 &basePos, radian baseRot, std::map < std::string, BiasedOffset > &offsets, MovementHistory *movementHistory, int timeDiff_ms, bool noPos, bool updateSpatial);
+
       std::vector<NodeAnimation*> nodeAnimations;
+      std::vector<BakedNodeAnimation> bakedNodeAnimations; // same order as nodeAnimations; empty if not baked
       int frameCount;
       std::string name;
 
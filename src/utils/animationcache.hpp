@@ -0,0 +1,85 @@
+// written by bastiaan konings schuiling 2008 - 2015
+// this work is public domain. the code is undocumented, scruffy, untested, and should generally not be used for anything important.
+// i do not offer support, so don't ask. to be used for inspiration :)
+
+#ifndef _HPP_ANIMATIONCACHE
+#define _HPP_ANIMATIONCACHE
+
+#include "defines.hpp"
+
+#include <cstring>
+
+namespace blunted {
+
+  // flat, native endian bytes for Animation::SaveCache and AnimationExtension::SaveCache. a cache is only valid on the
+  // (kind of) machine that wrote it, so there's no need for anything portable
+
+  class AnimationCacheWriter {
+
+    public:
+      template <typename T> void Write(const T &value) {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+      }
+      void WriteString(const std::string &value) {
+        Write((unsigned int)value.size());
+        data.insert(data.end(), value.begin(), value.end());
+      }
+
+      const std::vector<unsigned char> &GetData() const { return data; }
+
+    protected:
+      std::vector<unsigned char> data;
+
+  };
+
+  // reads from a buffer it does not own. once a read runs past the end, every read fails, so callers only need to check at the end
+  class AnimationCacheReader {
+
+    public:
+      AnimationCacheReader(const unsigned char *data, size_t size) : current(data), end(data + size), failed(false) {}
+
+      template <typename T> bool Read(T &value) {
+        if (failed || (size_t)(end - current) < sizeof(T)) return Fail();
+        memcpy(&value, current, sizeof(T));
+        current += sizeof(T);
+        return true;
+      }
+      bool ReadString(std::string &value) {
+        unsigned int size = 0;
+        if (!Read(size) || (size_t)(end - current) < size) return Fail();
+        value.assign(reinterpret_cast<const char*>(current), size);
+        current += size;
+        return true;
+      }
+      /// a count of things that take at least minimumSize bytes each; fails on counts the rest of the buffer can't hold
+      bool ReadCount(unsigned int &count, size_t minimumSize = 1) {
+        if (!Read(count) || count > (size_t)(end - current) / minimumSize) return Fail();
+        return true;
+      }
+
+      bool Fail() { failed = true; return false; }
+      bool Failed() const { return failed; }
+      bool AtEnd() const { return current == end; }
+
+    protected:
+      const unsigned char *current;
+      const unsigned char *end;
+      bool failed;
+
+  };
+
+  // fnv-1a, to tell if the sources of a cache have changed
+  inline void HashAnimationCacheSource(unsigned int &hash, const void *data, size_t size) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+      hash ^= bytes[i];
+      hash *= 16777619u;
+    }
+  }
+
+  const unsigned int animationCacheHashBasis = 2166136261u;
+
+}
+
+#endif
@@ -10,6 +10,8 @@
 namespace blunted {
 
   class Animation;
+  class AnimationCacheWriter;
+  class AnimationCacheReader;
 
   class AnimationExtension {
 
@@ -28,6 +30,9 @@ namespace blunted {
       virtual void Load(std::vector<std::string> &tokenizedLine) = 0;
       virtual void Save(FILE *file) = 0;
 
+      virtual void SaveCache(AnimationCacheWriter &writer) const = 0;
+      virtual void LoadCache(AnimationCacheReader &reader) = 0;
+
     protected:
       Animation *parent;
 
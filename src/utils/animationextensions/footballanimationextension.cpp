@@ -4,6 +4,7 @@
 
 #include "footballanimationextension.hpp"
 #include "../animation.hpp"
+#include "../animationcache.hpp"
 
 #include "base/utils.hpp"
 
@@ -144,6 +145,29 @@ namespace blunted {
     fprintf(file, "%s\n", line.c_str());
   }
 
+  void FootballAnimationExtension::SaveCache(AnimationCacheWriter &writer) const {
+    writer.Write((unsigned int)animation.size());
+    std::map<int, FootballKeyFrame>::const_iterator animIter = animation.begin();
+    while (animIter != animation.end()) {
+      writer.Write(animIter->first);
+      writer.Write(animIter->second);
+      animIter++;
+    }
+  }
+
+  void FootballAnimationExtension::LoadCache(AnimationCacheReader &reader) {
+    animation.clear();
+    unsigned int count = 0;
+    reader.ReadCount(count, sizeof(int) + sizeof(FootballKeyFrame));
+    for (unsigned int i = 0; i < count && !reader.Failed(); i++) {
+      int frame = 0;
+      FootballKeyFrame keyFrame;
+      reader.Read(frame);
+      reader.Read(keyFrame);
+      animation.insert(animation.end(), std::pair<int, FootballKeyFrame>(frame, keyFrame));
+    }
+  }
+
   bool FootballAnimationExtension::GetFirstTouch(Vector3 &position, int &frame) {
     if (!animation.empty()) {
       position = animation.begin()->second.position;
@@ -32,6 +32,9 @@ namespace blunted {
       virtual void Load(std::vector<std::string> &tokenizedLine);
       virtual void Save(FILE *file);
 
+      virtual void SaveCache(AnimationCacheWriter &writer) const;
+      virtual void LoadCache(AnimationCacheReader &reader);
+
       virtual bool GetFirstTouch(Vector3 &position, int &frame);
       int GetTouchCount() const;
       virtual bool GetTouch(unsigned int num, Vector3 &position, int &frame);